@@ -34,6 +34,14 @@
 #include "conncpp/Warning.hpp"
 #include "conncpp/Savepoint.hpp"
 #include "conncpp/Types.hpp"
+#include "conncpp/BulkLoader.hpp"
+#include "conncpp/Pipeline.hpp"
+#include "conncpp/Metrics.hpp"
+#include "conncpp/Tracing.hpp"
+#include "conncpp/Decimal.hpp"
+#include "conncpp/ResultSetExport.hpp"
+#include "conncpp/ParallelScan.hpp"
+#include "conncpp/ResultCache.hpp"
 
 #include "conncpp/SQLString.hpp"
 #include "conncpp/Exception.hpp"
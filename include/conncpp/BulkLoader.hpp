@@ -0,0 +1,73 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _BULKLOADER_H_
+#define _BULKLOADER_H_
+
+#include <list>
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+#include "CArray.hpp"
+
+namespace sql
+{
+class Connection;
+
+/* Loads rows into a table with LOAD DATA LOCAL INFILE. Rows are encoded in memory, and sent to the server, when the
+   buffer(bulkLoadBufferSize option) is full, or on flush() */
+class MARIADB_EXPORTED BulkLoader {
+  BulkLoader(const BulkLoader &);
+  void operator=(BulkLoader &);
+public:
+  BulkLoader() {}
+  virtual ~BulkLoader(){}
+
+  virtual void setNull(int32_t columnIndex)=0;
+  virtual void setBoolean(int32_t columnIndex, bool value)=0;
+  virtual void setInt(int32_t columnIndex, int32_t value)=0;
+  virtual void setUInt(int32_t columnIndex, uint32_t value)=0;
+  virtual void setLong(int32_t columnIndex, int64_t value)=0;
+  virtual void setUInt64(int32_t columnIndex, uint64_t value)=0;
+  virtual void setDouble(int32_t columnIndex, double value)=0;
+  virtual void setString(int32_t columnIndex, const SQLString& value)=0;
+  virtual void setBytes(int32_t columnIndex, const bytes* value)=0;
+  /* Appends current row to the buffer. Columns, that have not been set, are loaded as NULL */
+  virtual void addRow()=0;
+  /* Sends buffered rows to the server. Returns number of rows affected by the load */
+  virtual int64_t flush()=0;
+  virtual void close()=0;
+  virtual bool isClosed()=0;
+
+  virtual int64_t getRowCount()=0;
+  virtual int64_t getByteCount()=0;
+  virtual double getRowsPerSecond()=0;
+  virtual double getBytesPerSecond()=0;
+};
+
+namespace mariadb
+{
+  /* Creates loader for the table. If the list of columns is empty, rows are loaded in all table columns in their order */
+  MARIADB_EXPORTED BulkLoader* create_bulk_loader(Connection* connection, const SQLString& table,
+                                                  const std::list<SQLString>& columns= std::list<SQLString>());
+}
+}
+#endif
@@ -0,0 +1,118 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _DECIMAL_HPP_
+#define _DECIMAL_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+
+namespace sql
+{
+class ResultSet;
+class PreparedStatement;
+
+/* Fixed-point decimal number with up to 65 digits, of them up to 38 after the decimal point - the range of the DECIMAL
+   type. The value is kept as a scaled integer, and objects of the class do not allocate memory. Operations, which
+   results do not fit the range, throw SQLException with SQLState 22003. Digits after the maximum scale are rounded
+   half away from zero */
+class MARIADB_EXPORTED Decimal final
+{
+public:
+  static const int32_t MAX_PRECISION= 65;
+  static const int32_t MAX_SCALE= 38;
+  /* Buffer size sufficient for toChars, including terminating null */
+  static const std::size_t BUFFER_SIZE= MAX_PRECISION + 3;
+
+  Decimal();
+  Decimal(int64_t value);
+  /* Throws SQLException with SQLState 22018, if the string is not a number. Exponent form is accepted */
+  Decimal(const char* str, std::size_t len);
+  explicit Decimal(const SQLString& str);
+
+  static Decimal fromUnsigned(uint64_t value);
+  /* Exact decimal value of the shortest representation of the double */
+  static Decimal fromDouble(double value);
+
+  /* Number of digits after the decimal point */
+  int32_t getScale() const { return scale; }
+  /* Number of significant digits in the unscaled value */
+  int32_t getPrecision() const;
+  /* -1, 0 or 1 */
+  int32_t signum() const;
+  bool isZero() const;
+
+  /* Returns value with the given scale, rounding half away from zero if the scale is reduced */
+  Decimal setScale(int32_t newScale) const;
+
+  Decimal operator-() const;
+  Decimal operator+(const Decimal& other) const;
+  Decimal operator-(const Decimal& other) const;
+  Decimal operator*(const Decimal& other) const;
+  Decimal& operator+=(const Decimal& other) { return *this= *this + other; }
+  Decimal& operator-=(const Decimal& other) { return *this= *this - other; }
+  Decimal& operator*=(const Decimal& other) { return *this= *this * other; }
+
+  /* Numeric comparison - 1.5 and 1.50 are equal */
+  int32_t compare(const Decimal& other) const;
+  bool operator==(const Decimal& other) const { return compare(other) == 0; }
+  bool operator!=(const Decimal& other) const { return compare(other) != 0; }
+  bool operator<(const Decimal& other) const { return compare(other) < 0; }
+  bool operator<=(const Decimal& other) const { return compare(other) <= 0; }
+  bool operator>(const Decimal& other) const { return compare(other) > 0; }
+  bool operator>=(const Decimal& other) const { return compare(other) >= 0; }
+
+  /* Writes plain representation of the value with exactly getScale() digits after the point to buf of at least
+     BUFFER_SIZE bytes. Returns length of the string */
+  std::size_t toChars(char* buf) const;
+  SQLString toString() const;
+  /* Integer part of the value. Throws SQLException if it does not fit int64_t */
+  int64_t toLong() const;
+  double toDouble() const;
+
+private:
+  static const int32_t LIMBS= 8;
+
+  /* Unscaled value in base 10^9, least significant limb first */
+  uint32_t limbs[LIMBS];
+  int32_t scale;
+  bool negative;
+
+  void parse(const char* str, std::size_t len);
+  /* Sets the value from the intermediate result of an operation, that has twice as many limbs */
+  void assign(const uint32_t* wide, int32_t wideScale, bool isNegative);
+};
+
+namespace mariadb
+{
+  /* Returns value of the column of the current row as Decimal, without creating intermediate strings. The result set
+     must be created by this driver. Returns zero for NULL values - wasNull() tells if the value was NULL */
+  MARIADB_EXPORTED Decimal get_decimal(ResultSet* rs, int32_t columnIndex);
+  MARIADB_EXPORTED Decimal get_decimal(ResultSet* rs, const SQLString& columnLabel);
+  /* Sets the parameter to the value. For server-side prepared statements it is sent as the DECIMAL type */
+  MARIADB_EXPORTED void set_decimal(PreparedStatement* stmt, int32_t parameterIndex, const Decimal& value);
+}
+}
+#endif
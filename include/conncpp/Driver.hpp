@@ -54,6 +54,9 @@ public:
 namespace mariadb
 {
   MARIADB_EXPORTED Driver* get_driver_instance();
+  /* Drops cached DatabaseMetaData results(see metadataCacheTtl option) of the server, or of all servers if the host is empty.
+     If the schema is not empty, only results related to it are dropped */
+  MARIADB_EXPORTED void invalidate_metadata_cache(const SQLString& host= "", int32_t port= 3306, const SQLString& schema= "");
 }
 }
 
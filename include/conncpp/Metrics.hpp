@@ -0,0 +1,57 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _METRICS_HPP_
+#define _METRICS_HPP_
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+  /* Driver-wide counters, that are collected for all connections of the process.
+
+     Counters:
+       round_trips               - commands sent to the server
+       payload_bytes_sent        - bytes of query texts and long data parameters sent to the server
+       payload_bytes_received    - bytes of text protocol row values received from the server
+       server_prepares           - statements prepared on the server
+       batch_rewrite, batch_multi_rewrite, batch_bulk, batch_multi, batch_slow
+                                 - batches of client-side prepared statements by the way they have been executed
+       reconnects                - reconnects of connections
+       result_sets_buffered, result_sets_streaming
+                                 - result sets by the way their rows are read
+       result_cache_hits         - queries served from the query result cache
+       lock_waits, lock_wait_micros
+                                 - number of statement executions and the time they have waited for the connection */
+
+  /* Returns the current value of the counter. Throws IllegalArgumentException if there is no counter with such name */
+  MARIADB_EXPORTED int64_t get_metric(const SQLString& name);
+  /* Returns all metrics in Prometheus text exposition format, or as a JSON object if json is true */
+  MARIADB_EXPORTED SQLString dump_metrics(bool json= false);
+  /* Sets all counters to zero */
+  MARIADB_EXPORTED void reset_metrics();
+}
+}
+#endif
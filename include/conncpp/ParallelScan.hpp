@@ -0,0 +1,88 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _PARALLELSCAN_H_
+#define _PARALLELSCAN_H_
+
+#include <cstddef>
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+
+namespace sql
+{
+class Connection;
+class ResultSet;
+
+/* Reads a table, or a query result, in parallel on several connections. The range between the minimum and maximum values
+   of an integer key is split into partitions, each of which is read with "key BETWEEN lower AND upper" condition.
+   Connections are opened with the same parameters as the connection the scan is created for. Rows with NULL key are
+   not read */
+class MARIADB_EXPORTED ParallelScan {
+  ParallelScan(const ParallelScan &);
+  void operator=(ParallelScan &);
+public:
+  /* Called for each partition in the thread reading it. The result set is positioned before the first row of the
+     partition, and is closed after the callback returns */
+  typedef void (*PartitionCallback)(std::size_t partition, ResultSet* rs, void* context);
+
+  ParallelScan() {}
+  virtual ~ParallelScan(){}
+
+  /* Number of partitions the key range is split into. Default is the number of connections. Can be set before the scan
+     is started */
+  virtual void setPartitionCount(std::size_t count)=0;
+  /* Number of rows fetched at once by result sets streaming partitions, in forEachPartition and in the merged stream.
+     0(default) means partitions are read completely when their queries are executed */
+  virtual void setFetchSize(int32_t rows)=0;
+  /* The key column and its bounds. The bounds are queried once, on the first call of any of methods below */
+  virtual const SQLString& getKey()=0;
+  virtual int64_t getMinKey()=0;
+  virtual int64_t getMaxKey()=0;
+  /* Number of partitions. Can be less than requested, if the key range is smaller. 0 if there are no rows */
+  virtual std::size_t getPartitionCount()=0;
+  /* Streams partitions concurrently, one per connection at a time, and calls the callback for each of them. Returns
+     when all partitions are processed. The first error of a partition, or thrown by the callback, is thrown after
+     all threads finish */
+  virtual void forEachPartition(PartitionCallback callback, void* context)=0;
+  /* Moves to the next row of all partitions merged in the key order. Partitions following the current one are read
+     in background, up to one per connection */
+  virtual bool next()=0;
+  /* Result set of the current partition, positioned on the current row. Is valid until next() returns a row of
+     another partition */
+  virtual ResultSet* getResultSet()=0;
+  virtual void close()=0;
+  virtual bool isClosed()=0;
+};
+
+namespace mariadb
+{
+  /* Creates scan of the table. If key is empty, the single-column primary key of the table is used. connections is
+     number of connections the scan opens. 0 means the number of hardware threads */
+  MARIADB_EXPORTED ParallelScan* create_parallel_scan(Connection* connection, const SQLString& table,
+                                                      std::size_t connections= 0, const SQLString& key= "");
+  /* Creates scan of the query result by its column key */
+  MARIADB_EXPORTED ParallelScan* create_parallel_query_scan(Connection* connection, const SQLString& query,
+                                                            const SQLString& key, std::size_t connections= 0);
+}
+}
+#endif
@@ -0,0 +1,72 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+
+namespace sql
+{
+class Connection;
+class PreparedStatement;
+class ResultSet;
+
+/* Executes independent statements on one connection, sending next statements before results of the previous ones are
+   read. Statements are queued with add(), and are executed in the order they have been added by execute(). Errors of
+   statements do not stop the pipeline - the error of a statement is thrown when its result is requested */
+class MARIADB_EXPORTED Pipeline {
+  Pipeline(const Pipeline &);
+  void operator=(Pipeline &);
+public:
+  Pipeline() {}
+  virtual ~Pipeline(){}
+
+  /* Queues the query. Returns index of its result */
+  virtual std::size_t add(const SQLString& sql)=0;
+  /* Queues execution of the prepared statement, that must stay open until execute() is complete. It's executed with
+     parameters it has at that time. Server-side prepared statements are executed in their turn, but cannot be sent
+     before results of the previous statements are read. Returns index of its result */
+  virtual std::size_t add(PreparedStatement* pstmt)=0;
+  /* Executes queued statements */
+  virtual void execute()=0;
+  /* Number of queued statements */
+  virtual std::size_t size()=0;
+  /* Returns result set of the executed statement, owned by the caller, or nullptr if it has not returned one */
+  virtual ResultSet* getResultSet(std::size_t index)=0;
+  /* Returns update count of the executed statement, or -1 if it has returned a result set */
+  virtual int64_t getUpdateCount(std::size_t index)=0;
+  /* Drops queued statements and their results */
+  virtual void clear()=0;
+  virtual void close()=0;
+  virtual bool isClosed()=0;
+};
+
+namespace mariadb
+{
+  /* Creates pipeline for the connection. maxInFlight limits the number of statements sent, which results have not been
+     read yet */
+  MARIADB_EXPORTED Pipeline* create_pipeline(Connection* connection, std::size_t maxInFlight= 32);
+}
+}
+#endif
@@ -0,0 +1,41 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _RESULTCACHE_HPP_
+#define _RESULTCACHE_HPP_
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+  /* Drops results of queries reading the table from the query result cache(see queryResultCacheTtl option). The name
+     may be qualified with the schema name, otherwise the table is matched in all schemas. Needed when the table is
+     changed not through this driver */
+  MARIADB_EXPORTED void invalidate_result_cache(const SQLString& table);
+  /* Drops all results from the query result cache */
+  MARIADB_EXPORTED void clear_result_cache();
+}
+}
+#endif
@@ -0,0 +1,92 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _RESULTSETEXPORT_HPP_
+#define _RESULTSETEXPORT_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "buildconf.hpp"
+
+namespace sql
+{
+class ResultSet;
+
+/* Format of the result set export. Defaults are the CSV as described in RFC 4180 */
+struct ExportOptions
+{
+  enum Quoting {
+    /* Only values containing separators, quotes, line breaks or the escape character are quoted */
+    QUOTE_MINIMAL,
+    /* All values except NULLs are quoted */
+    QUOTE_ALL,
+    /* Nothing is quoted - special characters are prefixed with the escape character */
+    QUOTE_NONE
+  };
+
+  char fieldSeparator= ',';
+  char quote= '"';
+  /* Character escaping quote inside quoted values, and special characters with QUOTE_NONE. '\0' means, that quote
+     is doubled */
+  char escape= '\0';
+  const char* lineTerminator= "\r\n";
+  /* Written for NULL values. If it's empty, empty strings are quoted to be distinguishable from NULLs */
+  const char* nullValue= "";
+  Quoting quoting= QUOTE_MINIMAL;
+  /* Whether to write the line with column labels first */
+  bool header= false;
+  /* Whether binary strings are written as hex digits, or as they are */
+  bool binaryAsHex= false;
+  /* Size of the output buffer. The sink is called, when it's full */
+  std::size_t bufferSize= 1024*1024;
+
+  /* Tab separated values in the default format of LOAD DATA INFILE */
+  static ExportOptions tsv()
+  {
+    ExportOptions tsvOptions;
+    tsvOptions.fieldSeparator= '\t';
+    tsvOptions.escape= '\\';
+    tsvOptions.lineTerminator= "\n";
+    tsvOptions.nullValue= "\\N";
+    tsvOptions.quoting= QUOTE_NONE;
+    return tsvOptions;
+  }
+};
+
+/* Sink for exported data. Has to consume all length bytes, or throw */
+typedef void (*ExportWriter)(const char* data, std::size_t length, void* context);
+
+namespace mariadb
+{
+  /* Write rows following the current position of the result set to the sink, reading values right from the row
+     buffers. Returns number of exported rows. The result set must be created by this driver, and after the call it
+     is positioned after the last row */
+  MARIADB_EXPORTED int64_t export_result_set(ResultSet* rs, std::ostream& out, const ExportOptions& options= ExportOptions());
+  /* fd is the descriptor of a file or a pipe, open for writing */
+  MARIADB_EXPORTED int64_t export_result_set(ResultSet* rs, int fd, const ExportOptions& options= ExportOptions());
+  MARIADB_EXPORTED int64_t export_result_set(ResultSet* rs, ExportWriter writer, void* context,
+                                             const ExportOptions& options= ExportOptions());
+}
+}
+#endif
@@ -0,0 +1,43 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _TRACING_HPP_
+#define _TRACING_HPP_
+
+#include "buildconf.hpp"
+#include "SQLString.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+  /* Starts or stops recording of connect, prepare, execute, fetch and close spans of all connections. Each thread
+     keeps its last 4096 spans. Recording a span does not lock or allocate memory, so tracing may stay enabled in
+     production */
+  MARIADB_EXPORTED void enable_tracing(bool enable);
+  /* Returns recorded spans in Chrome trace event format, that can be loaded into chrome://tracing or Perfetto */
+  MARIADB_EXPORTED SQLString dump_trace();
+  /* Drops spans recorded so far */
+  MARIADB_EXPORTED void clear_trace();
+}
+}
+#endif
@@ -1329,6 +1329,20 @@ namespace mariadb
     setParameter(parameterIndex,new StringParameter(str, noBackslashEscapes));
   }
 
+  /**
+   * Sets the designated parameter to the given Decimal value. It's sent as the DECIMAL type to the server.
+   *
+   * @param parameterIndex the first parameter is 1, the second is 2, ...
+   * @param value the parameter value
+   * @throws SQLException if parameterIndex does not correspond to a parameter marker in the SQL
+   *     statement; if a database access error occurs or this method is called on a closed <code>
+   *     PreparedStatement</code>
+   */
+  void BasePrepareStatement::setDecimal(int32_t parameterIndex, const Decimal& value)
+  {
+    setParameter(parameterIndex, new DecimalParameter(value));
+  }
+
   /**
    * Sets the designated parameter to the given Java array of bytes. The driver converts this to an
    * SQL <code>VARBINARY</code> or <code>LONGVARBINARY</code> (depending on the argument's size
@@ -24,6 +24,7 @@
 #include "Consts.h"
 
 #include "PreparedStatement.hpp"
+#include "Decimal.hpp"
 
 #include "ColumnType.h"
 #include "parameters/ParameterHolder.h"
@@ -158,6 +159,7 @@ public:
   void setByte(int32_t parameterIndex, int8_t byte);
   void setShort(int32_t parameterIndex, int16_t value);
   void setString(int32_t parameterIndex, const SQLString& str);
+  void setDecimal(int32_t parameterIndex, const Decimal& value);
   void setBytes(int32_t parameterIndex, sql::bytes* bytes);
   void setInt(int32_t column, int32_t value);
   void setLong(int32_t parameterIndex, int64_t value);
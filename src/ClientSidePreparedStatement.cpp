@@ -24,6 +24,8 @@
 #include "Results.h"
 #include "Protocol.h"
 #include "util/ClientPrepareResult.h"
+#include "util/Metrics.h"
+#include "cache/ClientPrepareCache.h"
 #include "parameters/ParameterHolder.h"
 #include "ServerSidePreparedStatement.h"
 #include "MariaDbParameterMetaData.h"
@@ -69,12 +71,8 @@ namespace mariadb
     : BasePrepareStatement(connection, resultSetScrollType, resultSetConcurrency, autoGeneratedKeys, factory),
       sqlQuery(sql)
   {
-    if (protocol->getOptions()->rewriteBatchedStatements) {
-      prepareResult.reset(ClientPrepareResult::rewritableParts(sqlQuery, protocol->noBackslashEscapes()));
-    }
-    else {
-      prepareResult.reset(ClientPrepareResult::parameterParts(sqlQuery, protocol->noBackslashEscapes()));
-    }
+    prepareResult= ClientPrepareCache::getInstance().get(sqlQuery, protocol->noBackslashEscapes(),
+      protocol->getOptions()->rewriteBatchedStatements, protocol->getOptions()->clientPrepareCacheSize);
     parameters.reserve(prepareResult->getParamCount());
     parameters.assign(prepareResult->getParamCount(), Shared::ParameterHolder());
   }
@@ -105,13 +103,13 @@ namespace mariadb
     // valid parameters
     for (uint32_t i= 0; i < prepareResult->getParamCount(); ++i) {
       if (!parameters[i]) {
-        logger->error("Parameter at position " + std::to_string(i + 1) + " is not set");
+        LOGGER_ERROR(logger, "Parameter at position " + std::to_string(i + 1) + " is not set");
         exceptionFactory->raiseStatementError(connection, this)->create("Parameter at position "
           + std::to_string(i + 1) + " is not set", "07004").Throw();
       }
     }
 
-    std::unique_lock<std::mutex> localScopeLock(*protocol->getLock());
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*protocol->getLock()));
     try {
       stmt->executeQueryPrologue(false);
       stmt->setInternalResults(
@@ -133,6 +131,7 @@ namespace mariadb
         stmt->canUseServerTimeout ? stmt->queryTimeout : -1);
 
       stmt->getInternalResults()->commandEnd();
+      stmt->invalidateMetadataCache(sqlQuery);
       stmt->executeEpilogue();
       return stmt->getInternalResults()->getResultSet();
     }
@@ -162,7 +161,7 @@ namespace mariadb
     for (uint32_t i= 0; i < holder.size(); i++) {
       holder[i]= parameters[i];
       if (!holder[i]) {
-        logger->error(
+        LOGGER_ERROR(logger,
           "You need to set exactly "
           + std::to_string(prepareResult->getParamCount())
           + " parameters on the prepared statement");
@@ -190,7 +189,7 @@ namespace mariadb
       return stmt->batchRes.wrap(nullptr, 0);
     }
 
-    std::unique_lock<std::mutex> localScopeLock(*protocol->getLock());
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*protocol->getLock()));
     try {
       executeInternalBatch(size);
       stmt->getInternalResults()->commandEnd();
@@ -237,7 +236,7 @@ namespace mariadb
       return stmt->largeBatchRes.wrap(nullptr, 0);
     }
 
-    std::unique_lock<std::mutex> localScopeLock(*protocol->getLock());
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*protocol->getLock()));
     try {
       executeInternalBatch(size);
       stmt->getInternalResults()->commandEnd();
@@ -351,7 +350,7 @@ namespace mariadb
         error.append(" - \""+sqlQuery +"\"");
       }
 
-      logger->error(error);
+      LOGGER_ERROR(logger, error);
       exceptionFactory->raiseStatementError(connection, this)->create(error).Throw();
     }
   }
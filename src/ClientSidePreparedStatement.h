@@ -36,6 +36,8 @@ namespace mariadb
 class ClientSidePreparedStatement : public BasePrepareStatement
 {
   static const Shared::Logger logger ; /*LoggerFactory.getLogger(typeid(ClientSidePreparedStatement))*/
+  friend class MariaDbPipeline;
+
   std::vector<std::vector<Shared::ParameterHolder>> parameterList;
   Shared::ClientPrepareResult prepareResult;
   SQLString sqlQuery;
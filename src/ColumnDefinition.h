@@ -40,11 +40,11 @@ public:
 
   virtual ~ColumnDefinition()=default;
 
-  virtual SQLString getDatabase() const=0;
-  virtual SQLString getTable() const=0;
-  virtual SQLString getOriginalTable() const=0;
-  virtual SQLString getName() const=0;
-  virtual SQLString getOriginalName() const=0;
+  virtual const SQLString& getDatabase() const=0;
+  virtual const SQLString& getTable() const=0;
+  virtual const SQLString& getOriginalTable() const=0;
+  virtual const SQLString& getName() const=0;
+  virtual const SQLString& getOriginalName() const=0;
   virtual short getCharsetNumber() const=0;
   virtual SQLString getCollation() const=0;
   /* Length of the column */
@@ -0,0 +1,645 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "Decimal.hpp"
+#include "Exception.hpp"
+
+#include "SelectResultSet.h"
+#include "BasePrepareStatement.h"
+#include "util/FloatConversion.h"
+
+namespace sql
+{
+namespace
+{
+  const uint32_t BASE= 1000000000;
+  const int32_t DIGITS_PER_LIMB= 9;
+  /* Intermediate results of operations have twice as many limbs, that is enough for any product or scale alignment */
+  const int32_t WIDE= 16;
+  const uint32_t powersOf10[]= { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+
+
+  inline bool isDigit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+
+  inline bool isSpace(char c)
+  {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+
+  void throwOutOfRange()
+  {
+    throw SQLException("Decimal value is out of range", "22003", 1264);
+  }
+
+
+  void throwIncorrectValue(const char* str, std::size_t len)
+  {
+    std::string msg("Incorrect decimal value: '");
+    msg.append(str, len).append("'");
+    throw SQLException(msg.c_str(), "22018", 1366);
+  }
+
+  /* w= w*multiplier + addend. Callers make sure the result fits */
+  void mulSmall(uint32_t* w, int32_t count, uint32_t multiplier, uint32_t addend= 0)
+  {
+    uint64_t carry= addend;
+    for (int32_t i= 0; i < count; ++i) {
+      uint64_t cur= static_cast<uint64_t>(w[i])*multiplier + carry;
+      w[i]= static_cast<uint32_t>(cur % BASE);
+      carry= cur / BASE;
+    }
+  }
+
+  /* w= w/divisor, returns the remainder */
+  uint32_t divSmall(uint32_t* w, int32_t count, uint32_t divisor)
+  {
+    uint64_t rem= 0;
+    for (int32_t i= count - 1; i >= 0; --i) {
+      uint64_t cur= rem*BASE + w[i];
+      w[i]= static_cast<uint32_t>(cur / divisor);
+      rem= cur % divisor;
+    }
+    return static_cast<uint32_t>(rem);
+  }
+
+
+  void increment(uint32_t* w, int32_t count)
+  {
+    for (int32_t i= 0; i < count; ++i) {
+      if (++w[i] < BASE) {
+        return;
+      }
+      w[i]= 0;
+    }
+  }
+
+
+  void mulPow10(uint32_t* w, int32_t count, int32_t power)
+  {
+    int32_t limbShift= power / DIGITS_PER_LIMB;
+    if (limbShift > 0) {
+      std::memmove(w + limbShift, w, (count - limbShift)*sizeof(uint32_t));
+      std::memset(w, 0, limbShift*sizeof(uint32_t));
+    }
+    if (power % DIGITS_PER_LIMB > 0) {
+      mulSmall(w, count, powersOf10[power % DIGITS_PER_LIMB]);
+    }
+  }
+
+  /* Divides by 10^power, truncating the result */
+  void divPow10(uint32_t* w, int32_t count, int32_t power)
+  {
+    int32_t limbShift= power / DIGITS_PER_LIMB;
+    if (limbShift >= count) {
+      std::memset(w, 0, count*sizeof(uint32_t));
+      return;
+    }
+    if (limbShift > 0) {
+      std::memmove(w, w + limbShift, (count - limbShift)*sizeof(uint32_t));
+      std::memset(w + count - limbShift, 0, limbShift*sizeof(uint32_t));
+    }
+    if (power % DIGITS_PER_LIMB > 0) {
+      divSmall(w, count, powersOf10[power % DIGITS_PER_LIMB]);
+    }
+  }
+
+  /* Divides by 10^power, rounding half away from zero. Only the first dropped digit matters for that */
+  void divPow10Round(uint32_t* w, int32_t count, int32_t power)
+  {
+    if (power <= 0) {
+      return;
+    }
+    divPow10(w, count, power - 1);
+    if (divSmall(w, count, 10) >= 5) {
+      increment(w, count);
+    }
+  }
+
+
+  int32_t compareWide(const uint32_t* a, const uint32_t* b, int32_t count)
+  {
+    for (int32_t i= count - 1; i >= 0; --i) {
+      if (a[i] != b[i]) {
+        return a[i] < b[i] ? -1 : 1;
+      }
+    }
+    return 0;
+  }
+
+
+  void addWide(uint32_t* a, const uint32_t* b, int32_t count)
+  {
+    uint32_t carry= 0;
+    for (int32_t i= 0; i < count; ++i) {
+      a[i]+= b[i] + carry;
+      carry= a[i] >= BASE ? 1 : 0;
+      if (carry) {
+        a[i]-= BASE;
+      }
+    }
+  }
+
+  /* a-= b, a must not be less than b */
+  void subWide(uint32_t* a, const uint32_t* b, int32_t count)
+  {
+    uint32_t borrow= 0;
+    for (int32_t i= 0; i < count; ++i) {
+      uint32_t subtrahend= b[i] + borrow;
+      borrow= a[i] < subtrahend ? 1 : 0;
+      a[i]= a[i] + (borrow ? BASE : 0) - subtrahend;
+    }
+  }
+
+
+  int32_t digitCount(const uint32_t* w, int32_t count)
+  {
+    int32_t top= count - 1;
+    while (top >= 0 && w[top] == 0) {
+      --top;
+    }
+    if (top < 0) {
+      return 0;
+    }
+    int32_t digits= 1;
+    while (digits < DIGITS_PER_LIMB && w[top] >= powersOf10[digits]) {
+      ++digits;
+    }
+    return top*DIGITS_PER_LIMB + digits;
+  }
+
+
+  /* Brings both values to the same, bigger, scale */
+  int32_t alignScales(const uint32_t* limbs1, int32_t scale1, const uint32_t* limbs2, int32_t scale2,
+    std::size_t size, uint32_t* wide1, uint32_t* wide2)
+  {
+    std::memset(wide1, 0, WIDE*sizeof(uint32_t));
+    std::memset(wide2, 0, WIDE*sizeof(uint32_t));
+    std::memcpy(wide1, limbs1, size);
+    std::memcpy(wide2, limbs2, size);
+
+    if (scale1 < scale2) {
+      mulPow10(wide1, WIDE, scale2 - scale1);
+      return scale2;
+    }
+    mulPow10(wide2, WIDE, scale1 - scale2);
+    return scale1;
+  }
+}
+
+
+  Decimal::Decimal()
+    : limbs()
+    , scale(0)
+    , negative(false)
+  {
+  }
+
+
+  Decimal::Decimal(int64_t value)
+    : limbs()
+    , scale(0)
+    , negative(value < 0)
+  {
+    uint64_t magnitude= negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    limbs[0]= static_cast<uint32_t>(magnitude % BASE);
+    limbs[1]= static_cast<uint32_t>(magnitude / BASE % BASE);
+    limbs[2]= static_cast<uint32_t>(magnitude / BASE / BASE);
+  }
+
+
+  Decimal::Decimal(const char* str, std::size_t len)
+    : limbs()
+    , scale(0)
+    , negative(false)
+  {
+    parse(str, len);
+  }
+
+
+  Decimal::Decimal(const SQLString& str)
+    : limbs()
+    , scale(0)
+    , negative(false)
+  {
+    parse(str.c_str(), str.length());
+  }
+
+
+  Decimal Decimal::fromUnsigned(uint64_t value)
+  {
+    Decimal result;
+    result.limbs[0]= static_cast<uint32_t>(value % BASE);
+    result.limbs[1]= static_cast<uint32_t>(value / BASE % BASE);
+    result.limbs[2]= static_cast<uint32_t>(value / BASE / BASE);
+    return result;
+  }
+
+
+  Decimal Decimal::fromDouble(double value)
+  {
+    if (!std::isfinite(value)) {
+      throwOutOfRange();
+    }
+    char buf[mariadb::FloatConversion::BUFFER_SIZE];
+    return Decimal(buf, mariadb::FloatConversion::format(value, buf));
+  }
+
+
+  void Decimal::parse(const char* str, std::size_t len)
+  {
+    const char* p= str, *end= str + len;
+    bool isNegative= false;
+    int64_t exponent= 0;
+
+    while (p < end && isSpace(*p)) {
+      ++p;
+    }
+    if (p < end && (*p == '-' || *p == '+')) {
+      isNegative= (*p == '-');
+      ++p;
+    }
+    const char* intBegin= p;
+    while (p < end && isDigit(*p)) {
+      ++p;
+    }
+    const char* intEnd= p, *fracBegin= p, *fracEnd= p;
+    if (p < end && *p == '.') {
+      fracBegin= ++p;
+      while (p < end && isDigit(*p)) {
+        ++p;
+      }
+      fracEnd= p;
+    }
+    if (intBegin == intEnd && fracBegin == fracEnd) {
+      throwIncorrectValue(str, len);
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      bool negativeExp= false;
+      ++p;
+      if (p < end && (*p == '-' || *p == '+')) {
+        negativeExp= (*p == '-');
+        ++p;
+      }
+      if (p == end || !isDigit(*p)) {
+        throwIncorrectValue(str, len);
+      }
+      for (; p < end && isDigit(*p); ++p) {
+        // Anything bigger is out of range or zero anyway
+        if (exponent < 100000) {
+          exponent= exponent*10 + (*p - '0');
+        }
+      }
+      if (negativeExp) {
+        exponent= -exponent;
+      }
+    }
+    while (p < end && isSpace(*p)) {
+      ++p;
+    }
+    if (p != end) {
+      throwIncorrectValue(str, len);
+    }
+
+    const int64_t intDigits= intEnd - intBegin, fracDigits= fracEnd - fracBegin, total= intDigits + fracDigits;
+    auto digitAt= [&](int64_t i) { return i < intDigits ? intBegin[i] : fracBegin[i - intDigits]; };
+    int64_t first= 0, newScale= fracDigits - exponent;
+
+    while (first < total && digitAt(first) == '0') {
+      ++first;
+    }
+    if (first == total) {
+      scale= static_cast<int32_t>(newScale < 0 ? 0 : (newScale > MAX_SCALE ? MAX_SCALE : newScale));
+      return;
+    }
+
+    int64_t significant= total - first;
+    bool roundUp= false;
+    if (newScale > MAX_SCALE) {
+      int64_t keep= significant - (newScale - MAX_SCALE);
+      newScale= MAX_SCALE;
+      if (keep < 0) {
+        scale= MAX_SCALE;
+        return;
+      }
+      roundUp= digitAt(first + keep) >= '5';
+      significant= keep;
+    }
+    int64_t zeros= newScale < 0 ? -newScale : 0;
+    if (significant + zeros > MAX_PRECISION) {
+      throwOutOfRange();
+    }
+
+    uint32_t chunk= 0;
+    int32_t chunkLength= 0;
+    for (int64_t i= 0; i < significant; ++i) {
+      chunk= chunk*10 + (digitAt(first + i) - '0');
+      if (++chunkLength == DIGITS_PER_LIMB) {
+        mulSmall(limbs, LIMBS, BASE, chunk);
+        chunk= 0;
+        chunkLength= 0;
+      }
+    }
+    if (chunkLength > 0) {
+      mulSmall(limbs, LIMBS, powersOf10[chunkLength], chunk);
+    }
+    mulPow10(limbs, LIMBS, static_cast<int32_t>(zeros));
+    if (roundUp) {
+      increment(limbs, LIMBS);
+      if (digitCount(limbs, LIMBS) > MAX_PRECISION) {
+        throwOutOfRange();
+      }
+    }
+    scale= static_cast<int32_t>(newScale < 0 ? 0 : newScale);
+    negative= isNegative && !isZero();
+  }
+
+
+  void Decimal::assign(const uint32_t* wide, int32_t wideScale, bool isNegative)
+  {
+    uint32_t w[WIDE];
+    std::memcpy(w, wide, sizeof(w));
+
+    if (wideScale > MAX_SCALE) {
+      divPow10Round(w, WIDE, wideScale - MAX_SCALE);
+      wideScale= MAX_SCALE;
+    }
+    if (digitCount(w, WIDE) > MAX_PRECISION) {
+      throwOutOfRange();
+    }
+    std::memcpy(limbs, w, sizeof(limbs));
+    scale= wideScale;
+    negative= isNegative && !isZero();
+  }
+
+
+  int32_t Decimal::getPrecision() const
+  {
+    int32_t digits= digitCount(limbs, LIMBS);
+    return digits > 0 ? digits : 1;
+  }
+
+
+  bool Decimal::isZero() const
+  {
+    for (auto limb : limbs) {
+      if (limb != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+
+  int32_t Decimal::signum() const
+  {
+    return isZero() ? 0 : (negative ? -1 : 1);
+  }
+
+
+  Decimal Decimal::setScale(int32_t newScale) const
+  {
+    if (newScale < 0 || newScale > MAX_SCALE) {
+      throw IllegalArgumentException("Decimal scale has to be between 0 and 38", "22023");
+    }
+    uint32_t wide[WIDE]= { 0 };
+    std::memcpy(wide, limbs, sizeof(limbs));
+
+    if (newScale > scale) {
+      mulPow10(wide, WIDE, newScale - scale);
+    }
+    else {
+      divPow10Round(wide, WIDE, scale - newScale);
+    }
+    Decimal result;
+    result.assign(wide, newScale, negative);
+    return result;
+  }
+
+
+  Decimal Decimal::operator-() const
+  {
+    Decimal result(*this);
+    result.negative= !negative && !isZero();
+    return result;
+  }
+
+  Decimal Decimal::operator+(const Decimal& other) const
+  {
+    uint32_t wide1[WIDE], wide2[WIDE];
+    int32_t commonScale= alignScales(limbs, scale, other.limbs, other.scale, sizeof(limbs), wide1, wide2);
+    Decimal result;
+
+    if (negative == other.negative) {
+      addWide(wide1, wide2, WIDE);
+      result.assign(wide1, commonScale, negative);
+    }
+    else if (compareWide(wide1, wide2, WIDE) >= 0) {
+      subWide(wide1, wide2, WIDE);
+      result.assign(wide1, commonScale, negative);
+    }
+    else {
+      subWide(wide2, wide1, WIDE);
+      result.assign(wide2, commonScale, other.negative);
+    }
+    return result;
+  }
+
+
+  Decimal Decimal::operator-(const Decimal& other) const
+  {
+    return *this + (-other);
+  }
+
+
+  Decimal Decimal::operator*(const Decimal& other) const
+  {
+    uint32_t wide[WIDE]= { 0 };
+
+    for (int32_t i= 0; i < LIMBS; ++i) {
+      uint64_t carry= 0;
+      for (int32_t j= 0; j < LIMBS; ++j) {
+        uint64_t cur= wide[i + j] + static_cast<uint64_t>(limbs[i])*other.limbs[j] + carry;
+        wide[i + j]= static_cast<uint32_t>(cur % BASE);
+        carry= cur / BASE;
+      }
+      wide[i + LIMBS]= static_cast<uint32_t>(carry);
+    }
+    Decimal result;
+    result.assign(wide, scale + other.scale, negative != other.negative);
+    return result;
+  }
+
+
+  int32_t Decimal::compare(const Decimal& other) const
+  {
+    int32_t sign= signum(), otherSign= other.signum();
+
+    if (sign != otherSign) {
+      return sign < otherSign ? -1 : 1;
+    }
+    if (sign == 0) {
+      return 0;
+    }
+    uint32_t wide1[WIDE], wide2[WIDE];
+    alignScales(limbs, scale, other.limbs, other.scale, sizeof(limbs), wide1, wide2);
+    int32_t result= compareWide(wide1, wide2, WIDE);
+
+    return negative ? -result : result;
+  }
+
+
+  std::size_t Decimal::toChars(char* buf) const
+  {
+    char digits[LIMBS*DIGITS_PER_LIMB];
+    int32_t top= LIMBS - 1, count= 0;
+
+    while (top > 0 && limbs[top] == 0) {
+      --top;
+    }
+    // Most significant limb without leading zeros, others padded to 9 digits
+    for (uint32_t limb= limbs[top]; ; limb/= 10) {
+      digits[count++]= static_cast<char>('0' + limb % 10);
+      if (limb < 10) {
+        break;
+      }
+    }
+    std::reverse(digits, digits + count);
+    for (int32_t i= top - 1; i >= 0; --i) {
+      uint32_t limb= limbs[i];
+      for (int32_t j= DIGITS_PER_LIMB - 1; j >= 0; --j, limb/= 10) {
+        digits[count + j]= static_cast<char>('0' + limb % 10);
+      }
+      count+= DIGITS_PER_LIMB;
+    }
+
+    char* p= buf;
+    if (negative) {
+      *p++= '-';
+    }
+    if (count <= scale) {
+      *p++= '0';
+      *p++= '.';
+      std::memset(p, '0', scale - count);
+      p+= scale - count;
+      std::memcpy(p, digits, count);
+      p+= count;
+    }
+    else {
+      std::memcpy(p, digits, count - scale);
+      p+= count - scale;
+      if (scale > 0) {
+        *p++= '.';
+        std::memcpy(p, digits + count - scale, scale);
+        p+= scale;
+      }
+    }
+    *p= '\0';
+    return static_cast<std::size_t>(p - buf);
+  }
+
+
+  SQLString Decimal::toString() const
+  {
+    char buf[BUFFER_SIZE];
+    return SQLString(buf, toChars(buf));
+  }
+
+
+  int64_t Decimal::toLong() const
+  {
+    uint32_t integral[LIMBS];
+    uint64_t magnitude= 0;
+
+    std::memcpy(integral, limbs, sizeof(limbs));
+    divPow10(integral, LIMBS, scale);
+    for (int32_t i= LIMBS - 1; i >= 0; --i) {
+      if (magnitude > (std::numeric_limits<uint64_t>::max() - integral[i]) / BASE) {
+        throwOutOfRange();
+      }
+      magnitude= magnitude*BASE + integral[i];
+    }
+    if (negative) {
+      if (magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + 1) {
+        throwOutOfRange();
+      }
+      return static_cast<int64_t>(0 - magnitude);
+    }
+    if (magnitude > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+      throwOutOfRange();
+    }
+    return static_cast<int64_t>(magnitude);
+  }
+
+
+  double Decimal::toDouble() const
+  {
+    char buf[BUFFER_SIZE];
+    double result= 0;
+    mariadb::FloatConversion::parse(buf, toChars(buf), result);
+    return result;
+  }
+
+namespace mariadb
+{
+  Decimal get_decimal(ResultSet* rs, int32_t columnIndex)
+  {
+    SelectResultSet* selectResultSet= dynamic_cast<SelectResultSet*>(rs);
+
+    if (selectResultSet == nullptr) {
+      throw IllegalArgumentException("ResultSet object does not belong to this driver", "HY000");
+    }
+    return selectResultSet->getDecimal(columnIndex);
+  }
+
+
+  Decimal get_decimal(ResultSet* rs, const SQLString& columnLabel)
+  {
+    SelectResultSet* selectResultSet= dynamic_cast<SelectResultSet*>(rs);
+
+    if (selectResultSet == nullptr) {
+      throw IllegalArgumentException("ResultSet object does not belong to this driver", "HY000");
+    }
+    return selectResultSet->getDecimal(columnLabel);
+  }
+
+
+  void set_decimal(PreparedStatement* stmt, int32_t parameterIndex, const Decimal& value)
+  {
+    BasePrepareStatement* preparedStatement= dynamic_cast<BasePrepareStatement*>(stmt);
+
+    if (preparedStatement == nullptr) {
+      throw IllegalArgumentException("PreparedStatement object does not belong to this driver", "HY000");
+    }
+    preparedStatement->setDecimal(parameterIndex, value);
+  }
+}
+}
@@ -0,0 +1,328 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "MariaDbBulkLoader.h"
+
+#include "MariaDbConnection.h"
+#include "Protocol.h"
+#include "Results.h"
+#include "com/CmdInformation.h"
+#include "options/Options.h"
+#include "util/FloatConversion.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  /**
+    * Creates loader for the table.
+    *
+    * @param connection connection to load data with
+    * @param table table name, as it would be written in the query
+    * @param columns columns to load values in, as they would be written in the query. If empty, all table columns are
+    *                loaded in their order
+    */
+  MariaDbBulkLoader::MariaDbBulkLoader(MariaDbConnection* connection, const SQLString& table, const std::list<SQLString>& columns)
+    : protocol(connection->getProtocol())
+    , loadQuery("LOAD DATA LOCAL INFILE 'bulk_loader' INTO TABLE ")
+    , columnCount(columns.size())
+    , bufferSize(static_cast<std::size_t>(protocol->getOptions()->bulkLoadBufferSize))
+    , started(std::chrono::steady_clock::now())
+    , elapsed(std::chrono::steady_clock::duration::zero())
+  {
+    // Default LOAD DATA format is used - tab separated fields, newline separated rows, and backslash as escape character
+    loadQuery.append(table);
+    // Otherwise the server reads the file in the character set of the database, and strings are sent in the one of the
+    // connection
+    const SQLString& charset= protocol->getOptions()->useCharacterEncoding;
+    loadQuery.append(" CHARACTER SET ").append(charset.empty() ? "utf8mb4" : charset);
+    if (!columns.empty()) {
+      loadQuery.append('(');
+      for (auto it= columns.begin(); it != columns.end(); ++it) {
+        if (it != columns.begin()) {
+          loadQuery.append(',');
+        }
+        loadQuery.append(*it);
+      }
+      loadQuery.append(')');
+    }
+    row.resize(columnCount);
+    rowNull.assign(columnCount, true);
+    buffer.reserve(bufferSize + bufferSize / 8);
+  }
+
+
+  MariaDbBulkLoader::~MariaDbBulkLoader()
+  {
+    try {
+      close();
+    }
+    catch (SQLException&) {
+    }
+  }
+
+
+  void MariaDbBulkLoader::checkClose()
+  {
+    if (closed) {
+      throw SQLException("Cannot do an operation on a closed bulk loader", "HY000");
+    }
+  }
+
+  /**
+    * Returns the buffer for the column value in the current row, marked as not NULL.
+    *
+    * @param columnIndex column index, starting from 1
+    */
+  std::string& MariaDbBulkLoader::value(int32_t columnIndex)
+  {
+    checkClose();
+    if (columnIndex <= 0 || (columnCount > 0 && static_cast<std::size_t>(columnIndex) > columnCount)) {
+      throw IllegalArgumentException("No such column: " + std::to_string(columnIndex), "22023");
+    }
+    std::size_t index= static_cast<std::size_t>(columnIndex - 1);
+    // Number of columns is defined by the first row, if columns list has not been given
+    if (index >= row.size()) {
+      row.resize(index + 1);
+      rowNull.resize(index + 1, true);
+    }
+    rowNull[index]= false;
+    row[index].clear();
+    return row[index];
+  }
+
+
+  void MariaDbBulkLoader::appendEscaped(const char* str, std::size_t length)
+  {
+    const char* end= str + length;
+
+    for (const char* it= str; it < end; ++it) {
+      switch (*it) {
+      case '\\':
+        buffer.append("\\\\", 2);
+        break;
+      case '\t':
+        buffer.append("\\t", 2);
+        break;
+      case '\n':
+        buffer.append("\\n", 2);
+        break;
+      case '\0':
+        buffer.append("\\0", 2);
+        break;
+      default:
+        buffer.push_back(*it);
+      }
+    }
+  }
+
+
+  void MariaDbBulkLoader::setNull(int32_t columnIndex)
+  {
+    value(columnIndex);
+    rowNull[columnIndex - 1]= true;
+  }
+
+
+  void MariaDbBulkLoader::setBoolean(int32_t columnIndex, bool _value)
+  {
+    value(columnIndex).push_back(_value ? '1' : '0');
+  }
+
+
+  void MariaDbBulkLoader::setInt(int32_t columnIndex, int32_t _value)
+  {
+    value(columnIndex).append(std::to_string(_value));
+  }
+
+
+  void MariaDbBulkLoader::setUInt(int32_t columnIndex, uint32_t _value)
+  {
+    value(columnIndex).append(std::to_string(_value));
+  }
+
+
+  void MariaDbBulkLoader::setLong(int32_t columnIndex, int64_t _value)
+  {
+    value(columnIndex).append(std::to_string(_value));
+  }
+
+
+  void MariaDbBulkLoader::setUInt64(int32_t columnIndex, uint64_t _value)
+  {
+    value(columnIndex).append(std::to_string(_value));
+  }
+
+
+  void MariaDbBulkLoader::setDouble(int32_t columnIndex, double _value)
+  {
+    // std::to_string is not precise enough. The shortest representation, that restores the value, is used
+    char asString[FloatConversion::BUFFER_SIZE];
+    value(columnIndex).append(asString, FloatConversion::format(_value, asString));
+  }
+
+
+  void MariaDbBulkLoader::setString(int32_t columnIndex, const SQLString& _value)
+  {
+    value(columnIndex).append(_value.c_str(), _value.length());
+  }
+
+
+  void MariaDbBulkLoader::setBytes(int32_t columnIndex, const bytes* _value)
+  {
+    if (_value == nullptr || _value->arr == nullptr) {
+      setNull(columnIndex);
+      return;
+    }
+    value(columnIndex).append(_value->arr, _value->size());
+  }
+
+  /**
+    * Encodes current row into the buffer, and sends buffered rows to the server, if the buffer is full.
+    */
+  void MariaDbBulkLoader::addRow()
+  {
+    checkClose();
+    if (columnCount == 0) {
+      if (row.empty()) {
+        throw SQLException("No column value has been set for the row", "HY000");
+      }
+      columnCount= row.size();
+    }
+
+    for (std::size_t i= 0; i < columnCount; ++i) {
+      if (i > 0) {
+        buffer.push_back('\t');
+      }
+      if (rowNull[i]) {
+        buffer.append("\\N", 2);
+      }
+      else {
+        appendEscaped(row[i].c_str(), row[i].length());
+        rowNull[i]= true;
+      }
+    }
+    buffer.push_back('\n');
+    ++bufferedRows;
+
+    if (buffer.length() >= bufferSize) {
+      flush();
+    }
+  }
+
+  /**
+    * Sends buffered rows to the server.
+    *
+    * @return number of rows affected by the load
+    */
+  int64_t MariaDbBulkLoader::flush()
+  {
+    checkClose();
+    if (bufferedRows == 0) {
+      return 0;
+    }
+    Shared::Results results(new Results());
+    {
+      std::lock_guard<std::mutex> localScopeLock(*protocol->getLock());
+      try {
+        protocol->executeLoadData(results, loadQuery, buffer.data(), buffer.length());
+      }
+      catch (SQLException&) {
+        // Rows could be partly loaded, they must not be sent again
+        buffer.clear();
+        bufferedRows= 0;
+        throw;
+      }
+    }
+    rowCount+= bufferedRows;
+    byteCount+= static_cast<int64_t>(buffer.length());
+    buffer.clear();
+    bufferedRows= 0;
+    elapsed= std::chrono::steady_clock::now() - started;
+
+    return results->getCmdInformation() ? results->getCmdInformation()->getLargeUpdateCount() : 0;
+  }
+
+  /** Sends remaining buffered rows, and closes the loader */
+  void MariaDbBulkLoader::close()
+  {
+    if (closed) {
+      return;
+    }
+    if (!protocol->isClosed()) {
+      flush();
+    }
+    closed= true;
+  }
+
+
+  bool MariaDbBulkLoader::isClosed()
+  {
+    return closed;
+  }
+
+
+  int64_t MariaDbBulkLoader::getRowCount()
+  {
+    return rowCount;
+  }
+
+
+  int64_t MariaDbBulkLoader::getByteCount()
+  {
+    return byteCount;
+  }
+
+  /* Rates are measured from the loader creation till the end of the last load */
+  double MariaDbBulkLoader::getRowsPerSecond()
+  {
+    double seconds= std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(rowCount) / seconds : 0.0;
+  }
+
+
+  double MariaDbBulkLoader::getBytesPerSecond()
+  {
+    double seconds= std::chrono::duration<double>(elapsed).count();
+    return seconds > 0 ? static_cast<double>(byteCount) / seconds : 0.0;
+  }
+
+  /**
+    * Creates bulk loader for the table.
+    *
+    * @param connection connection to load data with. Must be the connection object created by this driver
+    * @param table table name
+    * @param columns columns to load values in. All table columns are loaded, if the list is empty
+    */
+  BulkLoader* create_bulk_loader(Connection* connection, const SQLString& table, const std::list<SQLString>& columns)
+  {
+    MariaDbConnection* conn= dynamic_cast<MariaDbConnection*>(connection);
+
+    if (conn == nullptr) {
+      throw IllegalArgumentException("Connection object does not belong to this driver", "HY000");
+    }
+    if (conn->isClosed()) {
+      throw SQLException("Cannot create bulk loader on a closed connection", "08000");
+    }
+    return new MariaDbBulkLoader(conn, table, columns);
+  }
+}
+}
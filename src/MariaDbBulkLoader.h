@@ -0,0 +1,87 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _MARIADBBULKLOADER_H_
+#define _MARIADBBULKLOADER_H_
+
+#include <chrono>
+
+#include "Consts.h"
+#include "BulkLoader.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+class MariaDbConnection;
+
+class MariaDbBulkLoader : public BulkLoader
+{
+  MariaDbBulkLoader(const MariaDbBulkLoader&)= delete;
+
+  Shared::Protocol protocol;
+  SQLString loadQuery;
+  /* 0 until the first row is added, if columns were not specified */
+  std::size_t columnCount;
+  std::size_t bufferSize;
+  /* Encoded rows. Its capacity is preserved between loads */
+  std::string buffer;
+  /* Encoded values of the current row. Columns, that have not been set, are NULL */
+  std::vector<std::string> row;
+  std::vector<bool> rowNull;
+  int64_t rowCount= 0;
+  int64_t byteCount= 0;
+  int64_t bufferedRows= 0;
+  std::chrono::steady_clock::time_point started;
+  std::chrono::steady_clock::duration elapsed;
+  bool closed= false;
+
+  std::string& value(int32_t columnIndex);
+  void appendEscaped(const char* str, std::size_t length);
+  void checkClose();
+
+public:
+  MariaDbBulkLoader(MariaDbConnection* connection, const SQLString& table, const std::list<SQLString>& columns);
+  ~MariaDbBulkLoader();
+
+  void setNull(int32_t columnIndex);
+  void setBoolean(int32_t columnIndex, bool value);
+  void setInt(int32_t columnIndex, int32_t value);
+  void setUInt(int32_t columnIndex, uint32_t value);
+  void setLong(int32_t columnIndex, int64_t value);
+  void setUInt64(int32_t columnIndex, uint64_t value);
+  void setDouble(int32_t columnIndex, double value);
+  void setString(int32_t columnIndex, const SQLString& value);
+  void setBytes(int32_t columnIndex, const bytes* value);
+  void addRow();
+  int64_t flush();
+  void close();
+  bool isClosed();
+
+  int64_t getRowCount();
+  int64_t getByteCount();
+  double getRowsPerSecond();
+  double getBytesPerSecond();
+};
+
+}
+}
+#endif
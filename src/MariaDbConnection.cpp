@@ -70,9 +70,9 @@ namespace mariadb
     * @return connection object
     * @throws SQLException if any connection error occur
     */
-  MariaDbConnection* MariaDbConnection::newConnection(UrlParser &urlParser, GlobalStateInfo *globalInfo)
+  MariaDbConnection* MariaDbConnection::newConnection(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo *globalInfo)
   {
-    if (urlParser.getOptions()->pool)
+    if (urlParser->getOptions()->pool)
     {
       //return Pools::retrievePool(urlParser)->getConnection();
     }
@@ -828,11 +828,9 @@ namespace mariadb
   void MariaDbConnection::setReadOnly(bool readOnly) {
     try
     {
-      SQLString LogMsg("conn=");
-
-      LogMsg.append(std::to_string(protocol->getServerThreadId())).append(protocol->isMasterConnection() ? "(M)" : "(S)").
-            append(" - set read-only to value ").append(std::to_string(readOnly));
-      logger->debug(LogMsg);
+      LOGGER_DEBUG(logger, SQLString("conn=").append(std::to_string(protocol->getServerThreadId()))
+        .append(protocol->isMasterConnection() ? "(M)" : "(S)")
+        .append(" - set read-only to value ").append(std::to_string(readOnly)));
 
       if (readOnly) {
         stateFlag |= ConnectionState::STATE_READ_ONLY;
@@ -85,7 +85,7 @@ private:
 
 public:
   MariaDbConnection(Shared::Protocol& protocol);
-  static MariaDbConnection* newConnection(UrlParser& urlParser, GlobalStateInfo* globalInfo);
+  static MariaDbConnection* newConnection(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo* globalInfo);
   static SQLString quoteIdentifier(const SQLString& string);
   static SQLString unquoteIdentifier(SQLString& string);
   ~MariaDbConnection();
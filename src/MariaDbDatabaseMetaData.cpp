@@ -30,6 +30,7 @@
 #include "SelectResultSet.h"
 #include "ColumnDefinition.h"
 #include "util/Utils.h"
+#include "cache/MetadataCache.h"
 
 
 #define IMPORTED_KEYS_COLUMN_COUNT 14
@@ -506,8 +507,29 @@ namespace sql
   }
 
 
+  /**
+    * Executes metadata query. If metadataCacheTtl option is set, the result is looked up in the driver-global metadata
+    * cache first, and a result read from the server is stored there.
+    *
+    * @param sql metadata query
+    * @return query result
+    */
   ResultSet* MariaDbDatabaseMetaData::executeQuery(const SQLString& sql)
   {
+    Shared::Protocol& protocol= connection->getProtocol();
+    const Shared::Options& options= protocol->getOptions();
+    MetadataCache* cache= options->metadataCacheTtl > 0 ? &MetadataCache::getInstance() : nullptr;
+    SQLString server;
+    std::vector<Shared::ColumnDefinition> columns;
+    std::vector<std::vector<sql::bytes>> rows;
+
+    if (cache != nullptr) {
+      server= MetadataCache::serverKey(protocol->getHost(), protocol->getPort());
+      if (cache->get(server, protocol->getUsername(), protocol->getDatabase(), sql, columns, rows)) {
+        return createCachedResultSet(columns, rows);
+      }
+    }
+
     Unique::Statement stmt(connection->createStatement());
     // We are taking responsibility not to stream metadata queries
     stmt->setFetchSize(0);
@@ -515,6 +537,51 @@ namespace sql
     rs->setForceTableAlias();
     rs->checkOut();
     rs->setStatement(nullptr);
+
+    if (cache == nullptr) {
+      return rs;
+    }
+
+    static char emptyValue[]= "";
+    Unique::ResultSet serverResult(rs);
+    columns= rs->getColumnsInformation();
+    for (auto& column : columns) {
+      column->makeLocalCopy();
+    }
+    int32_t columnCount= static_cast<int32_t>(columns.size());
+
+    rows.reserve(rs->getDataSize());
+    while (rs->next()) {
+      rows.emplace_back();
+      std::vector<sql::bytes>& row= rows.back();
+      row.reserve(columns.size());
+
+      for (int32_t i= 1; i <= columnCount; ++i) {
+        SQLString value(rs->getString(i));
+        if (rs->wasNull()) {
+          row.emplace_back();
+        }
+        else if (value.empty()) {
+          // Not owned zero-length array, to distinguish empty string from NULL
+          row.emplace_back(emptyValue, static_cast<std::size_t>(0));
+        }
+        else {
+          row.emplace_back(value.c_str(), value.length());
+        }
+      }
+    }
+    cache->put(server, protocol->getUsername(), protocol->getDatabase(), sql, columns, rows, options->metadataCacheTtl,
+      options->metadataCacheSize);
+
+    return createCachedResultSet(columns, rows);
+  }
+
+
+  ResultSet* MariaDbDatabaseMetaData::createCachedResultSet(std::vector<Shared::ColumnDefinition>& columns,
+    std::vector<std::vector<sql::bytes>>& rows)
+  {
+    SelectResultSet* rs= SelectResultSet::create(columns, rows, connection->getProtocol().get(), ResultSet::TYPE_SCROLL_INSENSITIVE);
+    rs->setForceTableAlias();
     return rs;
   }
 
@@ -1019,8 +1086,7 @@ ResultSet* MariaDbDatabaseMetaData::getTables(const SQLString& /*catalog*/, cons
       throw std::runtime_error("table");
     }
 
-    std::unique_ptr<Statement> stmt(connection->createStatement());
-    std::unique_ptr<ResultSet> rs(stmt->executeQuery(
+    std::unique_ptr<ResultSet> rs(executeQuery(
           "SHOW CREATE TABLE "
           +MariaDbConnection::quoteIdentifier(catalog)
           +"."
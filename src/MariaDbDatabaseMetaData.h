@@ -64,6 +64,7 @@ public:
 private:
   SQLString dataTypeClause(const SQLString& fullTypeColumnName);
   ResultSet* executeQuery(const SQLString& sql);
+  ResultSet* createCachedResultSet(std::vector<Shared::ColumnDefinition>& columns, std::vector<std::vector<sql::bytes>>& rows);
   SQLString escapeQuote(const SQLString& value);
   SQLString catalogCond(const SQLString& columnName, const SQLString& catalog);
   SQLString patternCond(const SQLString& columnName, const SQLString& tableName);
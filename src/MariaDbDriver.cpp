@@ -27,6 +27,8 @@
 #include "Consts.h"
 #include "util/ClassField.h"
 #include "MariaDbDatabaseMetaData.h"
+#include "cache/MetadataCache.h"
+#include "cache/ProfileCache.h"
 
 namespace sql
 {
@@ -42,18 +44,24 @@ namespace mariadb
   }
 
 
+  void invalidate_metadata_cache(const SQLString& host, int32_t port, const SQLString& schema)
+  {
+    MetadataCache::getInstance().invalidate(host.empty() ? host : MetadataCache::serverKey(host, port), schema);
+  }
+
+
   Connection* MariaDbDriver::connect(const SQLString& url, Properties& props)
   {
-    Properties propsCopy(props);
-    UrlParser* urlParser= UrlParser::parse(url, propsCopy);
+    // Connections with the same url and properties share parsed profile
+    std::shared_ptr<UrlParser> urlParser(ProfileCache::getInstance().get(url, props));
 
-    if (urlParser == nullptr || urlParser->getHostAddresses().empty())
+    if (!urlParser || urlParser->getHostAddresses().empty())
     {
       return nullptr;
     }
     else
     {
-      return MariaDbConnection::newConnection(*urlParser, nullptr);
+      return MariaDbConnection::newConnection(urlParser, nullptr);
     }
   }
 
@@ -0,0 +1,470 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <atomic>
+
+#include "MariaDbParallelScan.h"
+#include "MariaDbConnection.h"
+#include "Protocol.h"
+#include "UrlParser.h"
+#include "ResultSetMetaData.hpp"
+#include "DatabaseMetaData.hpp"
+#include "PreparedStatement.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+  MariaDbParallelScan::MariaDbParallelScan(MariaDbConnection* _connection, const SQLString& _table, const SQLString& query,
+    const SQLString& _key, std::size_t _connectionCount)
+    : connection(_connection)
+    , urlParser(UrlParser(_connection->getProtocol()->getUrlParser()).clone())
+    , schema(_connection->getSchema())
+    , key(_key)
+    , connectionCount(_connectionCount > 0 ? _connectionCount : std::max(std::thread::hardware_concurrency(), 1U))
+    , requestedPartitions(connectionCount)
+    , connections(connectionCount)
+  {
+    // Only server side prepared statements can stream partitions. Options are the copy, that the scan owns
+    urlParser->getOptions()->useServerPrepStmts= true;
+
+    if (query.empty()) {
+      std::size_t dot= _table.find_first_of('.');
+
+      if (dot != std::string::npos) {
+        tableSchema= _table.substr(0, dot);
+        table= _table.substr(dot + 1);
+        source= MariaDbConnection::quoteIdentifier(tableSchema) + "." + MariaDbConnection::quoteIdentifier(table);
+      }
+      else {
+        tableSchema= schema;
+        table= _table;
+        source= MariaDbConnection::quoteIdentifier(table);
+      }
+    }
+    else {
+      source= "(" + query + ") parallel_scan_source";
+    }
+  }
+
+
+  MariaDbParallelScan::~MariaDbParallelScan()
+  {
+    close();
+  }
+
+
+  void MariaDbParallelScan::checkClose()
+  {
+    if (closed) {
+      throw SQLException("Cannot do an operation on a closed parallel scan", "HY000");
+    }
+  }
+
+
+  SQLString MariaDbParallelScan::findPrimaryKey()
+  {
+    std::unique_ptr<DatabaseMetaData> meta(connection->getMetaData());
+    std::unique_ptr<ResultSet> rs(meta->getPrimaryKeys(tableSchema, tableSchema, table));
+    SQLString primaryKey;
+    int32_t keyColumns= 0;
+
+    while (rs->next()) {
+      // Table name is used as a pattern in the query
+      if (rs->getString("TABLE_NAME") == table) {
+        primaryKey= rs->getString("COLUMN_NAME");
+        ++keyColumns;
+      }
+    }
+    if (keyColumns != 1) {
+      throw SQLException("Table " + table + " does not have single-column primary key, the scan key has to be specified",
+        "HY000");
+    }
+    return primaryKey;
+  }
+
+  /**
+    * Queries the key bounds, and splits the range between them into partitions. Partitions have the same number of
+    * key values, differing by one at most.
+    */
+  void MariaDbParallelScan::probe()
+  {
+    if (probed) {
+      return;
+    }
+    if (key.empty()) {
+      key= findPrimaryKey();
+    }
+    SQLString quotedKey(MariaDbConnection::quoteIdentifier(key));
+    std::unique_ptr<Statement> stmt(connection->createStatement());
+    std::unique_ptr<ResultSet> rs(stmt->executeQuery("SELECT MIN(" + quotedKey + "),MAX(" + quotedKey + ") FROM " + source));
+    std::unique_ptr<ResultSetMetaData> md(rs->getMetaData());
+
+    switch (md->getColumnType(1)) {
+    case DataType::TINYINT:
+    case DataType::SMALLINT:
+    case DataType::INTEGER:
+    case DataType::BIGINT:
+      break;
+    default:
+      throw SQLFeatureNotSupportedException("Parallel scan key " + key + " has to be of an integer type", "0A000");
+    }
+
+    lowerBounds.clear();
+    if (rs->next() && !rs->isNull(1)) {
+      minKey= rs->getLong(1);
+      maxKey= rs->getLong(2);
+
+      // Number of key values is range + 1, that does not fit uint64_t for the whole BIGINT range
+      uint64_t range= static_cast<uint64_t>(maxKey) - static_cast<uint64_t>(minKey);
+      std::size_t count= range < requestedPartitions ? static_cast<std::size_t>(range) + 1 : requestedPartitions;
+      uint64_t quotient= range / count, remainder= range % count + 1;
+
+      if (remainder == count) {
+        ++quotient;
+        remainder= 0;
+      }
+      lowerBounds.reserve(count);
+      for (std::size_t i= 0; i < count; ++i) {
+        lowerBounds.push_back(static_cast<int64_t>(static_cast<uint64_t>(minKey) + i*quotient + i*remainder/count));
+      }
+    }
+    probed= true;
+  }
+
+
+  int64_t MariaDbParallelScan::upperBound(std::size_t partition)
+  {
+    return partition + 1 < lowerBounds.size() ? lowerBounds[partition + 1] - 1 : maxKey;
+  }
+
+
+  SQLString MariaDbParallelScan::partitionQuery(bool ordered)
+  {
+    SQLString quotedKey(MariaDbConnection::quoteIdentifier(key));
+    SQLString query("SELECT * FROM " + source + " WHERE " + quotedKey + " BETWEEN ? AND ?");
+
+    if (ordered) {
+      query.append(" ORDER BY ").append(quotedKey);
+    }
+    return query;
+  }
+
+  /* Opens the connection with the index, if it's not open yet. Connections with different indexes can be opened concurrently */
+  Connection* MariaDbParallelScan::openConnection(std::size_t index)
+  {
+    if (!connections[index]) {
+      std::unique_ptr<Connection> conn(MariaDbConnection::newConnection(urlParser, nullptr));
+
+      if (!schema.empty()) {
+        conn->setSchema(schema);
+      }
+      connections[index]= std::move(conn);
+    }
+    return connections[index].get();
+  }
+
+
+  void MariaDbParallelScan::executePartition(Connection* conn, std::size_t partition, bool ordered, int32_t rows,
+    Partition& target)
+  {
+    target.stmt.reset(conn->prepareStatement(partitionQuery(ordered)));
+    target.stmt->setLong(1, lowerBounds[partition]);
+    target.stmt->setLong(2, upperBound(partition));
+    target.stmt->setFetchSize(rows);
+    target.rs.reset(target.stmt->executeQuery());
+  }
+
+  /**
+    * Reads partitions of the worker for the merged stream. The worker reads every workerCount-th partition, and
+    * starts the next one when the stream has passed its previous one. Thus the partition is read in background
+    * while preceding ones are consumed, and each connection is used by one thread at a time.
+    *
+    * @param worker index of the worker and its connection
+    */
+  void MariaDbParallelScan::readAhead(std::size_t worker)
+  {
+    const std::size_t workerCount= std::min(connectionCount, partitions.size());
+
+    for (std::size_t i= worker; i < partitions.size(); i+= workerCount) {
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        partitionChanged.wait(guard, [&]{ return stopping || current + workerCount > i; });
+        if (stopping) {
+          return;
+        }
+      }
+      if (i >= workerCount) {
+        partitions[i - workerCount].rs.reset();
+        partitions[i - workerCount].stmt.reset();
+      }
+
+      Partition& partition= partitions[i];
+      try {
+        // Without fetch size all rows are fetched in the worker's thread, otherwise the first fetchSize of them
+        executePartition(openConnection(worker), i, true, fetchSize, partition);
+      }
+      catch (...) {
+        partition.error= std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        partition.ready= true;
+      }
+      partitionChanged.notify_all();
+    }
+  }
+
+
+  void MariaDbParallelScan::startMerged()
+  {
+    probe();
+    partitions= std::vector<Partition>(lowerBounds.size());
+    current= 0;
+    started= true;
+
+    const std::size_t workerCount= std::min(connectionCount, partitions.size());
+    for (std::size_t i= 0; i < workerCount; ++i) {
+      workers.emplace_back(&MariaDbParallelScan::readAhead, this, i);
+    }
+  }
+
+
+  void MariaDbParallelScan::stopWorkers()
+  {
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      stopping= true;
+    }
+    partitionChanged.notify_all();
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    workers.clear();
+  }
+
+
+  void MariaDbParallelScan::setPartitionCount(std::size_t count)
+  {
+    checkClose();
+    if (probed) {
+      throw SQLException("Partition count cannot be changed after the scan key bounds are queried", "HY000");
+    }
+    requestedPartitions= count > 0 ? count : 1;
+  }
+
+
+  void MariaDbParallelScan::setFetchSize(int32_t rows)
+  {
+    checkClose();
+    fetchSize= rows;
+  }
+
+
+  const SQLString& MariaDbParallelScan::getKey()
+  {
+    checkClose();
+    probe();
+    return key;
+  }
+
+
+  int64_t MariaDbParallelScan::getMinKey()
+  {
+    checkClose();
+    probe();
+    return minKey;
+  }
+
+
+  int64_t MariaDbParallelScan::getMaxKey()
+  {
+    checkClose();
+    probe();
+    return maxKey;
+  }
+
+
+  std::size_t MariaDbParallelScan::getPartitionCount()
+  {
+    checkClose();
+    probe();
+    return lowerBounds.size();
+  }
+
+  /**
+    * Streams partitions on threads, each of which has its connection, and takes next partition when the previous
+    * one is processed.
+    *
+    * @param callback function called for each partition in the thread that reads it
+    * @param context passed to the callback
+    */
+  void MariaDbParallelScan::forEachPartition(PartitionCallback callback, void* context)
+  {
+    checkClose();
+    if (started) {
+      throw SQLException("Cannot scan partitions, while the merged stream of the scan is read", "HY000");
+    }
+    probe();
+
+    std::atomic<std::size_t> nextPartition(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr firstError;
+    std::mutex errorLock;
+    std::vector<std::thread> threads;
+
+    for (std::size_t worker= 0; worker < std::min(connectionCount, lowerBounds.size()); ++worker) {
+      threads.emplace_back([&, worker]() {
+        std::size_t i;
+        while (!failed && (i= nextPartition++) < lowerBounds.size()) {
+          try {
+            Partition partition;
+            executePartition(openConnection(worker), i, false, fetchSize, partition);
+            callback(i, partition.rs.get(), context);
+          }
+          catch (...) {
+            std::lock_guard<std::mutex> guard(errorLock);
+            if (!firstError) {
+              firstError= std::current_exception();
+            }
+            failed= true;
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    if (firstError) {
+      std::rethrow_exception(firstError);
+    }
+  }
+
+  /**
+    * Moves to the next row of the merged stream. Partitions are read in the key order, waiting for the background
+    * read of the partition to complete, if needed.
+    *
+    * @return true if there is the next row
+    */
+  bool MariaDbParallelScan::next()
+  {
+    checkClose();
+    if (!started) {
+      startMerged();
+    }
+
+    while (current < partitions.size()) {
+      Partition& partition= partitions[current];
+      {
+        std::unique_lock<std::mutex> guard(lock);
+        partitionChanged.wait(guard, [&]{ return partition.ready; });
+      }
+      if (partition.error) {
+        std::rethrow_exception(partition.error);
+      }
+      if (partition.rs->next()) {
+        return true;
+      }
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        ++current;
+      }
+      partitionChanged.notify_all();
+    }
+    return false;
+  }
+
+
+  ResultSet* MariaDbParallelScan::getResultSet()
+  {
+    checkClose();
+    return current < partitions.size() ? partitions[current].rs.get() : nullptr;
+  }
+
+
+  void MariaDbParallelScan::close()
+  {
+    if (closed) {
+      return;
+    }
+    stopWorkers();
+    partitions.clear();
+    connections.clear();
+    closed= true;
+  }
+
+
+  bool MariaDbParallelScan::isClosed()
+  {
+    return closed;
+  }
+
+  /**
+    * Creates parallel scan of the table.
+    *
+    * @param connection connection to query key bounds with, and which parameters are used to open connections of the
+    *                   scan. Must be the connection object created by this driver
+    * @param table table name, optionally qualified with the schema name
+    * @param connections number of connections to open, 0 for the number of hardware threads
+    * @param key key column. If empty, the primary key of the table is used
+    */
+  ParallelScan* create_parallel_scan(Connection* connection, const SQLString& table, std::size_t connections,
+    const SQLString& key)
+  {
+    MariaDbConnection* conn= dynamic_cast<MariaDbConnection*>(connection);
+
+    if (conn == nullptr) {
+      throw IllegalArgumentException("Connection object does not belong to this driver", "HY000");
+    }
+    if (conn->isClosed()) {
+      throw SQLException("Cannot create parallel scan on a closed connection", "08000");
+    }
+    return new MariaDbParallelScan(conn, table, "", key, connections);
+  }
+
+  /**
+    * Creates parallel scan of the query result.
+    *
+    * @param connection connection to query key bounds with, and which parameters are used to open connections of the
+    *                   scan. Must be the connection object created by this driver
+    * @param query query, which result is scanned
+    * @param key column of the query result to split by
+    * @param connections number of connections to open, 0 for the number of hardware threads
+    */
+  ParallelScan* create_parallel_query_scan(Connection* connection, const SQLString& query, const SQLString& key,
+    std::size_t connections)
+  {
+    MariaDbConnection* conn= dynamic_cast<MariaDbConnection*>(connection);
+
+    if (conn == nullptr) {
+      throw IllegalArgumentException("Connection object does not belong to this driver", "HY000");
+    }
+    if (conn->isClosed()) {
+      throw SQLException("Cannot create parallel scan on a closed connection", "08000");
+    }
+    if (query.empty() || key.empty()) {
+      throw IllegalArgumentException("Query and key of the parallel scan cannot be empty", "HY000");
+    }
+    return new MariaDbParallelScan(conn, "", query, key, connections);
+  }
+}
+}
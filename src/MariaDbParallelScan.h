@@ -0,0 +1,116 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _MARIADBPARALLELSCAN_H_
+#define _MARIADBPARALLELSCAN_H_
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "Consts.h"
+#include "ParallelScan.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+class MariaDbConnection;
+class UrlParser;
+
+class MariaDbParallelScan : public ParallelScan
+{
+  MariaDbParallelScan(const MariaDbParallelScan&)= delete;
+
+  struct Partition
+  {
+    std::unique_ptr<PreparedStatement> stmt;
+    std::unique_ptr<ResultSet> rs;
+    std::exception_ptr error;
+    bool ready= false;
+  };
+
+  MariaDbConnection* connection;
+  std::shared_ptr<UrlParser> urlParser;
+  /* Current schema of the connection, that connections of the scan use */
+  SQLString schema;
+  /* FROM clause of the scan and of the bounds probe */
+  SQLString source;
+  /* Unqualified table name, if the scan is of a table, to look for its primary key */
+  SQLString table;
+  SQLString tableSchema;
+  SQLString key;
+  std::size_t connectionCount;
+  std::size_t requestedPartitions;
+  int32_t fetchSize= 0;
+
+  bool probed= false;
+  int64_t minKey= 0;
+  int64_t maxKey= 0;
+  /* Lower bounds of partitions */
+  std::vector<int64_t> lowerBounds;
+
+  /* Connections opened by the scan. Each is used by one thread at a time */
+  std::vector<std::unique_ptr<Connection>> connections;
+  /* State of the merged stream */
+  std::vector<Partition> partitions;
+  std::vector<std::thread> workers;
+  std::mutex lock;
+  std::condition_variable partitionChanged;
+  std::size_t current= 0;
+  bool started= false;
+  bool stopping= false;
+  bool closed= false;
+
+  void checkClose();
+  void probe();
+  SQLString findPrimaryKey();
+  SQLString partitionQuery(bool ordered);
+  int64_t upperBound(std::size_t partition);
+  Connection* openConnection(std::size_t index);
+  void executePartition(Connection* conn, std::size_t partition, bool ordered, int32_t rows, Partition& target);
+  void readAhead(std::size_t worker);
+  void startMerged();
+  void stopWorkers();
+
+public:
+  MariaDbParallelScan(MariaDbConnection* connection, const SQLString& table, const SQLString& query, const SQLString& key,
+    std::size_t connectionCount);
+  ~MariaDbParallelScan();
+
+  void setPartitionCount(std::size_t count);
+  void setFetchSize(int32_t rows);
+  const SQLString& getKey();
+  int64_t getMinKey();
+  int64_t getMaxKey();
+  std::size_t getPartitionCount();
+  void forEachPartition(PartitionCallback callback, void* context);
+  bool next();
+  ResultSet* getResultSet();
+  void close();
+  bool isClosed();
+};
+
+}
+}
+#endif
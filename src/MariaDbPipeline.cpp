@@ -0,0 +1,288 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#include "MariaDbPipeline.h"
+#include "MariaDbConnection.h"
+#include "MariaDbStatement.h"
+#include "ClientSidePreparedStatement.h"
+#include "Protocol.h"
+#include "Results.h"
+#include "util/ClientPrepareResult.h"
+#include "util/Utils.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  MariaDbPipeline::MariaDbPipeline(MariaDbConnection* _connection, std::size_t _maxInFlight)
+    : connection(_connection)
+    , protocol(_connection->getProtocol())
+    , maxInFlight(_maxInFlight > 0 ? _maxInFlight : 1)
+  {
+  }
+
+
+  MariaDbPipeline::~MariaDbPipeline()
+  {
+    close();
+  }
+
+
+  void MariaDbPipeline::checkClose()
+  {
+    if (closed) {
+      throw SQLException("Cannot do an operation on a closed pipeline", "HY000");
+    }
+  }
+
+  /**
+    * Queues the query.
+    *
+    * @param sql query
+    * @return index of the query result
+    */
+  std::size_t MariaDbPipeline::add(const SQLString& sql)
+  {
+    checkClose();
+    Entry entry;
+    entry.sql= sql;
+    entry.stmt.reset(static_cast<MariaDbStatement*>(connection->createStatement()));
+    entries.push_back(std::move(entry));
+    return entries.size() - 1;
+  }
+
+  /**
+    * Queues execution of the prepared statement. Client-side prepared statements are sent in the pipeline as text
+    * queries, and their results are read by the statement object of the pipeline.
+    *
+    * @param pstmt prepared statement of the pipeline connection
+    * @return index of the statement result
+    */
+  std::size_t MariaDbPipeline::add(PreparedStatement* pstmt)
+  {
+    checkClose();
+    if (pstmt == nullptr || pstmt->getConnection() != connection) {
+      throw IllegalArgumentException("Prepared statement does not belong to the pipeline connection", "HY000");
+    }
+    Entry entry;
+    entry.pstmt= pstmt;
+    if (dynamic_cast<ClientSidePreparedStatement*>(pstmt) != nullptr) {
+      entry.stmt.reset(static_cast<MariaDbStatement*>(connection->createStatement()));
+    }
+    entries.push_back(std::move(entry));
+    return entries.size() - 1;
+  }
+
+  /**
+    * Executes queued statements. Consecutive queries and client-side prepared statements are pipelined, server-side
+    * prepared statements are executed between them.
+    *
+    * @throws SQLException on connection errors. Errors of statements are thrown when their results are requested
+    */
+  void MariaDbPipeline::execute()
+  {
+    checkClose();
+    errors.clear();
+    executed= true;
+
+    std::size_t begin= 0;
+    for (std::size_t i= 0; i < entries.size(); ++i) {
+      if (entries[i].stmt) {
+        continue;
+      }
+      executePipelined(begin, i);
+      try {
+        entries[i].pstmt->execute();
+      }
+      catch (SQLException& e) {
+        errors.emplace(i, e);
+      }
+      begin= i + 1;
+    }
+    executePipelined(begin, entries.size());
+  }
+
+  /**
+    * Sends entries in the range in one pipeline.
+    *
+    * @param begin index of the first entry
+    * @param end index after the last entry
+    */
+  void MariaDbPipeline::executePipelined(std::size_t begin, std::size_t end)
+  {
+    if (begin == end) {
+      return;
+    }
+    std::vector<Shared::Results> results;
+    std::vector<SQLString> queries;
+    std::vector<ClientPrepareResult*> prepareResults;
+    std::vector<std::size_t> indexes;
+    std::map<std::size_t, SQLException> pipelineErrors;
+
+    std::unique_lock<std::mutex> localScopeLock(*protocol->getLock());
+    for (std::size_t i= begin; i < end; ++i) {
+      Entry& entry= entries[i];
+      std::vector<Shared::ParameterHolder> parameters;
+      ClientPrepareResult* prepareResult= nullptr;
+
+      if (entry.pstmt != nullptr) {
+        ClientSidePreparedStatement* csps= static_cast<ClientSidePreparedStatement*>(entry.pstmt);
+        std::size_t unset= 0;
+
+        while (unset < csps->prepareResult->getParamCount() && csps->parameters[unset]) {
+          ++unset;
+        }
+        if (unset < csps->prepareResult->getParamCount()) {
+          std::string msg("Parameter at position " + std::to_string(unset + 1) + " is not set");
+          errors.emplace(i, SQLException(msg.c_str(), "07004"));
+          continue;
+        }
+        entry.sql= csps->sqlQuery;
+        parameters= csps->parameters;
+        prepareResult= csps->prepareResult.get();
+      }
+
+      entry.stmt->executeQueryPrologue(false);
+      entry.stmt->setInternalResults(
+        new Results(
+          entry.stmt.get(),
+          0,
+          false,
+          1,
+          false,
+          ResultSet::TYPE_FORWARD_ONLY,
+          ResultSet::CONCUR_READ_ONLY,
+          Statement::NO_GENERATED_KEYS,
+          protocol->getAutoIncrementIncrement(),
+          entry.sql,
+          parameters));
+      results.push_back(entry.stmt->getInternalResults());
+      queries.push_back(prepareResult != nullptr ? entry.sql : Utils::nativeSql(entry.sql, protocol.get()));
+      prepareResults.push_back(prepareResult);
+      indexes.push_back(i);
+    }
+
+    try {
+      protocol->executePipeline(results, queries, prepareResults, pipelineErrors, maxInFlight);
+    }
+    catch (SQLException&) {
+      for (std::size_t i : indexes) {
+        entries[i].stmt->executeEpilogue();
+      }
+      throw;
+    }
+
+    for (std::size_t k= 0; k < indexes.size(); ++k) {
+      Entry& entry= entries[indexes[k]];
+      auto error= pipelineErrors.find(k);
+
+      if (error == pipelineErrors.end()) {
+        results[k]->commandEnd();
+        entry.stmt->invalidateMetadataCache(entry.sql);
+      }
+      else {
+        errors.emplace(indexes[k], error->second);
+      }
+      entry.stmt->executeEpilogue();
+    }
+  }
+
+  /**
+    * Returns the executed entry, or throws the error of its execution.
+    */
+  MariaDbPipeline::Entry& MariaDbPipeline::executedEntry(std::size_t index)
+  {
+    checkClose();
+    if (!executed || index >= entries.size()) {
+      throw IllegalArgumentException("No result with index " + std::to_string(index), "HY000");
+    }
+    auto error= errors.find(index);
+    if (error != errors.end()) {
+      throw error->second;
+    }
+    return entries[index];
+  }
+
+
+  std::size_t MariaDbPipeline::size()
+  {
+    return entries.size();
+  }
+
+
+  ResultSet* MariaDbPipeline::getResultSet(std::size_t index)
+  {
+    Entry& entry= executedEntry(index);
+    return entry.stmt ? entry.stmt->getResultSet() : entry.pstmt->getResultSet();
+  }
+
+
+  int64_t MariaDbPipeline::getUpdateCount(std::size_t index)
+  {
+    Entry& entry= executedEntry(index);
+    return entry.stmt ? entry.stmt->getLargeUpdateCount() : entry.pstmt->getLargeUpdateCount();
+  }
+
+
+  void MariaDbPipeline::clear()
+  {
+    entries.clear();
+    errors.clear();
+    executed= false;
+  }
+
+
+  void MariaDbPipeline::close()
+  {
+    if (closed) {
+      return;
+    }
+    clear();
+    closed= true;
+  }
+
+
+  bool MariaDbPipeline::isClosed()
+  {
+    return closed;
+  }
+
+  /**
+    * Creates pipeline for the connection.
+    *
+    * @param connection connection to execute statements on. Must be the connection object created by this driver
+    * @param maxInFlight maximum number of statements sent, which results have not been read yet
+    */
+  Pipeline* create_pipeline(Connection* connection, std::size_t maxInFlight)
+  {
+    MariaDbConnection* conn= dynamic_cast<MariaDbConnection*>(connection);
+
+    if (conn == nullptr) {
+      throw IllegalArgumentException("Connection object does not belong to this driver", "HY000");
+    }
+    if (conn->isClosed()) {
+      throw SQLException("Cannot create pipeline on a closed connection", "08000");
+    }
+    return new MariaDbPipeline(conn, maxInFlight);
+  }
+}
+}
@@ -0,0 +1,79 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _MARIADBPIPELINE_H_
+#define _MARIADBPIPELINE_H_
+
+#include <map>
+
+#include "Consts.h"
+#include "Pipeline.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+class MariaDbConnection;
+
+class MariaDbPipeline : public Pipeline
+{
+  MariaDbPipeline(const MariaDbPipeline&)= delete;
+
+  struct Entry
+  {
+    SQLString sql;
+    /* Statement, that gets results of the query or client-side prepared statement */
+    Unique::MariaDbStatement stmt;
+    /* Prepared statement to execute. Server-side prepared statements have no stmt, and are not pipelined */
+    PreparedStatement* pstmt= nullptr;
+  };
+
+  MariaDbConnection* connection;
+  Shared::Protocol protocol;
+  std::size_t maxInFlight;
+  std::vector<Entry> entries;
+  std::map<std::size_t, SQLException> errors;
+  bool executed= false;
+  bool closed= false;
+
+  void checkClose();
+  Entry& executedEntry(std::size_t index);
+  void executePipelined(std::size_t begin, std::size_t end);
+
+public:
+  MariaDbPipeline(MariaDbConnection* connection, std::size_t maxInFlight);
+  ~MariaDbPipeline();
+
+  std::size_t add(const SQLString& sql);
+  std::size_t add(PreparedStatement* pstmt);
+  void execute();
+  std::size_t size();
+  ResultSet* getResultSet(std::size_t index);
+  int64_t getUpdateCount(std::size_t index);
+  void clear();
+  void close();
+  bool isClosed();
+};
+
+}
+}
+#endif
@@ -23,6 +23,9 @@
 #include "SqlStates.h"
 #include "ExceptionFactory.h"
 #include "util/Utils.h"
+#include "util/Metrics.h"
+#include "util/TimeoutScheduler.h"
+#include "cache/MetadataCache.h"
 #include "Results.h"
 
 namespace sql
@@ -98,36 +101,29 @@ namespace mariadb
 
   MariaDbStatement::~MariaDbStatement()
   {
+    stopTimeoutTask();
     if (results) {
       results->loadFully(true, protocol.get());
     }
   }
 
   // Part of query prolog - setup timeout timer
-  void MariaDbStatement::setTimerTask(bool /*isBatch*/)
+  void MariaDbStatement::setTimerTask(bool isBatch)
   {
-#ifdef MAYBE_IN_NEXTVERSION
-    assert(!timerTaskFuture);
-    if (!timeoutScheduler)
-    {
-      timeoutScheduler= SchedulerServiceProviderHolder::getTimeoutScheduler();
-    }
-    timerTaskFuture =
-      timeoutScheduler.schedule(
-          ()->{
-          try {
+    stopTimeoutTask();
+    timerTask= TimeoutScheduler::getInstance().schedule(
+      [this, isBatch]() {
+        try {
           isTimedout= true;
-          if (!isBatch){
-          protocol->cancelCurrentQuery();
+          if (!isBatch) {
+            protocol->cancelCurrentQuery();
           }
           protocol->interrupt();
-          }catch (std::exception& e){
-
-          }
-          },
-          queryTimeout,
-          TimeUnit::SECONDS);
-#endif
+        }
+        catch (std::exception&) {
+        }
+      },
+      std::chrono::seconds(queryTimeout));
   }
 
   /**
@@ -155,23 +151,23 @@ namespace mariadb
 
   void MariaDbStatement::stopTimeoutTask()
   {
-#ifdef MAYBE_IN_NEXTVERSION
-    if (timerTaskFuture){
-      if (!timerTaskFuture.cancel(true)){
-
-
-        try {
-          timerTaskFuture.get();
-        }catch (InterruptedException& e){
-
-          Thread.currentThread().interrupt();
-        }catch (InterruptedException& e){
+    if (timerTask) {
+      // Waits for the timer action to complete, if it is running at the moment
+      TimeoutScheduler::getInstance().cancel(timerTask);
+      timerTask.reset();
+    }
+  }
 
-        }
-      }
-      timerTaskFuture= NULL;
+  /**
+    * Drops metadata cache entries of the server, if the query may have changed the schema.
+    *
+    * @param sql executed query
+    */
+  void MariaDbStatement::invalidateMetadataCache(const SQLString& sql)
+  {
+    if (options->metadataCacheTtl > 0 && MetadataCache::isDdl(sql)) {
+      MetadataCache::getInstance().invalidate(MetadataCache::serverKey(protocol->getHost(), protocol->getPort()));
     }
-#endif
   }
 
   /**
@@ -203,7 +199,7 @@ namespace mariadb
       return exceptionFactory->raiseStatementError(connection, this)->create("Query timed out", "70100", 1317, &sqle);
     }
     MariaDBExceptionThrower sqlException= exceptionFactory->raiseStatementError(connection, this)->create(sqle);
-    logger->error("error executing query", sqlException);
+    LOGGER_ERROR(logger, "error executing query", sqlException);
 
     return sqlException;
   }
@@ -261,7 +257,7 @@ namespace mariadb
     }
 
     MariaDBExceptionThrower sqle2= exceptionFactory->raiseStatementError(connection, this)->create(*sqle.getException());
-    logger->error("error executing query", sqle2);
+    LOGGER_ERROR(logger, "error executing query", sqle2);
 
     return BatchUpdateException(sqle2.getException()->getMessage(), sqle2.getException()->getSQLState(), sqle2.getException()->getErrorCode());//, ret, &sqle2); //MAYBE_IN_NEXTVERSION
   }
@@ -278,7 +274,7 @@ namespace mariadb
    */
   bool MariaDbStatement::executeInternal(const SQLString& sql, int32_t fetchSize, int32_t autoGeneratedKeys)
   {
-    std::unique_lock<std::mutex> localScopeLock(*lock);
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*lock));
 
     try {
       std::vector<Shared::ParameterHolder> dummy;
@@ -300,6 +296,7 @@ namespace mariadb
       protocol->executeQuery(protocol->isMasterConnection(), results, getTimeoutSql(Utils::nativeSql(sql, protocol.get())));
 
       results->commandEnd();
+      invalidateMetadataCache(sql);
       executeEpilogue();
       return results->getResultSet() != nullptr;
     }
@@ -916,7 +913,7 @@ namespace mariadb
     }
     catch (SQLException& e)
     {
-      logger->error("error cancelling query", e);
+      LOGGER_ERROR(logger, "error cancelling query", e);
       if (locked) {
         lock->unlock();
       }
@@ -1096,7 +1093,7 @@ namespace mariadb
     }
     catch (SQLException& e)
     {
-      logger->debug("error skipMoreResults",e);
+      LOGGER_DEBUG(logger, "error skipMoreResults", e);
       exceptionFactory->raiseStatementError(connection, this)->create(e);
     }
   }
@@ -1303,7 +1300,7 @@ namespace mariadb
       return batchRes;
     }
 
-    std::unique_lock<std::mutex> localScopeLock(*lock);
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*lock));
     try
     {
       internalBatchExecution(size);
@@ -1331,7 +1328,7 @@ namespace mariadb
       return largeBatchRes;
     }
 
-    std::unique_lock<std::mutex> localScopeLock(*lock);
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*lock));
     try
     {
       internalBatchExecution(size);
@@ -1374,6 +1371,9 @@ namespace mariadb
           dummy));
     protocol->executeBatchStmt(protocol->isMasterConnection(),results,batchQueries);
     results->commandEnd();
+    for (auto& query : batchQueries) {
+      invalidateMetadataCache(query);
+    }
   }
 
   /**
@@ -37,6 +37,7 @@ namespace sql
 namespace mariadb
 {
 class MariaDbConnection;
+class TimeoutTask;
 
 class MariaDbStatement : public Statement
 {
@@ -44,6 +45,8 @@ class MariaDbStatement : public Statement
   static Shared::Logger logger ; /*LoggerFactory.getLogger(MariaDbStatement)*/
 
   friend class ClientSidePreparedStatement;
+  friend class ServerSidePreparedStatement;
+  friend class MariaDbPipeline;
   /* We don't want copy constructing*/
   MariaDbStatement(const MariaDbStatement& other) = delete;
 
@@ -68,16 +71,11 @@ protected:
   sql::Longs largeBatchRes;
 
 private:
-#ifdef MAYBE_IN_NEXTVERSION
-  ScheduledExecutorService timeoutScheduler;
-#endif
   bool warningsCleared= true;
   bool mustCloseOnCompletion= false;
   std::vector<SQLString> batchQueries;
-#ifdef MAYBE_IN_NEXTVERSION
-  Future<?>timerTaskFuture;
-#endif
-  bool isTimedout= false;
+  std::shared_ptr<TimeoutTask> timerTask;
+  std::atomic<bool> isTimedout{false};
   uint32_t maxFieldSize= 0;
 
 public:
@@ -95,6 +93,7 @@ private:
   MariaDBExceptionThrower handleFailoverAndTimeout(SQLException& sqle);
 public://protected:
   void executeEpilogue();
+  void invalidateMetadataCache(const SQLString& sql);
   void executeBatchEpilogue();
   MariaDBExceptionThrower executeExceptionEpilogue(SQLException& sqle);
   BatchUpdateException executeBatchExceptionEpilogue(SQLException& initialSqle, std::size_t size);
@@ -27,6 +27,7 @@
 #include "parameters/ByteArrayParameter.h"
 #include "parameters/ByteParameter.h"
 #include "parameters/DateParameter.h"
+#include "parameters/DecimalParameter.h"
 #include "parameters/DefaultParameter.h"
 #include "parameters/DoubleParameter.h"
 #include "parameters/FloatParameter.h"
@@ -21,6 +21,7 @@
 #ifndef _PROTOCOL_H_
 #define _PROTOCOL_H_
 
+#include <map>
 #include <vector>
 #include <mutex>
 
@@ -50,6 +51,7 @@ class TimeZone;
 class ServerPrepareStatementCache;
 class MariaDbStatement;
 class FutureTask;
+class SelectResultSet;
 
 class Protocol
 {
@@ -100,6 +102,9 @@ public:
   virtual bool executeBatchClient(bool mustExecuteOnMaster, Shared::Results& results, ClientPrepareResult* prepareResult,
     std::vector<std::vector<Shared::ParameterHolder>>& parametersList, bool hasLongData)=0;
   virtual void executeBatchStmt(bool mustExecuteOnMaster, Shared::Results& results, const std::vector<SQLString>& queries)= 0;
+  virtual void executePipeline(std::vector<Shared::Results>& results, const std::vector<SQLString>& queries,
+    const std::vector<ClientPrepareResult*>& prepareResults, std::map<std::size_t, SQLException>& errors,
+    std::size_t maxInFlight)= 0;
   virtual void executePreparedQuery(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results,
     std::vector<Shared::ParameterHolder>& parameters)= 0;
   virtual bool executeBatchServer(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results, const SQLString& sql,
@@ -119,6 +124,7 @@ public:
   virtual uint32_t getPatchServerVersion()=0;
   virtual bool versionGreaterOrEqual(uint32_t major, uint32_t minor, uint32_t patch) const=0;
   virtual void setLocalInfileInputStream(std::istream& inputStream)=0;
+  virtual void executeLoadData(Shared::Results& results, const SQLString& sql, const char* data, std::size_t length)=0;
   virtual int32_t getTimeout()=0;
   virtual void setTimeout(int32_t timeout)=0;
   virtual bool getPinGlobalTxToPhysicalConnection() const=0;
@@ -151,6 +157,9 @@ public:
   virtual void changeSocketTcpNoDelay(bool setTcpNoDelay)=0;
   virtual void changeSocketSoTimeout(int32_t setSoTimeout)=0;
   virtual void removeActiveStreamingResult()=0;
+  virtual void registerStoredResult(capi::MYSQL_STMT* stmt, SelectResultSet* rs)=0;
+  virtual void unregisterStoredResult(capi::MYSQL_STMT* stmt, SelectResultSet* rs)=0;
+  virtual void unregisterPrepareResult(ServerPrepareResult* serverPrepareResult)=0;
   virtual void resetStateAfterFailover( int64_t maxRows,int32_t transactionIsolationLevel, const SQLString& database,bool autocommit)= 0;
   virtual bool isServerMariaDb()=0;
   virtual void setActiveFutureTask(FutureTask* activeFutureTask)=0;
@@ -236,6 +236,12 @@ namespace mariadb
   }
 
 
+  /* Result set, that the command has returned as its only result, before commandEnd makes it current */
+  SelectResultSet* Results::getSingleResultSet() {
+    return executionResults.size() == 1 && !callableResultSet ? executionResults.front().get() : nullptr;
+  }
+
+
   ResultSet* Results::releaseResultSet() {
     given2appRs= resultSet.release();
     return (given2appRs != nullptr ? given2appRs->release() : nullptr);
@@ -85,6 +85,7 @@ protected:
 public:
   bool commandEnd();
   SelectResultSet* getResultSet();
+  SelectResultSet* getSingleResultSet();
   ResultSet* releaseResultSet();
   SelectResultSet* getCallableResultSet();
   void loadFully(bool skip, Protocol* protocol);
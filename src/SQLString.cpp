@@ -55,7 +55,13 @@ namespace sql
 
   SQLString& SQLString::operator=(const SQLString &other)
   {
-    *theString= *other.theString;
+    // Object may have been moved from, e.g. while containers shift their elements
+    if (!theString) {
+      theString.reset(new StringImp((*other.theString)->c_str(), (*other.theString)->length()));
+    }
+    else {
+      *theString= *other.theString;
+    }
     return *this;
   }
 
@@ -323,7 +329,12 @@ namespace sql
 
   SQLString & SQLString::operator=(const char * right)
   {
-    *theString= (right != nullptr ? right : "");
+    if (!theString) {
+      theString.reset(new StringImp(right != nullptr ? right : ""));
+    }
+    else {
+      *theString= (right != nullptr ? right : "");
+    }
     return *this;
   }
 
@@ -88,14 +88,16 @@ namespace mariadb
     * @param resultSetScrollType one of the following <code>ResultSet</code> constants: <code>
     *     ResultSet.TYPE_FORWARD_ONLY</code>, <code>ResultSet.TYPE_SCROLL_INSENSITIVE</code>, or
     *     <code>ResultSet.TYPE_SCROLL_SENSITIVE</code>
+    * @param rowsOwner owner of the memory, that rows only wrap. The result set keeps it alive
     */
   SelectResultSet* SelectResultSet::create(
     std::vector<Shared::ColumnDefinition>& columnInformation,
     /*std::unique_ptr<*/std::vector<std::vector<sql::bytes>>& resultSet,
     Protocol* protocol,
-    int32_t resultSetScrollType)
+    int32_t resultSetScrollType,
+    std::shared_ptr<const void> rowsOwner)
   {
-    return new capi::SelectResultSetCapi(columnInformation, resultSet, protocol, resultSetScrollType);
+    return new capi::SelectResultSetCapi(columnInformation, resultSet, protocol, resultSetScrollType, rowsOwner);
   }
 
   /**
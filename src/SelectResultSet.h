@@ -36,6 +36,7 @@
 #include "io/StandardPacketInputStream.h"
 
 #include "jdbccompat.hpp"
+#include "Decimal.hpp"
 
 
 namespace sql
@@ -47,6 +48,7 @@ class RowProtocol;
 class PacketInputStream;
 class ColumnDefinition;
 class ServerPrepareResult;
+class ResultSetExporter;
 
 namespace capi
 {
@@ -92,7 +94,8 @@ public:
     std::vector<Shared::ColumnDefinition>& columnInformation,
     /*std::unique_ptr<*/std::vector<std::vector<sql::bytes>>& resultSet,
     Protocol* protocol,
-    int32_t resultSetScrollType);
+    int32_t resultSetScrollType,
+    std::shared_ptr<const void> rowsOwner= nullptr);
 
   static ResultSet* createGeneratedData(std::vector<int64_t>& data, Protocol* protocol, bool findColumnReturnsOne);
   static SelectResultSet* createEmptyResultSet();
@@ -150,6 +153,14 @@ public:
   virtual void checkOut()= 0;
   virtual std::size_t getDataSize()=0;
   virtual bool isBinaryEncoded()=0;
+  virtual const std::vector<Shared::ColumnDefinition>& getColumnsInformation() const=0;
+  virtual Decimal getDecimal(int32_t columnIndex)=0;
+  virtual Decimal getDecimal(const SQLString& columnLabel)=0;
+  /* Passes to the exporter values of all rows following the current one. Returns number of exported rows */
+  virtual int64_t exportRows(ResultSetExporter& exporter)=0;
+  /* Appends raw values of all rows to values, and their lengths to lengths(-1 for NULLs), not changing the position.
+     Returns false, if the rows are not in the text format or not buffered, or if they take more than maxSize bytes */
+  virtual bool copyRows(std::string& values, std::vector<int64_t>& lengths, std::size_t maxSize)=0;
   ResultSet* release();
   // If we need to cache rs, that did not stream, it will not have protocol, as it's kinda not needed after fetching everything
   virtual void cacheCompleteLocally(/*Protocol**/)=0;
@@ -24,6 +24,7 @@
 #include "logger/LoggerFactory.h"
 #include "ExceptionFactory.h"
 #include "Results.h"
+#include "util/Metrics.h"
 #include "MariaDbParameterMetaData.h"
 #include "MariaDbResultSetMetaData.h"
 
@@ -118,7 +119,7 @@ namespace sql
       }
       catch (std::exception&) {
       }
-      logger->error("error preparing query", e);
+      LOGGER_ERROR(logger, "error preparing query", e);
       exceptionFactory->raiseStatementError(connection, stmt.get())->create(e).Throw();
     }
   }
@@ -168,7 +169,7 @@ namespace sql
         error.append(sql);
       }
       error.append(" - \"");
-      logger->error(error);
+      LOGGER_ERROR(logger, error);
       ExceptionFactory::INSTANCE.create(error).Throw();
     }
   }
@@ -237,7 +238,7 @@ namespace sql
 
   void ServerSidePreparedStatement::executeBatchInternal(int32_t queryParameterSize)
   {
-    std::unique_lock<std::mutex> localScopeLock(*protocol->getLock());
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*protocol->getLock()));
 
     stmt->setExecutingFlag();
 
@@ -366,7 +367,7 @@ namespace sql
     {
       if (currentParameterHolder.find(i) == currentParameterHolder.end())
       {
-        logger->error("Parameter at position " + std::to_string(i + 1) + " is not set" );
+        LOGGER_ERROR(logger, "Parameter at position " + std::to_string(i + 1) + " is not set");
         exceptionFactory->raiseStatementError(connection, stmt.get())->create("Parameter at position "+ std::to_string(i+1) + " is not set", "07004").Throw();
       }
     }
@@ -377,7 +378,7 @@ namespace sql
   {
     validParameters();
 
-    std::unique_lock<std::mutex> localScopeLock(*protocol->getLock());
+    std::unique_lock<std::mutex> localScopeLock(Metrics::lock(*protocol->getLock()));
     try {
       executeQueryPrologue(serverPrepareResult.get());
       if (stmt->getQueryTimeout() !=0) {
@@ -407,6 +408,7 @@ namespace sql
         mustExecuteOnMaster, serverPrepareResult.get(), stmt->getInternalResults(), parameterHolders);
 
       stmt->getInternalResults()->commandEnd();
+      stmt->invalidateMetadataCache(sql);
       stmt->executeEpilogue();
       return stmt->getInternalResults()->getResultSet() != nullptr;
 
@@ -453,6 +455,23 @@ namespace sql
     connection= nullptr;
   }
 
+  /**
+    * Gives the driver a hint as to the number of rows that should be fetched from the database when more rows are
+    * needed. Unlike other statement types, server-side prepared statement supports it - the result is read through
+    * the read-only cursor, <code>rows</code> rows at a time.
+    *
+    * @param rows the number of rows to fetch. 0 means the whole result is read at once
+    * @throws SQLException if the statement is closed, or <code>rows</code> is negative
+    */
+  void ServerSidePreparedStatement::setFetchSize(int32_t rows)
+  {
+    stmt->checkClose();
+    if (rows < 0) {
+      exceptionFactory->raiseStatementError(connection, stmt.get())->create("invalid fetch size").Throw();
+    }
+    stmt->fetchSize= rows;
+  }
+
   int32_t ServerSidePreparedStatement::getParameterCount() const
   {
     return parameterCount;
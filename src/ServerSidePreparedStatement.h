@@ -101,6 +101,7 @@ public:
 
 public:
   void close();
+  void setFetchSize(int32_t rows);
 
 //protected:
   int32_t getParameterCount() const;
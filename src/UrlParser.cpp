@@ -349,6 +349,10 @@ namespace mariadb
     return this->addresses;
   }
 
+  const std::vector<HostAddress>& UrlParser::getHostAddresses() const {
+    return this->addresses;
+  }
+
 
   const Shared::Options& UrlParser::getOptions() const {
     return options;
@@ -71,6 +71,7 @@ public:
   const SQLString& getDatabase() const;
   void setDatabase(const SQLString& database);
   std::vector<HostAddress>& getHostAddresses();
+  const std::vector<HostAddress>& getHostAddresses() const;
   const Shared::Options& getOptions() const;
 protected:
   void setProperties(const SQLString& urlParameters);
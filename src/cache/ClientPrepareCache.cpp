@@ -0,0 +1,107 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#include "ClientPrepareCache.h"
+#include "util/ClientPrepareResult.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  ClientPrepareCache& ClientPrepareCache::getInstance()
+  {
+    static ClientPrepareCache instance;
+    return instance;
+  }
+
+
+  std::string ClientPrepareCache::makeKey(const SQLString& sql, bool noBackslashEscapes, bool rewritable)
+  {
+    std::string key(1, static_cast<char>('0' + (noBackslashEscapes ? 1 : 0) + (rewritable ? 2 : 0)));
+    return key.append(StringImp::get(sql));
+  }
+
+  /**
+    * Returns parse result of the query. The query is parsed only if the cache does not have it yet.
+    *
+    * @param sql query text
+    * @param noBackslashEscapes escape mode
+    * @param rewritable if the query is to be parsed for batch rewriting
+    * @param maxSize maximum number of entries in the cache. 0 disables caching
+    * @return shared parse result
+    */
+  Shared::ClientPrepareResult ClientPrepareCache::get(const SQLString& sql, bool noBackslashEscapes, bool rewritable,
+    int32_t maxSize)
+  {
+    if (maxSize <= 0 || sql.length() > MAX_QUERY_LENGTH) {
+      return Shared::ClientPrepareResult(rewritable ? ClientPrepareResult::rewritableParts(sql, noBackslashEscapes) :
+        ClientPrepareResult::parameterParts(sql, noBackslashEscapes));
+    }
+
+    std::string key(makeKey(sql, noBackslashEscapes, rewritable));
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      auto it= entries.find(key);
+
+      if (it != entries.end()) {
+        lru.splice(lru.begin(), lru, it->second.lruPos);
+        return it->second.prepareResult;
+      }
+    }
+
+    Shared::ClientPrepareResult prepareResult(rewritable ? ClientPrepareResult::rewritableParts(sql, noBackslashEscapes) :
+      ClientPrepareResult::parameterParts(sql, noBackslashEscapes));
+
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    auto it= entries.find(key);
+    // Other thread has parsed the same query meanwhile
+    if (it != entries.end()) {
+      return it->second.prepareResult;
+    }
+    while (!lru.empty() && entries.size() >= static_cast<std::size_t>(maxSize)) {
+      entries.erase(lru.back());
+      lru.pop_back();
+    }
+    lru.push_front(key);
+    Entry& entry= entries[key];
+    entry.prepareResult= prepareResult;
+    entry.lruPos= lru.begin();
+
+    return prepareResult;
+  }
+
+
+  void ClientPrepareCache::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    entries.clear();
+    lru.clear();
+  }
+
+
+  std::size_t ClientPrepareCache::size()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return entries.size();
+  }
+}
+}
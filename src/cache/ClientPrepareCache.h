@@ -0,0 +1,72 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _CLIENTPREPARECACHE_H_
+#define _CLIENTPREPARECACHE_H_
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/*
+ * Driver-global cache of parsed client-side prepared statement queries. Parse results are immutable, and are shared
+ * between all statements prepared with the same query text and parsing mode.
+ */
+class ClientPrepareCache
+{
+  /* Longer queries are parsed every time - they are most probably generated and unlikely to repeat */
+  static const std::size_t MAX_QUERY_LENGTH= 16384;
+
+  struct Entry
+  {
+    Shared::ClientPrepareResult prepareResult;
+    std::list<std::string>::iterator lruPos;
+  };
+
+  std::mutex lock;
+  std::unordered_map<std::string, Entry> entries;
+  /* Most recently used key is in the front */
+  std::list<std::string> lru;
+
+  ClientPrepareCache() {}
+  ClientPrepareCache(const ClientPrepareCache&)= delete;
+  void operator=(const ClientPrepareCache&)= delete;
+
+  static std::string makeKey(const SQLString& sql, bool noBackslashEscapes, bool rewritable);
+
+public:
+  static ClientPrepareCache& getInstance();
+
+  Shared::ClientPrepareResult get(const SQLString& sql, bool noBackslashEscapes, bool rewritable, int32_t maxSize);
+  void clear();
+  std::size_t size();
+};
+
+}
+}
+#endif
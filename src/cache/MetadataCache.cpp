@@ -0,0 +1,197 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#include <cctype>
+#include <cstring>
+
+#include "MetadataCache.h"
+#include "ColumnDefinition.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  MetadataCache& MetadataCache::getInstance()
+  {
+    static MetadataCache instance;
+    return instance;
+  }
+
+
+  SQLString MetadataCache::serverKey(const SQLString& host, int32_t port)
+  {
+    SQLString key(host);
+    return key.append(':').append(std::to_string(port));
+  }
+
+
+  std::string MetadataCache::makeKey(const SQLString& server, const SQLString& user, const SQLString& schema, const SQLString& sql)
+  {
+    std::string key(StringImp::get(server));
+    key.reserve(key.length() + user.length() + schema.length() + sql.length() + 3);
+    key.append(1, '\0').append(StringImp::get(user)).append(1, '\0').append(StringImp::get(schema)).append(1, '\0');
+    return key.append(StringImp::get(sql));
+  }
+
+  /**
+    * Checks if the query is a DDL statement, that may change the schema metadata. Leading whitespaces and comments are
+    * skipped.
+    *
+    * @param sql query text
+    * @return true if the query starts with CREATE, ALTER, DROP, RENAME or TRUNCATE
+    */
+  bool MetadataCache::isDdl(const SQLString& sql)
+  {
+    static const char* ddlKeywords[]= {"CREATE", "ALTER", "DROP", "RENAME", "TRUNCATE"};
+    const std::string& query= StringImp::get(sql);
+    std::size_t pos= 0, len= query.length();
+
+    while (pos < len) {
+      if (std::isspace(static_cast<unsigned char>(query[pos]))) {
+        ++pos;
+      }
+      else if (query.compare(pos, 2, "/*") == 0) {
+        pos= query.find("*/", pos + 2);
+        if (pos == std::string::npos) {
+          return false;
+        }
+        pos+= 2;
+      }
+      else if (query[pos] == '#' || query.compare(pos, 3, "-- ") == 0) {
+        pos= query.find('\n', pos);
+        if (pos == std::string::npos) {
+          return false;
+        }
+      }
+      else {
+        break;
+      }
+    }
+
+    for (const char* keyword : ddlKeywords) {
+      std::size_t keywordLen= std::strlen(keyword), i= 0;
+
+      if (len - pos <= keywordLen) {
+        continue;
+      }
+      while (i < keywordLen && std::toupper(static_cast<unsigned char>(query[pos + i])) == keyword[i]) {
+        ++i;
+      }
+      if (i == keywordLen && !std::isalnum(static_cast<unsigned char>(query[pos + i])) && query[pos + i] != '_') {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+    * Looks up the cached result of the metadata query.
+    *
+    * @param columns - if found, gets column definitions of the result
+    * @param rows - if found, gets copy of the result rows
+    * @return true if valid entry has been found
+    */
+  bool MetadataCache::get(const SQLString& server, const SQLString& user, const SQLString& schema, const SQLString& sql,
+    std::vector<Shared::ColumnDefinition>& columns, std::vector<std::vector<sql::bytes>>& rows)
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it= entries.find(makeKey(server, user, schema, sql));
+
+    if (it == entries.end()) {
+      return false;
+    }
+    if (it->second.expires <= std::chrono::steady_clock::now()) {
+      erase(it);
+      return false;
+    }
+    lru.splice(lru.begin(), lru, it->second.lruPos);
+    columns= it->second.columns;
+    rows= it->second.rows;
+    return true;
+  }
+
+
+  void MetadataCache::put(const SQLString& server, const SQLString& user, const SQLString& schema, const SQLString& sql,
+    std::vector<Shared::ColumnDefinition>& columns, std::vector<std::vector<sql::bytes>>& rows, int32_t ttl, int32_t maxSize)
+  {
+    std::string key(makeKey(server, user, schema, sql));
+    std::lock_guard<std::mutex> guard(lock);
+    auto it= entries.find(key);
+
+    if (it != entries.end()) {
+      erase(it);
+    }
+    while (!lru.empty() && entries.size() >= static_cast<std::size_t>(maxSize)) {
+      erase(entries.find(lru.back()));
+    }
+
+    lru.push_front(key);
+    Entry& entry= entries[key];
+    entry.server= server;
+    entry.schema= schema;
+    entry.sql= sql;
+    entry.columns= columns;
+    entry.rows= rows;
+    entry.expires= std::chrono::steady_clock::now() + std::chrono::milliseconds(ttl);
+    entry.lruPos= lru.begin();
+  }
+
+
+  void MetadataCache::erase(std::unordered_map<std::string, Entry>::iterator it)
+  {
+    lru.erase(it->second.lruPos);
+    entries.erase(it);
+  }
+
+  /**
+    * Drops cached entries. Empty server or schema match all. Entries of a schema are the ones read while it was current,
+    * and the ones which query refers to it as a string literal or quoted identifier, i.e. ones for which it has been
+    * given as catalog.
+    *
+    * @param server - server in the "host:port" form
+    * @param schema - schema name
+    */
+  void MetadataCache::invalidate(const SQLString& server, const SQLString& schema)
+  {
+    std::string literal("'" + StringImp::get(schema) + "'"), identifier("`" + StringImp::get(schema) + "`");
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (auto it= entries.begin(); it != entries.end();) {
+      Entry& entry= it->second;
+      if ((server.empty() || entry.server.compare(server) == 0) &&
+        (schema.empty() || entry.schema.compare(schema) == 0 || StringImp::get(entry.sql).find(literal) != std::string::npos ||
+          StringImp::get(entry.sql).find(identifier) != std::string::npos)) {
+        lru.erase(entry.lruPos);
+        it= entries.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+  }
+
+
+  std::size_t MetadataCache::size()
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    return entries.size();
+  }
+}
+}
@@ -0,0 +1,81 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#ifndef _METADATACACHE_H_
+#define _METADATACACHE_H_
+
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/*
+ * Driver-global cache of DatabaseMetaData results. Entries are kept per server(host:port) and schema, that was current
+ * when the result was read, and expire after the TTL given at insertion. Column definitions are shared between
+ * result sets created from the same entry, rows are copied.
+ */
+class MetadataCache
+{
+  struct Entry
+  {
+    SQLString server;
+    SQLString schema;
+    SQLString sql;
+    std::vector<Shared::ColumnDefinition> columns;
+    std::vector<std::vector<sql::bytes>> rows;
+    std::chrono::steady_clock::time_point expires;
+    std::list<std::string>::iterator lruPos;
+  };
+
+  std::mutex lock;
+  std::unordered_map<std::string, Entry> entries;
+  /* Most recently used key is in the front */
+  std::list<std::string> lru;
+
+  MetadataCache() {}
+  MetadataCache(const MetadataCache&)= delete;
+  void operator=(const MetadataCache&)= delete;
+
+  static std::string makeKey(const SQLString& server, const SQLString& user, const SQLString& schema, const SQLString& sql);
+  void erase(std::unordered_map<std::string, Entry>::iterator it);
+
+public:
+  static MetadataCache& getInstance();
+  static SQLString serverKey(const SQLString& host, int32_t port);
+  static bool isDdl(const SQLString& sql);
+
+  bool get(const SQLString& server, const SQLString& user, const SQLString& schema, const SQLString& sql,
+    std::vector<Shared::ColumnDefinition>& columns, std::vector<std::vector<sql::bytes>>& rows);
+  void put(const SQLString& server, const SQLString& user, const SQLString& schema, const SQLString& sql,
+    std::vector<Shared::ColumnDefinition>& columns, std::vector<std::vector<sql::bytes>>& rows, int32_t ttl, int32_t maxSize);
+  void invalidate(const SQLString& server= "", const SQLString& schema= "");
+  std::size_t size();
+};
+
+}
+}
+#endif
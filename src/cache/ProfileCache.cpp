@@ -0,0 +1,92 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "ProfileCache.h"
+#include "UrlParser.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  ProfileCache& ProfileCache::getInstance()
+  {
+    static ProfileCache instance;
+    return instance;
+  }
+
+  /* Properties map is ordered, thus equal sets of properties give equal keys */
+  std::string ProfileCache::makeKey(const SQLString& url, const Properties& props)
+  {
+    std::string key(StringImp::get(url));
+
+    for (auto& prop : props) {
+      key.append(1, '\0').append(StringImp::get(prop.first)).append(1, '=').append(StringImp::get(prop.second));
+    }
+    return key;
+  }
+
+  /**
+    * Returns parsed connection profile for the url and properties. The url is parsed only if there is no such profile
+    * in the cache yet. The connection gets its own copy of the cached profile, so that changes of its options do not
+    * affect other connections.
+    *
+    * @param url connection url
+    * @param props connection properties
+    * @return UrlParser object of the connection, or nullptr if the url is not accepted by the driver
+    * @throws SQLException if the url or properties cannot be parsed
+    */
+  std::shared_ptr<UrlParser> ProfileCache::get(const SQLString& url, const Properties& props)
+  {
+    std::string key(makeKey(url, props));
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      auto it= profiles.find(key);
+      if (it != profiles.end()) {
+        return std::shared_ptr<UrlParser>(it->second->clone());
+      }
+    }
+
+    // Parser may change properties
+    Properties propsCopy(props);
+    std::shared_ptr<UrlParser> urlParser(UrlParser::parse(url, propsCopy));
+
+    if (!urlParser) {
+      return urlParser;
+    }
+    // Applying it here, so copies get it already applied
+    urlParser->auroraPipelineQuirks();
+
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    if (profiles.size() >= MAX_PROFILES) {
+      profiles.clear();
+    }
+    // If other thread has parsed the same profile meanwhile, its object is used
+    return std::shared_ptr<UrlParser>(profiles.emplace(key, urlParser).first->second->clone());
+  }
+
+
+  std::size_t ProfileCache::size()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    return profiles.size();
+  }
+}
+}
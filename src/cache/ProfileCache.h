@@ -0,0 +1,65 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#ifndef _PROFILECACHE_H_
+#define _PROFILECACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+class UrlParser;
+
+/*
+ * Driver-global cache of parsed connection profiles. Connections made with the same url and properties get copies of
+ * the same parsed UrlParser and Options objects. Copying is much cheaper than parsing, and each connection may change
+ * its copy.
+ */
+class ProfileCache
+{
+  /* Once reached, the cache is emptied. That is not supposed to happen with regular applications */
+  static const std::size_t MAX_PROFILES= 1024;
+
+  std::mutex lock;
+  std::unordered_map<std::string, std::shared_ptr<UrlParser>> profiles;
+
+  ProfileCache() {}
+  ProfileCache(const ProfileCache&)= delete;
+  void operator=(const ProfileCache&)= delete;
+
+  static std::string makeKey(const SQLString& url, const Properties& props);
+
+public:
+  static ProfileCache& getInstance();
+
+  std::shared_ptr<UrlParser> get(const SQLString& url, const Properties& props);
+  std::size_t size();
+};
+
+}
+}
+#endif
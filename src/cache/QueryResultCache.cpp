@@ -0,0 +1,508 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <cctype>
+
+#include "QueryResultCache.h"
+
+#include "SelectResultSet.h"
+#include "com/capi/ColumnDefinitionCapi.h"
+#include "util/Utils.h"
+#include "ResultCache.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace
+{
+  /* Kind is 'w' for words and numbers, 'i' for quoted identifiers, 's' for string literals, or the punctuation char.
+     Words and identifiers are lowercased */
+  struct Token
+  {
+    std::string text;
+    char kind;
+  };
+
+
+  void tokenize(const std::string& sql, std::vector<Token>& tokens)
+  {
+    std::size_t i= Utils::skipCommentsAndBlanks(sql);
+
+    while (i < sql.length()) {
+      char c= sql[i];
+
+      if (c == '\'' || c == '"') {
+        std::size_t j= i + 1;
+        while (j < sql.length() && sql[j] != c) {
+          j+= (sql[j] == '\\' ? 2 : 1);
+        }
+        tokens.push_back({std::string(), 's'});
+        i= j + 1;
+      }
+      else if (c == '`') {
+        std::size_t j= sql.find('`', i + 1);
+        if (j == std::string::npos) {
+          j= sql.length();
+        }
+        tokens.push_back({sql.substr(i + 1, j - i - 1), 'i'});
+        i= j + 1;
+      }
+      else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$' || (c & 0x80) != 0) {
+        std::size_t j= i;
+        while (j < sql.length() && (std::isalnum(static_cast<unsigned char>(sql[j])) || sql[j] == '_' || sql[j] == '$'
+          || (sql[j] & 0x80) != 0)) {
+          ++j;
+        }
+        tokens.push_back({sql.substr(i, j - i), 'w'});
+        i= j;
+      }
+      else {
+        tokens.push_back({std::string(1, c), c});
+        ++i;
+      }
+      if (tokens.back().kind == 'w' || tokens.back().kind == 'i') {
+        std::transform(tokens.back().text.begin(), tokens.back().text.end(), tokens.back().text.begin(),
+          [](unsigned char car) { return static_cast<char>(std::tolower(car)); });
+      }
+      i= Utils::skipCommentsAndBlanks(sql, std::min(i, sql.length()));
+    }
+  }
+
+
+  bool isWord(const std::vector<Token>& tokens, std::size_t i, const char* word)
+  {
+    return i < tokens.size() && tokens[i].kind == 'w' && tokens[i].text.compare(word) == 0;
+  }
+
+
+  bool isOneOf(const std::vector<Token>& tokens, std::size_t i, std::initializer_list<const char*> words)
+  {
+    for (auto word : words) {
+      if (isWord(tokens, i, word)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+
+  bool isName(const std::vector<Token>& tokens, std::size_t i)
+  {
+    return i < tokens.size() && (tokens[i].kind == 'w' || tokens[i].kind == 'i');
+  }
+
+
+  const std::initializer_list<const char*> joinWords{"join", "inner", "left", "right", "cross", "natural", "straight_join"};
+
+  /* Words, that may follow table name, and thus are not its alias */
+  bool isClauseWord(const std::vector<Token>& tokens, std::size_t i)
+  {
+    return isOneOf(tokens, i, joinWords) || isOneOf(tokens, i, {"where", "on", "using", "group", "order", "limit",
+      "having", "union", "except", "intersect", "window", "for", "lock", "into", "partition", "use", "ignore", "force",
+      "procedure", "set", "values", "select", "value", "returning", "offset", "fetch"});
+  }
+
+  /* Position of the statement itself, if it's prefixed with SET STATEMENT ... FOR */
+  std::size_t statementStart(const std::vector<Token>& tokens)
+  {
+    if (isWord(tokens, 0, "set") && isWord(tokens, 1, "statement")) {
+      for (std::size_t i= 2; i < tokens.size(); ++i) {
+        if (isWord(tokens, i, "for")) {
+          return i + 1;
+        }
+      }
+    }
+    return 0;
+  }
+
+
+  bool isMultiStatement(const std::vector<Token>& tokens)
+  {
+    for (std::size_t i= 0; i + 1 < tokens.size(); ++i) {
+      if (tokens[i].kind == ';') {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Reads [schema.]table name at the position to tables. Returns position after it, or npos if there is no name */
+  std::size_t readTable(const std::vector<Token>& tokens, std::size_t i, const std::string& schema,
+    std::vector<std::string>& tables)
+  {
+    if (!isName(tokens, i) || isClauseWord(tokens, i)) {
+      return std::string::npos;
+    }
+    if (i + 2 < tokens.size() && tokens[i + 1].kind == '.' && isName(tokens, i + 2)) {
+      tables.push_back(tokens[i].text + "." + tokens[i + 2].text);
+      return i + 3;
+    }
+    tables.push_back(schema + "." + tokens[i].text);
+    return i + 1;
+  }
+
+
+  std::size_t skipAlias(const std::vector<Token>& tokens, std::size_t i)
+  {
+    if (isWord(tokens, i, "as")) {
+      return i + 2;
+    }
+    return (isName(tokens, i) && !isClauseWord(tokens, i)) ? i + 1 : i;
+  }
+
+
+  std::string lowercase(const SQLString& str)
+  {
+    std::string result(StringImp::get(str));
+    std::transform(result.begin(), result.end(), result.begin(),
+      [](unsigned char car) { return static_cast<char>(std::tolower(car)); });
+    return result;
+  }
+}
+
+  QueryResultCache::QueryResultCache() : used(false), generation(0)
+  {
+  }
+
+
+  QueryResultCache& QueryResultCache::getInstance()
+  {
+    static QueryResultCache instance;
+    return instance;
+  }
+
+  /**
+    * Builds the cache key. Blanks of the query outside of literals are collapsed, so that differently formatted same
+    * queries share the entry
+    */
+  std::string QueryResultCache::makeKey(const SQLString& host, int32_t port, const SQLString& user,
+    const SQLString& schema, int64_t maxRows, const SQLString& sql)
+  {
+    std::string key(StringImp::get(host));
+
+    key.append(1, ':').append(std::to_string(port)).append(1, '\0').append(StringImp::get(user));
+    key.append(1, '\0').append(StringImp::get(schema)).append(1, '\0').append(std::to_string(maxRows));
+    key.append(1, '\0');
+
+    const std::string& query= StringImp::get(sql);
+    char quote= '\0';
+    bool blank= true;
+
+    for (std::size_t i= 0; i < query.length(); ++i) {
+      char c= query[i];
+
+      if (quote != '\0') {
+        key.append(1, c);
+        if (c == '\\' && quote != '`' && i + 1 < query.length()) {
+          key.append(1, query[++i]);
+        }
+        else if (c == quote) {
+          quote= '\0';
+        }
+      }
+      else if (std::isspace(static_cast<unsigned char>(c))) {
+        blank= true;
+      }
+      else {
+        if (blank && key.back() != '\0') {
+          key.append(1, ' ');
+        }
+        blank= false;
+        if (c == '\'' || c == '"' || c == '`') {
+          quote= c;
+        }
+        key.append(1, c);
+      }
+    }
+    return key;
+  }
+
+  /**
+    * Checks if the query is a single SELECT, that may be cached, i.e. does not lock rows, does not assign variables
+    * and does not call functions, that return different values on each call.
+    *
+    * @param sql - query
+    * @param schema - default schema of the connection
+    * @param tables - gets "schema.table" names of tables the query reads
+    * @return true if the result of the query may be cached
+    */
+  bool QueryResultCache::isCacheable(const SQLString& sql, const SQLString& schema, std::vector<std::string>& tables)
+  {
+    std::vector<Token> tokens;
+    tokenize(StringImp::get(sql), tokens);
+
+    std::size_t start= statementStart(tokens);
+    if (!isOneOf(tokens, start, {"select", "with"}) || isMultiStatement(tokens)) {
+      return false;
+    }
+    const std::string defaultSchema(lowercase(schema));
+
+    for (std::size_t i= start; i < tokens.size(); ++i) {
+      if (tokens[i].kind == '@' || isOneOf(tokens, i, {"into", "update", "lock", "share", "rand", "uuid", "uuid_short",
+        "now", "sysdate", "curdate", "curtime", "current_date", "current_time", "current_timestamp", "localtime",
+        "localtimestamp", "unix_timestamp", "utc_date", "utc_time", "utc_timestamp", "connection_id", "last_insert_id",
+        "found_rows", "row_count", "nextval", "lastval", "setval", "sleep", "get_lock", "is_free_lock",
+        "is_used_lock", "release_lock", "benchmark"})) {
+        return false;
+      }
+      if (isOneOf(tokens, i, {"from", "join", "straight_join"})) {
+        std::size_t next= i + 1;
+        while ((next= readTable(tokens, next, defaultSchema, tables)) != std::string::npos) {
+          next= skipAlias(tokens, next);
+          if (next >= tokens.size() || tokens[next].kind != ',') {
+            break;
+          }
+          ++next;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+    * Checks if the statement may change data. Tables it changes are not looked for - triggers, foreign key actions,
+    * views and stored routines may change other tables, than the statement names.
+    *
+    * @param sql - statement
+    * @return true, unless the statement is known to not change data
+    */
+  bool QueryResultCache::isWrite(const SQLString& sql)
+  {
+    std::vector<Token> tokens;
+    tokenize(StringImp::get(sql), tokens);
+
+    std::size_t i= statementStart(tokens);
+    if (i >= tokens.size()) {
+      return false;
+    }
+    if (isMultiStatement(tokens)) {
+      return true;
+    }
+    // Writes of stored functions, that SELECT calls, are not recognized
+    return !(tokens[i].kind == '(' || isOneOf(tokens, i, {"select", "with", "show", "desc", "describe", "explain",
+      "set", "use", "begin", "start", "commit", "rollback", "savepoint", "release", "xa", "help"}));
+  }
+
+  /**
+    * Creates entry with copy of the result set rows and columns.
+    *
+    * @param rs - the result set, that has just been read
+    * @param tables - names of tables the query reads. Original tables of columns are added to them
+    * @param maxSize - maximum size of the values
+    * @return the entry, or nullptr if the result cannot be cached
+    */
+  std::shared_ptr<QueryResultCache::Entry> QueryResultCache::createEntry(SelectResultSet* rs,
+    std::vector<std::string>& tables, std::size_t maxSize)
+  {
+    std::shared_ptr<Entry> entry(new Entry());
+    std::vector<int64_t> lengths;
+
+    if (!rs->copyRows(entry->values, lengths, maxSize)) {
+      return nullptr;
+    }
+    for (auto& column : rs->getColumnsInformation()) {
+      // Metadata of the result set belongs to the connector/c result, and the copy has to have its own
+      Shared::ColumnDefinition copy(new capi::ColumnDefinitionCapi(*static_cast<capi::ColumnDefinitionCapi*>(column.get())));
+      copy->makeLocalCopy();
+      entry->columns.push_back(copy);
+
+      if (!column->getOriginalTable().empty()) {
+        tables.push_back(lowercase(column->getDatabase()) + "." + lowercase(column->getOriginalTable()));
+      }
+    }
+    std::sort(tables.begin(), tables.end());
+    tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+    entry->tables.swap(tables);
+
+    std::size_t columnCount= entry->columns.size(), offset= 0;
+    char* values= &entry->values[0];
+
+    if (columnCount == 0) {
+      return nullptr;
+    }
+    entry->rows.reserve(lengths.size() / columnCount);
+    for (std::size_t i= 0; i < lengths.size(); ++i) {
+      if (i % columnCount == 0) {
+        entry->rows.emplace_back();
+        entry->rows.back().reserve(columnCount);
+      }
+      if (lengths[i] < 0) {
+        entry->rows.back().emplace_back();
+      }
+      else {
+        // Wraps the value without copying
+        entry->rows.back().emplace_back(values + offset, static_cast<std::size_t>(lengths[i]));
+        offset+= static_cast<std::size_t>(lengths[i]);
+      }
+    }
+    return entry;
+  }
+
+  /**
+    * Looks up the result cached for the key.
+    *
+    * @param key - key built with makeKey
+    * @return the entry, or nullptr if there is no valid entry
+    */
+  std::shared_ptr<const QueryResultCache::Entry> QueryResultCache::get(const std::string& key)
+  {
+    used.store(true);
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    auto it= entries.find(key);
+
+    if (it == entries.end()) {
+      return nullptr;
+    }
+    if (it->second.expires <= std::chrono::steady_clock::now()) {
+      remove(it);
+      return nullptr;
+    }
+    lru.splice(lru.begin(), lru, it->second.lruPosition);
+    return it->second.entry;
+  }
+
+  /**
+    * Stores the result, evicting least recently used entries, if the cache is over the size limit.
+    *
+    * @param key - key built with makeKey
+    * @param entry - the result
+    * @param readGeneration - generation of the cache before the query was executed. If anything has been invalidated
+    *                         since then, the result is not stored
+    * @param ttl - time in milliseconds, during which the entry is valid
+    * @param maxSize - limit of the total size of entries
+    */
+  void QueryResultCache::put(const std::string& key, std::shared_ptr<const Entry> entry, uint64_t readGeneration,
+    int32_t ttl, std::size_t maxSize)
+  {
+    if (ttl <= 0 || !entry) {
+      return;
+    }
+    std::size_t size= key.length() + entry->values.length()
+      + entry->rows.size()*(sizeof(std::vector<sql::bytes>) + entry->columns.size()*sizeof(sql::bytes));
+    if (size > maxSize) {
+      return;
+    }
+    std::lock_guard<std::mutex> localScopeLock(lock);
+
+    if (readGeneration != generation.load()) {
+      return;
+    }
+    auto it= entries.find(key);
+    if (it != entries.end()) {
+      remove(it);
+    }
+    while (totalSize + size > maxSize && !lru.empty()) {
+      remove(entries.find(lru.back()));
+    }
+    lru.push_front(key);
+
+    Slot& slot= entries[key];
+    slot.entry= entry;
+    slot.size= size;
+    slot.expires= std::chrono::steady_clock::now() + std::chrono::milliseconds(ttl);
+    slot.lruPosition= lru.begin();
+    totalSize+= size;
+
+    for (auto& table : entry->tables) {
+      keysByTable[table].insert(key);
+    }
+  }
+
+  /* The caller holds the lock */
+  void QueryResultCache::remove(std::unordered_map<std::string, Slot>::iterator it)
+  {
+    for (auto& table : it->second.entry->tables) {
+      auto keys= keysByTable.find(table);
+      if (keys != keysByTable.end()) {
+        keys->second.erase(it->first);
+        if (keys->second.empty()) {
+          keysByTable.erase(keys);
+        }
+      }
+    }
+    lru.erase(it->second.lruPosition);
+    totalSize-= it->second.size;
+    entries.erase(it);
+  }
+
+  /**
+    * Drops results of queries, that read the table.
+    *
+    * @param table - table name. If it's not qualified with the schema name, the table is matched in all schemas
+    */
+  void QueryResultCache::invalidate(const SQLString& table)
+  {
+    std::string name(lowercase(table));
+    name.erase(std::remove(name.begin(), name.end(), '`'), name.end());
+
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    ++generation;
+
+    std::vector<std::string> keys;
+    if (name.find('.') != std::string::npos) {
+      auto it= keysByTable.find(name);
+      if (it != keysByTable.end()) {
+        keys.assign(it->second.begin(), it->second.end());
+      }
+    }
+    else {
+      name.insert(0, 1, '.');
+      for (auto& it : keysByTable) {
+        if (it.first.length() >= name.length()
+          && it.first.compare(it.first.length() - name.length(), name.length(), name) == 0) {
+          keys.insert(keys.end(), it.second.begin(), it.second.end());
+        }
+      }
+    }
+    for (auto& key : keys) {
+      auto it= entries.find(key);
+      if (it != entries.end()) {
+        remove(it);
+      }
+    }
+  }
+
+
+  void QueryResultCache::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    ++generation;
+    entries.clear();
+    keysByTable.clear();
+    lru.clear();
+    totalSize= 0;
+  }
+
+
+  void invalidate_result_cache(const SQLString& table)
+  {
+    QueryResultCache::getInstance().invalidate(table);
+  }
+
+
+  void clear_result_cache()
+  {
+    QueryResultCache::getInstance().clear();
+  }
+}
+}
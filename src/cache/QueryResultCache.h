@@ -0,0 +1,106 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _QUERYRESULTCACHE_H_
+#define _QUERYRESULTCACHE_H_
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+class SelectResultSet;
+
+/*
+ * Driver-global cache of SELECT query results. Entries are kept per server, user, default schema, sql_select_limit
+ * and the query text with parameter values, and are valid during the time-to-live given by the connection that has
+ * read them. Entries are tagged with "schema.table" names of tables the query reads, so that they can be dropped,
+ * when the table is written, or explicitly by the application. The cache is limited by the total size of entries,
+ * and least recently used entries are evicted first.
+ */
+class QueryResultCache
+{
+public:
+  /* Cached result. It's immutable once created, and result sets built from it only wrap its values */
+  struct Entry
+  {
+    std::vector<Shared::ColumnDefinition> columns;
+    std::string values;
+    std::vector<std::vector<sql::bytes>> rows;
+    std::vector<std::string> tables;
+  };
+
+private:
+  struct Slot
+  {
+    std::shared_ptr<const Entry> entry;
+    std::size_t size;
+    std::chrono::steady_clock::time_point expires;
+    std::list<std::string>::iterator lruPosition;
+  };
+
+  std::mutex lock;
+  std::unordered_map<std::string, Slot> entries;
+  /* Keys of entries by the table they read */
+  std::unordered_map<std::string, std::set<std::string>> keysByTable;
+  /* Keys, most recently used first */
+  std::list<std::string> lru;
+  std::size_t totalSize= 0;
+  /* Set by the first lookup. Until then writes do not need to invalidate anything */
+  std::atomic<bool> used;
+  /* Incremented by every invalidation. Result read before that may be outdated, and is not cached */
+  std::atomic<uint64_t> generation;
+
+  QueryResultCache();
+  QueryResultCache(const QueryResultCache&)= delete;
+  void operator=(const QueryResultCache&)= delete;
+
+  void remove(std::unordered_map<std::string, Slot>::iterator it);
+
+public:
+  static QueryResultCache& getInstance();
+  static std::string makeKey(const SQLString& host, int32_t port, const SQLString& user, const SQLString& schema,
+    int64_t maxRows, const SQLString& sql);
+  static bool isCacheable(const SQLString& sql, const SQLString& schema, std::vector<std::string>& tables);
+  static bool isWrite(const SQLString& sql);
+  static std::shared_ptr<Entry> createEntry(SelectResultSet* rs, std::vector<std::string>& tables, std::size_t maxSize);
+
+  bool isUsed() const { return used.load(); }
+  uint64_t getGeneration() const { return generation.load(); }
+  std::shared_ptr<const Entry> get(const std::string& key);
+  void put(const std::string& key, std::shared_ptr<const Entry> entry, uint64_t readGeneration, int32_t ttl,
+    std::size_t maxSize);
+  void invalidate(const SQLString& table);
+  void clear();
+};
+
+}
+}
+#endif
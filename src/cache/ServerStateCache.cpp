@@ -0,0 +1,95 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#include "ServerStateCache.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  ServerStateCache& ServerStateCache::getInstance()
+  {
+    static ServerStateCache instance;
+    return instance;
+  }
+
+
+  std::string ServerStateCache::makeKey(const SQLString& host, int32_t port, const SQLString& user,
+    const SQLString& sessionVariables)
+  {
+    std::string key(StringImp::get(host));
+
+    key.append(1, ':').append(std::to_string(port)).append(1, '\0').append(StringImp::get(user));
+    key.append(1, '\0').append(StringImp::get(sessionVariables));
+    return key;
+  }
+
+  /**
+    * Looks up server variables cached for the key.
+    *
+    * @param key - key built with makeKey
+    * @param serverData - if found, gets copy of the cached variables
+    * @return true if valid entry has been found
+    */
+  bool ServerStateCache::get(const std::string& key, std::map<SQLString, SQLString>& serverData)
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    auto it= entries.find(key);
+
+    if (it == entries.end()) {
+      return false;
+    }
+    if (it->second.expires <= std::chrono::steady_clock::now()) {
+      entries.erase(it);
+      return false;
+    }
+    serverData= it->second.serverData;
+    return true;
+  }
+
+  /**
+    * Stores server variables read by the connection.
+    *
+    * @param key - key built with makeKey
+    * @param serverData - variables to cache
+    * @param ttl - time in milliseconds, during which the entry is valid
+    */
+  void ServerStateCache::put(const std::string& key, const std::map<SQLString, SQLString>& serverData, int32_t ttl)
+  {
+    if (ttl <= 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    Entry& entry= entries[key];
+
+    entry.serverData= serverData;
+    entry.expires= std::chrono::steady_clock::now() + std::chrono::milliseconds(ttl);
+  }
+
+
+  void ServerStateCache::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    entries.clear();
+  }
+}
+}
@@ -0,0 +1,68 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _SERVERSTATECACHE_H_
+#define _SERVERSTATECACHE_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "Consts.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/*
+ * Driver-global cache of server variables, that connection reads right after it is established. Entries are kept per
+ * host, port, user and session variables, since the latter may change values of interest. Each entry is valid only
+ * during the time-to-live given by the connection that has read it.
+ */
+class ServerStateCache
+{
+  struct Entry
+  {
+    std::map<SQLString, SQLString> serverData;
+    std::chrono::steady_clock::time_point expires;
+  };
+
+  std::mutex lock;
+  std::unordered_map<std::string, Entry> entries;
+
+  ServerStateCache() {}
+  ServerStateCache(const ServerStateCache&)= delete;
+  void operator=(const ServerStateCache&)= delete;
+
+public:
+  static ServerStateCache& getInstance();
+  static std::string makeKey(const SQLString& host, int32_t port, const SQLString& user, const SQLString& sessionVariables);
+
+  bool get(const std::string& key, std::map<SQLString, SQLString>& serverData);
+  void put(const std::string& key, const std::map<SQLString, SQLString>& serverData, int32_t ttl);
+  void clear();
+};
+
+}
+}
+#endif
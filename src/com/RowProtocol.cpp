@@ -21,6 +21,7 @@
 #include "RowProtocol.h"
 
 #include "ColumnDefinition.h"
+#include "util/FloatConversion.h"
 
 namespace sql
 {
@@ -188,17 +189,9 @@ namespace mariadb
 
   long double RowProtocol::stringToDouble(const char* str, uint32_t len)
   {
-    char *end= nullptr;
-    long double result= std::strtod(str, &end);
-    /* Noramlly it should be always NULL-terminated, and if we read past the end - that could already have ended up badly.
-     * but leaving in place this paranoid branch with old code
-     */
-    if (end - str > len) {
-      std::istringstream convStream(std::string(str, len));
-      std::locale C("C");
-      convStream.imbue(C);
-      convStream >> result;
-    }
+    // Like strtod, returns 0 if the string doesn't start with a number
+    double result= 0;
+    FloatConversion::parse(str, len, result);
     return result;
   }
 
@@ -386,19 +379,25 @@ namespace mariadb
   void RowProtocol::rangeCheck(const sql::SQLString& className, int64_t minValue, int64_t maxValue, int64_t value, ColumnDefinition* columnInfo)
   {
     if ((value < 0 && !columnInfo->isSigned() && !columnInfo->isBinary()) || value < minValue || value > maxValue) {
-      throw SQLException(
-        "Out of range value for column '"
-        + columnInfo->getName()
-        + "' : value "
-        + std::to_string(value)
-        + " is not in "
-        + className
-        + " range",
-        "22003",
-        1264);
+      throwOutOfRange(columnInfo, std::to_string(value), className.c_str());
     }
   }
 
+
+  void RowProtocol::throwOutOfRange(ColumnDefinition* columnInfo, const SQLString& value, const char* className)
+  {
+    throw SQLException(
+      "Out of range value for column '"
+      + columnInfo->getName()
+      + "' : value "
+      + value
+      + " is not in "
+      + className
+      + " range",
+      "22003",
+      1264);
+  }
+
   int32_t RowProtocol::extractNanos(const SQLString& timestring)
   {
     size_t index= timestring.find_first_of('.');
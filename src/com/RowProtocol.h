@@ -22,8 +22,10 @@
 #define _ROWPROTOCOL_H_
 
 #include <iostream>
+#include <limits>
 
 #include "Consts.h"
+#include "Decimal.hpp"
 
 namespace sql
 {
@@ -71,6 +73,22 @@ bool needsBinaryConversion(ColumnDefinition* columnInfo);
 class RowProtocol  {
 
 public:
+  /* Converts the current field of the row, that has to be not NULL, to T */
+  template <typename T> using Decoder= T (*)(RowProtocol* row, ColumnDefinition* columnInfo);
+
+  /* Numeric conversions specialised for the column type and signedness. nullptr means the generic conversion */
+  struct ColumnDecoders
+  {
+    Decoder<int32_t>     toInt= nullptr;
+    Decoder<int64_t>     toLong= nullptr;
+    Decoder<uint64_t>    toULong= nullptr;
+    Decoder<float>       toFloat= nullptr;
+    Decoder<long double> toDouble= nullptr;
+  };
+
+  template <typename T> struct TypeName;
+
+
   static int32_t BIT_LAST_FIELD_NOT_NULL ; /*0b000000*/
   static int32_t BIT_LAST_FIELD_NULL ; /*0b000001*/
   static int32_t BIT_LAST_ZERO_DATE ; /*0b000010*/
@@ -123,12 +141,16 @@ public:
   virtual std::unique_ptr<Time>  getInternalTime(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr)=0;
   virtual std::unique_ptr<Timestamp> getInternalTimestamp(ColumnDefinition* columnInfo, Calendar* userCalendar=nullptr, TimeZone* timeZone=nullptr)=0;
   virtual std::unique_ptr<SQLString> getInternalString(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr)=0;
+  /* Positions on the column, if its value can be read in parts without fetching all of it first. Otherwise returns nullptr,
+     and the caller should use setPosition and fieldBuf */
+  virtual std::unique_ptr<std::streambuf> getInternalStreamBuffer(int32_t newIndex)=0;
   virtual int32_t getInternalInt(ColumnDefinition* columnInfo)=0;
   virtual int64_t getInternalLong(ColumnDefinition* columnInfo)=0;
   virtual uint64_t getInternalULong(ColumnDefinition* columnInfo)=0;
   virtual float getInternalFloat(ColumnDefinition* columnInfo)=0;
   virtual long double getInternalDouble(ColumnDefinition* columnInfo)=0;
   virtual std::unique_ptr<BigDecimal> getInternalBigDecimal(ColumnDefinition* columnInfo)=0;
+  virtual Decimal getInternalDecimal(ColumnDefinition* columnInfo)=0;
 
   virtual bool getInternalBoolean(ColumnDefinition* columnInfo)=0;
   virtual int8_t getInternalByte(ColumnDefinition* columnInfo)=0;
@@ -136,10 +158,20 @@ public:
   virtual SQLString getInternalTimeString(ColumnDefinition* columnInfo)=0;
 
   virtual bool isBinaryEncoded()=0;
+  /* Chooses decoders for each column of the result. Has to be called once columns are known, and before rows are read */
+  virtual void buildDecoderPlan(const std::vector<Shared::ColumnDefinition>& columns)=0;
   virtual void cacheCurrentRow(std::vector<sql::bytes>& rowData, std::size_t columnCount)=0;
   bool lastValueWasNull();
 
 protected:
+  std::vector<ColumnDecoders> decoderPlan;
+
+  template <typename T>
+  Decoder<T> decoder(Decoder<T> ColumnDecoders::*target) const
+  {
+    return static_cast<std::size_t>(index) < decoderPlan.size() ? decoderPlan[index].*target : nullptr;
+  }
+
   template<typename T>
   T parseBinaryAsInteger(ColumnDefinition* columnInfo);
   SQLString zeroFillingIfNeeded(const SQLString& value, ColumnDefinition* columnInformation);
@@ -152,6 +184,20 @@ protected:
 
 public:
   void rangeCheck(const sql::SQLString& className,int64_t minValue, int64_t maxValue, int64_t value, ColumnDefinition* columnInfo);
+  static void throwOutOfRange(ColumnDefinition* columnInfo, const SQLString& value, const char* className);
+
+  template <typename T>
+  static bool fitsInto(int64_t value)
+  {
+    return value < 0 ? value >= static_cast<int64_t>(std::numeric_limits<T>::min())
+                     : static_cast<uint64_t>(value) <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+  }
+
+  template <typename T>
+  static bool fitsInto(uint64_t value)
+  {
+    return value <= static_cast<uint64_t>(std::numeric_limits<T>::max());
+  }
 
 protected:
   int32_t extractNanos(const SQLString& timestring);
@@ -159,6 +205,10 @@ protected:
 public:
   bool wasNull();
   };
+
+template <> struct RowProtocol::TypeName<int32_t>  { static const char* get() { return "int32_t"; } };
+template <> struct RowProtocol::TypeName<int64_t>  { static const char* get() { return "int64_t"; } };
+template <> struct RowProtocol::TypeName<uint64_t> { static const char* get() { return "uint64_t"; } };
 }
 }
 #endif
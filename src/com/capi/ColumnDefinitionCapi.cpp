@@ -71,7 +71,8 @@ namespace capi
     metadata(other.metadata),
     owned(other.owned),
     type(other.type),
-    length(other.length)
+    length(other.length),
+    names(other.names)
   {
   }
 
@@ -87,21 +88,34 @@ namespace capi
   {
     if (ownshipPassed) {
       owned.reset(_metadata);
+      // Names of the passed structure may belong to the caller
+      getNames().assignTo(_metadata);
     }
   }
 
 
-  SQLString ColumnDefinitionCapi::getDatabase() const {
-    return std::string(metadata->db, metadata->db_length);
+  const FieldNames& ColumnDefinitionCapi::getNames() const
+  {
+    std::call_once(namesInit, [this]() {
+      if (!names) {
+        names.reset(new FieldNames(metadata));
+      }
+    });
+    return *names;
   }
 
 
-  SQLString ColumnDefinitionCapi::getTable() const {
-    return metadata->table;
+  const SQLString& ColumnDefinitionCapi::getDatabase() const {
+    return getNames().db;
   }
 
-  SQLString ColumnDefinitionCapi::getOriginalTable() const {
-    return metadata->org_table;
+
+  const SQLString& ColumnDefinitionCapi::getTable() const {
+    return getNames().table;
+  }
+
+  const SQLString& ColumnDefinitionCapi::getOriginalTable() const {
+    return getNames().orgtable;
   }
 
 
@@ -110,22 +124,28 @@ namespace capi
   }
 
  
-  FieldNames::FieldNames(MYSQL_FIELD *metadata)
+  static SQLString fieldName(const char* str, unsigned int length)
+  {
+    return str != nullptr ? SQLString(str, length) : SQLString();
+  }
+
+
+  FieldNames::FieldNames(const MYSQL_FIELD *metadata)
+    : name(fieldName(metadata->name, metadata->name_length))
+    , table(fieldName(metadata->table, metadata->table_length))
+    , orgname(fieldName(metadata->org_name, metadata->org_name_length))
+    , orgtable(fieldName(metadata->org_table, metadata->org_table_length))
+    , db(fieldName(metadata->db, metadata->db_length))
+  {
+  }
+
+
+  void FieldNames::assignTo(MYSQL_FIELD* metadata) const
   {
-    name.reserve(metadata->name_length + 1);
-    name.assign(metadata->name, metadata->name_length);
     metadata->name= const_cast<char*>(name.c_str());
-    orgname.reserve(metadata->org_name_length + 1);
-    orgname.assign(metadata->org_name, metadata->org_name_length);
     metadata->org_name= const_cast<char*>(orgname.c_str());
-    db.reserve(metadata->db_length + 1);
-    db.assign(metadata->db, metadata->db_length);
     metadata->db= const_cast<char*>(db.c_str());
-    table.reserve(metadata->table_length + 1);
-    table.assign(metadata->table, metadata->table_length);
     metadata->table= const_cast<char*>(table.c_str());
-    orgtable.reserve(metadata->org_table_length + 1);
-    orgtable.assign(metadata->org_table, metadata->org_table_length);
     metadata->org_table= const_cast<char*>(orgtable.c_str());
   }
 
@@ -136,7 +156,7 @@ namespace capi
     if (!owned) {
       auto copy= new capi::MYSQL_FIELD();
       std::memcpy(copy, metadata, sizeof(capi::MYSQL_FIELD));
-      names.reset(new FieldNames(copy));
+      getNames().assignTo(copy);
 
       owned.reset(copy);
       metadata= copy;
@@ -144,13 +164,13 @@ namespace capi
   }
 
 
-  SQLString ColumnDefinitionCapi::getName() const
+  const SQLString& ColumnDefinitionCapi::getName() const
   {
-    return metadata->name;
+    return getNames().name;
   }
 
-  SQLString ColumnDefinitionCapi::getOriginalName() const {
-    return metadata->org_name;
+  const SQLString& ColumnDefinitionCapi::getOriginalName() const {
+    return getNames().orgname;
   }
 
   int16_t ColumnDefinitionCapi::getCharsetNumber() const {
@@ -21,6 +21,8 @@
 #ifndef _COLUMNINFORMATIONCAPI_H_
 #define _COLUMNINFORMATIONCAPI_H_
 
+#include <mutex>
+
 #include "ColumnType.h"
 #include "Consts.h"
 
@@ -35,12 +37,15 @@ namespace capi
 
 #include "mysql.h"
 
-// Small helper not to keep all those objects in ColumnDefinition object by default and to create copy of names in MYSQL_FIELD for deep copy
+// Names of the column. Created on first request of a name, so result sets nobody asks names from do not pay for them.
+// Also used as storage of names for the deep copy of MYSQL_FIELD
 struct FieldNames
 {
-  std::string name, table, orgname, orgtable, db;
+  SQLString name, table, orgname, orgtable, db;
 
-  FieldNames(MYSQL_FIELD *metadata);
+  FieldNames(const MYSQL_FIELD *metadata);
+  /* Points names in the structure to the strings of this object */
+  void assignTo(MYSQL_FIELD* metadata) const;
 };
 
 
@@ -56,19 +61,22 @@ class ColumnDefinitionCapi : public sql::mariadb::ColumnDefinition
   std::shared_ptr<MYSQL_FIELD> owned;
   const ColumnType& type;
   uint32_t length;
-  std::unique_ptr<FieldNames> names;
-  //SQLString db;
+  /* Shared with copies, since the names of the owned structure may point to them */
+  mutable std::shared_ptr<const FieldNames> names;
+  mutable std::once_flag namesInit;
+
+  const FieldNames& getNames() const;
 
 public:
   ColumnDefinitionCapi(const ColumnDefinitionCapi& other);
   ColumnDefinitionCapi(capi::MYSQL_FIELD* metadata, bool ownshipPassed= false);
 
 public:
-  SQLString getDatabase() const;
-  SQLString getTable() const;
-  SQLString getOriginalTable() const;
-  SQLString getName() const;
-  SQLString getOriginalName() const;
+  const SQLString& getDatabase() const;
+  const SQLString& getTable() const;
+  const SQLString& getOriginalTable() const;
+  const SQLString& getName() const;
+  const SQLString& getOriginalName() const;
   int16_t getCharsetNumber() const;
   SQLString getCollation() const;
   uint32_t getLength() const;
@@ -36,6 +36,9 @@
 #include "protocol/capi/BinRowProtocolCapi.h"
 #include "protocol/capi/TextRowProtocolCapi.h"
 #include "util/ServerPrepareResult.h"
+#include "util/RowSpillFile.h"
+#include "util/ResultSetExporter.h"
+#include "logger/Tracer.h"
 
 namespace sql
 {
@@ -43,6 +46,37 @@ namespace mariadb
 {
 namespace capi
 {
+namespace
+{
+  /* Whether the value of the column is in the row buffer in its string representation, and can be exported as is */
+  bool isExportedAsIs(ColumnDefinition* columnInfo, bool binaryProtocol)
+  {
+    switch (columnInfo->getColumnType().getType()) {
+    case MYSQL_TYPE_BIT:
+    case MYSQL_TYPE_NULL:
+      return false;
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+    case MYSQL_TYPE_JSON:
+    case MYSQL_TYPE_ENUM:
+    case MYSQL_TYPE_SET:
+    case MYSQL_TYPE_GEOMETRY:
+      return true;
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+      return !binaryProtocol || !columnInfo->isZeroFill();
+    default:
+      // Binary protocol sends other types in the binary form
+      return !binaryProtocol;
+    }
+  }
+}
+
   /**
     * Create Streaming resultSet.
     *
@@ -74,27 +108,42 @@ namespace capi
       eofDeprecated(eofDeprecated),
       forceAlias(false)
   {
-    if (fetchSize == 0 || callableResult) {
+    row.reset(new capi::BinRowProtocolCapi(columnsInformation, columnInformationLength, results->getMaxFieldSize(), options, capiStmtHandle));
+    memoryLimit= static_cast<std::size_t>(options->resultSetMemoryLimit);
+
+    if (fetchSize == 0 && !callableResult && memoryLimit > 0) {
+      readAllRows(results);
+    }
+    else if (fetchSize == 0 || callableResult) {
       data.reserve(10);
       if (mysql_stmt_store_result(capiStmtHandle)) {
         throwStmtError(capiStmtHandle);
       }
       dataSize= static_cast<std::size_t>(mysql_stmt_num_rows(capiStmtHandle));
       streaming= false;
+      // Rows are read directly from the handle, until it's going to be re-used
+      storedResultProtocol= protocol;
+      storedResultProtocol->registerStoredResult(capiStmtHandle, this);
       resetVariables();
     }
     else {
       lock= protocol->getLock();
+      cursor= (protocol->getServerStatus() & CURSOR_EXISTS) != 0;
 
-      protocol->setActiveStreamingResult(results);
-
-      protocol->removeHasMoreResults();
+      if (cursor) {
+        // The handle is busy until the cursor is read or closed. If the statement is re-executed meanwhile, the
+        // handle is leased to this resultset, and the statement gets a new one
+        storedResultProtocol= protocol;
+        storedResultProtocol->registerStoredResult(capiStmtHandle, this);
+      }
+      else {
+        protocol->setActiveStreamingResult(results);
+        protocol->removeHasMoreResults();
+      }
       data.reserve(std::max(10, fetchSize)); // Same
-      nextStreamingValue();
       streaming= true;
+      nextStreamingValue();
     }
-
-    row.reset(new capi::BinRowProtocolCapi(columnsInformation, columnInformationLength, results->getMaxFieldSize(), options, capiStmtHandle));
   }
 
 
@@ -118,7 +167,18 @@ namespace capi
       forceAlias(false)
   {
     MYSQL_RES* textNativeResults= nullptr;
-    if (fetchSize == 0 || callableResult) {
+    memoryLimit= static_cast<std::size_t>(options->resultSetMemoryLimit);
+
+    if (fetchSize == 0 && memoryLimit > 0) {
+      // Rows are read by the driver, so that they can go to the temporary file, once over the limit
+      textNativeResults= mysql_use_result(capiConnHandle);
+
+      if (textNativeResults == nullptr && mysql_errno(capiConnHandle) != 0) {
+        throw SQLException(mysql_error(capiConnHandle), mysql_sqlstate(capiConnHandle), mysql_errno(capiConnHandle));
+      }
+      streaming= false;
+    }
+    else if (fetchSize == 0 || callableResult) {
       data.reserve(10);
       textNativeResults= mysql_store_result(capiConnHandle);
 
@@ -141,12 +201,14 @@ namespace capi
     }
     uint32_t fieldCnt= mysql_field_count(capiConnHandle);
 
+    MYSQL_FIELD* field= mysql_fetch_fields(textNativeResults);
     columnsInformation.reserve(fieldCnt);
 
-    for (size_t i= 0; i < fieldCnt; ++i) {
-      columnsInformation.emplace_back(new ColumnDefinitionCapi(mysql_fetch_field(textNativeResults)));
+    for (size_t i= 0; i < fieldCnt; ++i, ++field) {
+      columnsInformation.emplace_back(new ColumnDefinitionCapi(field));
     }
     row.reset(new capi::TextRowProtocolCapi(results->getMaxFieldSize(), options, textNativeResults));
+    row->buildDecoderPlan(columnsInformation);
 
     //columnNameMap.init(columnsInformation);
     columnInformationLength= static_cast<int32_t>(columnsInformation.size());
@@ -154,6 +216,9 @@ namespace capi
     if (streaming) {
       nextStreamingValue();
     }
+    else if (fetchSize == 0 && memoryLimit > 0) {
+      readAllRows(results);
+    }
   }
 
   /**
@@ -170,8 +235,10 @@ namespace capi
     std::vector<Shared::ColumnDefinition>& columnInformation,
     std::vector<std::vector<sql::bytes>>& resultSet,
     Protocol* _protocol,
-    int32_t resultSetScrollType)
+    int32_t resultSetScrollType,
+    std::shared_ptr<const void> rowsOwner)
     :
+      options(_protocol != nullptr ? _protocol->getOptions() : Shared::Options()),
       columnsInformation(columnInformation),
       columnInformationLength(static_cast<int32_t>(columnInformation.size())),
       noBackslashEscapes(false),
@@ -190,11 +257,10 @@ namespace capi
       rowPointer(-1),
       columnNameMap(columnsInformation),
       eofDeprecated(false),
-      forceAlias(false)
+      forceAlias(false),
+      rowsOwner(rowsOwner)
   {
-    if (protocol != nullptr) {
-      this->options= protocol->getOptions();
-    }
+    row->buildDecoderPlan(columnsInformation);
   }
 
 
@@ -202,11 +268,33 @@ namespace capi
   {
     if (!isFullyLoaded()) {
       //close();
-      fetchAllResults();
+      if (cursor) {
+        closeCursor();
+      }
+      else {
+        fetchAllResults();
+      }
     }
+    releaseStoredResult();
     checkOut();
   }
 
+
+  void SelectResultSetCapi::releaseStoredResult()
+  {
+    if (storedResultProtocol != nullptr) {
+      storedResultProtocol->unregisterStoredResult(capiStmtHandle, this);
+      storedResultProtocol= nullptr;
+    }
+  }
+
+  /* Closes the cursor on the server, remaining rows do not need to be fetched */
+  void SelectResultSetCapi::closeCursor()
+  {
+    resetVariables();
+    mysql_stmt_reset(capiStmtHandle);
+  }
+
   /**
     * Indicate if result-set is still streaming results from server.
     *
@@ -344,6 +432,7 @@ namespace capi
     * @throws SQLException if server return an unexpected error
     */
   void SelectResultSetCapi::addStreamingValue() {
+    TraceSpan span("fetch");
 
     int32_t fetchSizeTmp= fetchSize;
     while (fetchSizeTmp > 0 && readNextValue()) {
@@ -380,6 +469,12 @@ namespace capi
     }
 
     case MYSQL_NO_DATA: {
+      if (cursor) {
+        // Fetched rows are cached, and the handle is not needed anymore
+        resetVariables();
+        releaseStoredResult();
+        return false;
+      }
       uint32_t serverStatus;
       if (protocol) {
         if (!eofDeprecated) {
@@ -419,20 +514,117 @@ namespace capi
     }
     }
 
-    if (dataSize + 1 >= data.size()) {
+    // Rows fetched through the cursor are copied, since the handle fetches next rows into the same buffers. Without
+    // streaming, rows are read here only by readAllRows, and have to be cached as well
+    if (cursor || !streaming) {
+      cacheRow(dataSize);
+    }
+    else if (dataSize + 1 >= data.size()) {
       growDataArray();
     }
     ++dataSize;
     return true;
   }
 
+
+  /**
+    * Reads all rows of the result right away, like a buffered result, but caching them in the resultset itself,
+    * where rows over the memory limit go to the temporary file.
+    *
+    * @param results results object the resultset belongs to
+    */
+  void SelectResultSetCapi::readAllRows(Results* results)
+  {
+    lock= protocol->getLock();
+    protocol->setActiveStreamingResult(results);
+    protocol->removeHasMoreResults();
+    data.reserve(10);
+
+    streaming= false;
+    dataSize= 0;
+    while (readNextValue()) {
+    }
+    ++dataFetchTime;
+  }
+
+  /**
+    * Caches the current row of the handle as the row number rowNum. Once rows in memory reach the memory limit,
+    * this and following rows are written to the temporary file.
+    *
+    * @param rowNum row number
+    */
+  void SelectResultSetCapi::cacheRow(std::size_t rowNum)
+  {
+    if (spill) {
+      if (rowNum == spillFrom + spill->size()) {
+        row->cacheCurrentRow(rowToSpill, columnInformationLength);
+        spill->append(rowToSpill);
+        return;
+      }
+      // Rows are being re-read from the beginning(forward-only streaming), the file content is not needed anymore
+      spill.reset();
+    }
+
+    if (rowNum + 1 >= data.size()) {
+      growDataArray();
+    }
+    std::vector<sql::bytes>& rowData= data[rowNum];
+
+    if (memoryLimit == 0) {
+      row->cacheCurrentRow(rowData, columnInformationLength);
+      return;
+    }
+    for (auto& value : rowData) {
+      dataMemory-= value.size();
+    }
+    row->cacheCurrentRow(rowData, columnInformationLength);
+
+    std::size_t rowMemory= 0;
+    for (auto& value : rowData) {
+      rowMemory+= value.size();
+    }
+
+    if (dataMemory + rowMemory > memoryLimit) {
+      spill.reset(new RowSpillFile());
+      spillFrom= rowNum;
+      spill->append(rowData);
+      rowData.clear();
+    }
+    else {
+      dataMemory+= rowMemory;
+    }
+  }
+
+  /**
+    * Get cached row, wherever it is stored.
+    *
+    * @param rowNum row number
+    * @return row's raw bytes
+    */
+  std::vector<sql::bytes>& SelectResultSetCapi::cachedRow(std::size_t rowNum)
+  {
+    if (spill && rowNum >= spillFrom) {
+      spill->read(rowNum - spillFrom, spilledRow);
+      return spilledRow;
+    }
+    return data[rowNum];
+  }
+
+
+  void SelectResultSetCapi::checkRowsModifiable()
+  {
+    if (spill) {
+      throw SQLFeatureNotSupportedException("Rows of the resultset, that are written to the temporary file, cannot be changed");
+    }
+  }
+
   /**
     * Get current row's raw bytes.
     *
     * @return row's raw bytes
     */
   std::vector<sql::bytes>& SelectResultSetCapi::getCurrentRowData() {
-    return data[rowPointer];
+    return cachedRow(rowPointer);
   }
 
   /**
@@ -443,6 +635,7 @@ namespace capi
     */
   void SelectResultSetCapi::updateRowData(std::vector<sql::bytes>& rawData)
   {
+    checkRowsModifiable();
     data[rowPointer]= rawData;
     row->resetRow(data[rowPointer]);
   }
@@ -454,6 +647,7 @@ namespace capi
     */
   void SelectResultSetCapi::deleteCurrentRowData() {
 
+    checkRowsModifiable();
     data.erase(data.begin()+lastRowPointer);
     dataSize--;
     lastRowPointer= -1;
@@ -461,6 +655,7 @@ namespace capi
   }
 
   void SelectResultSetCapi::addRowData(std::vector<sql::bytes>& rawData) {
+    checkRowsModifiable();
     if (dataSize +1 >= data.size()) {
       growDataArray();
     }
@@ -531,10 +726,12 @@ namespace capi
   void SelectResultSetCapi::abort() {
     isClosedFlag= true;
     resetVariables();
+    releaseStoredResult();
 
     for (auto& row : data) {
       row.clear();
     }
+    spill.reset();
 
     if (statement != nullptr) {
       statement->checkCloseOnCompletion(this);
@@ -548,6 +745,9 @@ namespace capi
     if (!isEof) {
       std::unique_lock<std::mutex> localScopeLock(*lock);
       try {
+        if (cursor) {
+          closeCursor();
+        }
         while (!isEof) {
           dataSize= 0; // to avoid storing data
           readNextValue();
@@ -564,8 +764,10 @@ namespace capi
     }
     checkOut();
     resetVariables();
+    releaseStoredResult();
 
     data.clear();
+    spill.reset();
 
     if (statement != nullptr) {
       statement->checkCloseOnCompletion(this);
@@ -582,8 +784,8 @@ namespace capi
   bool SelectResultSetCapi::fetchNext()
   {
     ++rowPointer;
-    if (data.size() > 0) {
-      row->resetRow(data[rowPointer]);
+    if (data.size() > 0 || spill) {
+      row->resetRow(cachedRow(rowPointer));
     }
     else {
       if (row->fetchNext() == MYSQL_NO_DATA) {
@@ -635,8 +837,8 @@ namespace capi
 
   void SelectResultSetCapi::resetRow()
   {
-    if (data.size() > 0) {
-      row->resetRow(data[rowPointer]);
+    if (data.size() > 0 || spill) {
+      row->resetRow(cachedRow(rowPointer));
     }
     else {
       if (rowPointer != lastRowPointer + 1) {
@@ -648,7 +850,8 @@ namespace capi
   }
 
 
-  void SelectResultSetCapi::checkObjectRange(int32_t position) {
+  /* Checks the row and column position, and makes sure the row is current, without positioning it on the column */
+  void SelectResultSetCapi::checkRowRange(int32_t position) {
     if (rowPointer < 0) {
       throw SQLDataException("Current position is before the first row", "22023");
     }
@@ -664,6 +867,11 @@ namespace capi
     if (lastRowPointer != rowPointer) {
       resetRow();
     }
+  }
+
+
+  void SelectResultSetCapi::checkObjectRange(int32_t position) {
+    checkRowRange(position);
     row->setPosition(position - 1);
   }
 
@@ -996,11 +1204,18 @@ namespace capi
 
   /** {inheritDoc}. */
   std::istream* SelectResultSetCapi::getBinaryStream(int32_t columnIndex) {
-    checkObjectRange(columnIndex);
-    if (row->lastValueWasNull()) {
-      return nullptr;
+    checkRowRange(columnIndex);
+    // Large values, that are not fetched yet, are read from the row in chunks, when the stream is read
+    std::unique_ptr<std::streambuf> streamBuffer(row->getInternalStreamBuffer(columnIndex - 1));
+
+    if (!streamBuffer) {
+      row->setPosition(columnIndex - 1);
+      if (row->lastValueWasNull()) {
+        return nullptr;
+      }
+      streamBuffer.reset(new memBuf(row->fieldBuf.arr + row->pos, row->fieldBuf.arr + row->pos + row->getLengthMaxFieldSize()));
     }
-    blobBuffer[columnIndex].reset(new memBuf(row->fieldBuf.arr + row->pos, row->fieldBuf.arr + row->pos + row->getLengthMaxFieldSize()));
+    blobBuffer[columnIndex]= std::move(streamBuffer);
     return new std::istream(blobBuffer[columnIndex].get());
   }
 
@@ -1085,6 +1300,136 @@ namespace capi
     return row->getInternalDouble(columnsInformation[columnIndex -1].get());
   }
 
+  /** {inheritDoc}. */
+  Decimal SelectResultSetCapi::getDecimal(const SQLString& columnLabel) {
+    return getDecimal(findColumn(columnLabel));
+  }
+
+  /** {inheritDoc}. */
+  Decimal SelectResultSetCapi::getDecimal(int32_t columnIndex) {
+    checkObjectRange(columnIndex);
+    return row->getInternalDecimal(columnsInformation[columnIndex -1].get());
+  }
+
+  /**
+    * Exports rows after the current one. Values, that are strings in the row buffer, are passed to the exporter as they
+    * are. Large values, that have not been fetched from the binary protocol row, are read and exported in chunks.
+    *
+    * @param exporter encodes values into its output buffer
+    * @return number of exported rows
+    */
+  int64_t SelectResultSetCapi::exportRows(ResultSetExporter& exporter)
+  {
+    checkClose();
+
+    std::vector<bool> asIs, binary;
+    asIs.reserve(columnInformationLength);
+    binary.reserve(columnInformationLength);
+    for (auto& columnInfo : columnsInformation) {
+      asIs.push_back(isExportedAsIs(columnInfo.get(), isBinaryEncoded()));
+      binary.push_back(needsBinaryConversion(columnInfo.get()));
+    }
+
+    if (exporter.withHeader()) {
+      for (auto& columnInfo : columnsInformation) {
+        const SQLString& label= columnInfo->getName();
+        exporter.addValue(label.c_str(), label.length(), false);
+      }
+      exporter.endRow();
+    }
+
+    int64_t rowCount= 0;
+    std::vector<char> chunk;
+
+    while (next()) {
+      if (lastRowPointer != rowPointer) {
+        resetRow();
+      }
+      for (int32_t i= 0; i < columnInformationLength; ++i) {
+        if (asIs[i]) {
+          std::unique_ptr<std::streambuf> streamBuffer(row->getInternalStreamBuffer(i));
+
+          if (streamBuffer) {
+            chunk.resize(std::max(1, options->longDataChunkSize));
+            exporter.beginValue(binary[i]);
+            std::streamsize read;
+            while ((read= streamBuffer->sgetn(chunk.data(), static_cast<std::streamsize>(chunk.size()))) > 0) {
+              exporter.appendPart(chunk.data(), static_cast<std::size_t>(read));
+            }
+            exporter.endValue();
+            continue;
+          }
+        }
+
+        row->setPosition(i);
+        if (row->lastValueWasNull()) {
+          exporter.addNull();
+        }
+        else if (asIs[i]) {
+          exporter.addValue(row->fieldBuf.arr + row->pos, row->getLengthMaxFieldSize(), binary[i]);
+        }
+        else {
+          std::unique_ptr<SQLString> value(row->getInternalString(columnsInformation[i].get()));
+          if (value) {
+            exporter.addValue(value->c_str(), value->length(), false);
+          }
+          else {
+            exporter.addNull();
+          }
+        }
+      }
+      exporter.endRow();
+      ++rowCount;
+    }
+    exporter.flush();
+
+    return rowCount;
+  }
+
+
+  bool SelectResultSetCapi::copyRows(std::string& values, std::vector<int64_t>& lengths, std::size_t maxSize)
+  {
+    checkClose();
+
+    if (streaming || spill || row->isBinaryEncoded()) {
+      return false;
+    }
+    bool copied= true;
+    bool fromHandle= data.empty() && dataSize > 0;
+
+    if (fromHandle) {
+      row->installCursorAtPosition(0);
+    }
+    for (std::size_t r= 0; r < dataSize && copied; ++r) {
+      if (fromHandle) {
+        row->fetchNext();
+      }
+      else {
+        row->resetRow(data[r]);
+      }
+      for (int32_t i= 0; i < columnInformationLength; ++i) {
+        row->setPosition(i);
+        if (row->lastValueWasNull()) {
+          lengths.push_back(-1);
+          continue;
+        }
+        if (values.size() + row->length > maxSize) {
+          copied= false;
+          break;
+        }
+        values.append(row->fieldBuf.arr + row->pos, row->length);
+        lengths.push_back(row->length);
+      }
+    }
+    // The row buffer has to be re-read for the current position
+    if (fromHandle) {
+      row->installCursorAtPosition(rowPointer > -1 ? rowPointer : 0);
+    }
+    lastRowPointer= -1;
+
+    return copied;
+  }
+
 #ifdef JDBC_SPECIFIC_TYPES_IMPLEMENTED
   /** {inheritDoc}. */
   BigDecimal SelectResultSetCapi::getBigDecimal(const SQLString& columnLabel, int32_t scale) {
@@ -2012,13 +2357,19 @@ namespace capi
   }
 
 
+  const std::vector<Shared::ColumnDefinition>& SelectResultSetCapi::getColumnsInformation() const {
+    return columnsInformation;
+  }
+
+
   void SelectResultSetCapi::cacheCompleteLocally() {
 
-    if (fetchSize > 0) {
-      fetchRemaining();
+    // The caller holds the protocol lock
+    if (streaming) {
+      fetchRemainingInternal();
     }
     else if (row->isBinaryEncoded()) {
-      if (data.size()) {
+      if (data.size() || spill) {
         // we have already it cached
         return;
       }
@@ -2033,14 +2384,18 @@ namespace capi
           row->installCursorAtPosition(rowPointer > -1 ? rowPointer : 0);
           lastRowPointer= -1;
         }
-        growDataArray(true);
+        // With the memory limit rows over it don't need slots in memory
+        if (memoryLimit == 0) {
+          growDataArray(true);
+        }
         for (std::size_t rowNum= 0; rowNum < dataSize; ++rowNum) {
           row->fetchNext();
-          row->cacheCurrentRow(data[rowNum], columnInformationLength);
+          cacheRow(rowNum);
         }
         for (auto& colInfo : columnsInformation) {
           colInfo->makeLocalCopy();
         }
+        releaseStoredResult();
         //columnNameMap.init(columnsInformation);
         rowPointer= preservedPosition;
         fetchSize= 0;
@@ -47,6 +47,7 @@ namespace mariadb
 {
 class TimeZone;
 class ServerPrepareResult;
+class RowSpillFile;
 struct memBuf;
 
 namespace capi
@@ -60,7 +61,7 @@ class SelectResultSetCapi : public SelectResultSet
   std::vector<Shared::ColumnDefinition> columnsInformation;
   int32_t columnInformationLength;
   bool noBackslashEscapes;
-  std::map<int32_t, std::unique_ptr<memBuf>> blobBuffer;
+  std::map<int32_t, std::unique_ptr<std::streambuf>> blobBuffer;
 
   Protocol* protocol;
   bool isEof= false;
@@ -71,13 +72,25 @@ class SelectResultSetCapi : public SelectResultSet
 
   MYSQL *capiConnHandle;
   MYSQL_STMT *capiStmtHandle;
+  /* Protocol, that the resultset is registered with, while it reads rows stored in the statement handle */
+  Protocol* storedResultProtocol= nullptr;
 
   int32_t dataFetchTime= 0;
   bool streaming;
+  /* Rows are fetched through the server-side cursor, that does not block the connection */
+  bool cursor= false;
 
   /*std::unique_ptr<*/
   std::vector<std::vector<sql::bytes>> data;
   std::size_t dataSize; //Should go after data
+  /* Rows starting from spillFrom, that did not fit resultSetMemoryLimit */
+  std::unique_ptr<RowSpillFile> spill;
+  std::size_t spillFrom= 0;
+  std::size_t memoryLimit= 0;
+  std::size_t dataMemory= 0;
+  /* Current row read from the spill file, and the buffer for the row being written there */
+  std::vector<sql::bytes> spilledRow;
+  std::vector<sql::bytes> rowToSpill;
 
   int32_t fetchSize;
   int32_t resultSetScrollType;
@@ -90,6 +103,8 @@ class SelectResultSetCapi : public SelectResultSet
   bool eofDeprecated;
   Shared::mutex lock;
   bool forceAlias;
+  /* Keeps alive the memory wrapped by rows, that the result set does not own - e.g. of the query result cache entry */
+  std::shared_ptr<const void> rowsOwner;
 
 public:
 
@@ -110,13 +125,16 @@ public:
     std::vector<Shared::ColumnDefinition>& columnInformation,
     /*std::unique_ptr<*/std::vector<std::vector<sql::bytes>>& resultSet,
     Protocol* protocol,
-    int32_t resultSetScrollType);
+    int32_t resultSetScrollType,
+    std::shared_ptr<const void> rowsOwner= nullptr);
   ~SelectResultSetCapi();
 
   bool isFullyLoaded() const;
 
 private:
   void fetchAllResults();
+  void releaseStoredResult();
+  void closeCursor();
 
   const char* getErrMessage();
   const char* getSqlState();
@@ -151,7 +169,12 @@ public:
   bool fetchNext();
   bool next();
 private:
+  void readAllRows(Results* results);
+  void cacheRow(std::size_t rowNum);
+  std::vector<sql::bytes>& cachedRow(std::size_t rowNum);
+  void checkRowsModifiable();
   void resetRow();
+  void checkRowRange(int32_t position);
   void checkObjectRange(int32_t position);
 public:
   SQLWarning* getWarnings();
@@ -206,6 +229,10 @@ public:
   float getFloat(int32_t columnIndex);
   long double getDouble(const SQLString& columnLabel);
   long double getDouble(int32_t columnIndex);
+  Decimal getDecimal(int32_t columnIndex);
+  Decimal getDecimal(const SQLString& columnLabel);
+  int64_t exportRows(ResultSetExporter& exporter);
+  bool copyRows(std::string& values, std::vector<int64_t>& lengths, std::size_t maxSize);
   bool getBoolean(int32_t index);
   bool getBoolean(const SQLString& columnLabel);
   int8_t getByte(int32_t index);
@@ -382,6 +409,7 @@ public:
   void checkOut() override;
   std::size_t getDataSize();
   bool isBinaryEncoded();
+  const std::vector<Shared::ColumnDefinition>& getColumnsInformation() const;
   void cacheCompleteLocally();
   };
 
@@ -0,0 +1,233 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#include "ClusterHealthMonitor.h"
+
+#include "MariaDbConnection.h"
+#include "UrlParser.h"
+#include "Statement.hpp"
+#include "ResultSet.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace
+{
+  std::mutex registryLock;
+  std::map<std::string, std::weak_ptr<ClusterHealthMonitor>> registry;
+
+  std::string makeKey(const UrlParser& urlParser)
+  {
+    std::string key(StringImp::get(HostAddress::toString(urlParser.getHostAddresses())));
+
+    key.append(1, '\0').append(StringImp::get(urlParser.getUsername()));
+    key.append(1, '\0').append(std::to_string(urlParser.getOptions()->galeraHealthCheckInterval));
+    return key;
+  }
+}
+
+  const SQLString ClusterHealthMonitor::STATE_QUERY(
+    "SHOW STATUS WHERE Variable_name IN ('wsrep_local_state','wsrep_local_recv_queue')");
+
+
+  ClusterHealthMonitor::ClusterHealthMonitor(const UrlParser& urlParser)
+    : state(new State())
+  {
+    state->hosts= urlParser.getHostAddresses();
+    state->maxReceiveQueue= urlParser.getOptions()->galeraMaxReceiveQueue;
+    state->interval= std::chrono::milliseconds(urlParser.getOptions()->galeraHealthCheckInterval);
+
+    const SQLString& allowed= urlParser.getOptions()->galeraAllowedState;
+    Tokens states= split(allowed.empty() ? SQLString("4") : allowed, ",");
+
+    for (auto& hostState : *states) {
+      try {
+        state->allowedStates.push_back(std::stoi(StringImp::get(hostState)));
+      }
+      catch (std::exception&) {
+        // Not a state number, thus no host can be in it
+      }
+    }
+
+    // Hosts are checked one after another, and an unreachable host should not delay checks of the others much
+    const int32_t checkTimeout= std::max(std::min(urlParser.getOptions()->galeraHealthCheckInterval, 1000), 1);
+    UrlParser parser(urlParser);
+
+    for (auto& host : state->hosts) {
+      std::shared_ptr<UrlParser> hostParser(parser.clone());
+      Options* hostOptions= hostParser->getOptions().get();
+
+      hostOptions->galeraHealthCheckInterval= 0;
+      hostOptions->connectTimeout= hostOptions->connectTimeout > 0 ? std::min(hostOptions->connectTimeout, checkTimeout) : checkTimeout;
+      hostOptions->socketTimeout= hostOptions->socketTimeout > 0 ? std::min(hostOptions->socketTimeout, checkTimeout) : checkTimeout;
+      hostParser->getHostAddresses().assign(1, host);
+      state->hostParsers.push_back(hostParser);
+    }
+    state->connections.resize(state->hosts.size());
+
+    std::thread(&ClusterHealthMonitor::run, state).detach();
+  }
+
+  /**
+    * Stops the worker without waiting for it. The worker may be in the middle of a check, and finishes it on its own
+    */
+  ClusterHealthMonitor::~ClusterHealthMonitor()
+  {
+    {
+      std::lock_guard<std::mutex> guard(state->lock);
+      state->stopped= true;
+    }
+    state->wakeUp.notify_one();
+  }
+
+
+  std::shared_ptr<ClusterHealthMonitor> ClusterHealthMonitor::get(const UrlParser& urlParser)
+  {
+    std::string key(makeKey(urlParser));
+    std::lock_guard<std::mutex> guard(registryLock);
+
+    for (auto it= registry.begin(); it != registry.end();) {
+      if (it->second.expired()) {
+        it= registry.erase(it);
+      }
+      else {
+        ++it;
+      }
+    }
+
+    std::shared_ptr<ClusterHealthMonitor> monitor(registry[key].lock());
+    if (!monitor) {
+      monitor.reset(new ClusterHealthMonitor(urlParser));
+      registry[key]= monitor;
+    }
+    return monitor;
+  }
+
+  /**
+    * Checks all hosts, publishes the snapshot and sleeps for the interval, until the monitor is stopped.
+    * Connections to hosts are kept open between checks, and reopened after errors.
+    */
+  void ClusterHealthMonitor::run(std::shared_ptr<State> state)
+  {
+    while (!state->stopped) {
+      std::shared_ptr<Snapshot> fresh(new Snapshot(state->hosts.size()));
+
+      for (std::size_t i= 0; i < state->hosts.size() && !state->stopped; ++i) {
+        (*fresh)[i]= check(*state, i);
+      }
+      std::atomic_store(&state->snapshot, std::shared_ptr<const Snapshot>(fresh));
+
+      std::unique_lock<std::mutex> guard(state->lock);
+      state->wakeUp.wait_for(guard, state->interval, [&state]{ return state->stopped.load(); });
+    }
+    state->connections.clear();
+  }
+
+
+  ClusterHealthMonitor::HostHealth ClusterHealthMonitor::check(State& state, std::size_t hostIndex)
+  {
+    HostHealth health;
+    health.checked= true;
+
+    try {
+      if (!state.connections[hostIndex]) {
+        state.connections[hostIndex].reset(MariaDbConnection::newConnection(state.hostParsers[hostIndex], nullptr));
+      }
+      std::unique_ptr<Statement> stmt(state.connections[hostIndex]->createStatement());
+      std::unique_ptr<ResultSet> rs(stmt->executeQuery(STATE_QUERY));
+
+      health.reachable= true;
+      while (rs->next()) {
+        SQLString name(rs->getString(1));
+        if (name.compare("wsrep_local_state") == 0) {
+          health.state= rs->getInt(2);
+        }
+        else {
+          health.receiveQueue= rs->getLong(2);
+        }
+      }
+    }
+    catch (SQLException&) {
+      state.connections[hostIndex].reset();
+      health.reachable= false;
+    }
+
+    health.healthy= health.reachable
+      && (health.state < 0
+        || std::find(state.allowedStates.begin(), state.allowedStates.end(), health.state) != state.allowedStates.end())
+      && (state.maxReceiveQueue <= 0 || health.receiveQueue <= state.maxReceiveQueue);
+
+    return health;
+  }
+
+
+  int32_t ClusterHealthMonitor::indexOf(const HostAddress& host) const
+  {
+    const std::vector<HostAddress>& hosts= state->hosts;
+
+    for (std::size_t i= 0; i < hosts.size(); ++i) {
+      if (hosts[i].port == host.port && hosts[i].host.compare(host.host) == 0) {
+        return static_cast<int32_t>(i);
+      }
+    }
+    return -1;
+  }
+
+
+  void ClusterHealthMonitor::excludeUnhealthy(std::vector<HostAddress>& candidates) const
+  {
+    std::shared_ptr<const Snapshot> current(getSnapshot());
+
+    if (!current) {
+      return;
+    }
+    std::vector<HostAddress> healthy;
+    for (auto& candidate : candidates) {
+      int32_t index= indexOf(candidate);
+      if (index < 0 || (*current)[index].healthy) {
+        healthy.push_back(candidate);
+      }
+    }
+    // If all hosts look unhealthy, the snapshot may be stale, and it's better to try them all
+    if (!healthy.empty() && healthy.size() < candidates.size()) {
+      candidates.swap(healthy);
+    }
+  }
+
+
+  bool ClusterHealthMonitor::lookup(const HostAddress& host, HostHealth& health) const
+  {
+    std::shared_ptr<const Snapshot> current(getSnapshot());
+    int32_t index= indexOf(host);
+
+    if (!current || index < 0) {
+      return false;
+    }
+    health= (*current)[index];
+    return health.checked;
+  }
+}
+}
@@ -0,0 +1,112 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _CLUSTERHEALTHMONITOR_H_
+#define _CLUSTERHEALTHMONITOR_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "HostAddress.h"
+
+namespace sql
+{
+class Connection;
+
+namespace mariadb
+{
+class UrlParser;
+
+/**
+ * Background monitor of Galera cluster hosts, shared by connections with the same list of hosts and user. Its thread
+ * checks state and receive queue of each host on the host's own connection, and publishes an immutable snapshot of
+ * hosts health. Connections read the latest snapshot, without waiting for the monitor or querying hosts themselves.
+ */
+class ClusterHealthMonitor final
+{
+public:
+  struct HostHealth
+  {
+    /* false until the host has been checked */
+    bool checked= false;
+    bool reachable= false;
+    /* wsrep_local_state, or -1 if the host is not a Galera node */
+    int32_t state= -1;
+    int64_t receiveQueue= 0;
+    bool healthy= true;
+  };
+
+  /* Health of hosts in the order of the host list */
+  typedef std::vector<HostHealth> Snapshot;
+
+private:
+  static const SQLString STATE_QUERY;
+
+  /* Everything the worker thread uses. The thread owns it too, so the monitor is destructed without waiting for
+     the thread to finish a check */
+  struct State
+  {
+    std::vector<HostAddress> hosts;
+    /* Connection parameters for each host. The monitor is disabled in them */
+    std::vector<std::shared_ptr<UrlParser>> hostParsers;
+    std::vector<std::unique_ptr<Connection>> connections;
+    std::vector<int32_t> allowedStates;
+    int64_t maxReceiveQueue= 0;
+    std::chrono::milliseconds interval;
+    std::shared_ptr<const Snapshot> snapshot;
+
+    std::mutex lock;
+    std::condition_variable wakeUp;
+    std::atomic<bool> stopped{false};
+  };
+
+  std::shared_ptr<State> state;
+
+  ClusterHealthMonitor(const ClusterHealthMonitor&)= delete;
+  ClusterHealthMonitor& operator=(const ClusterHealthMonitor&)= delete;
+
+  static void run(std::shared_ptr<State> state);
+  static HostHealth check(State& state, std::size_t hostIndex);
+  int32_t indexOf(const HostAddress& host) const;
+
+public:
+  ClusterHealthMonitor(const UrlParser& urlParser);
+  ~ClusterHealthMonitor();
+
+  /* Returns monitor for hosts and user of urlParser, starting it if there is none yet */
+  static std::shared_ptr<ClusterHealthMonitor> get(const UrlParser& urlParser);
+
+  /* Latest snapshot, or nullptr if hosts have not been checked yet */
+  std::shared_ptr<const Snapshot> getSnapshot() const { return std::atomic_load(&state->snapshot); }
+  /* Removes from candidates hosts known to be unhealthy, unless that would leave no hosts at all */
+  void excludeUnhealthy(std::vector<HostAddress>& candidates) const;
+  /* Returns false if the host has not been checked yet */
+  bool lookup(const HostAddress& host, HostHealth& health) const;
+};
+
+}
+}
+#endif
@@ -192,11 +192,9 @@ namespace mariadb
           Arrays.copyOfRange(rawBytes, 0, off >1000 ? 1000 : off)));
     }*/
 
-    if (logger->isTraceEnabled()) {
-      logger->trace(
-        "read: " + serverThreadLog +
-        Utils::hexdump(maxQuerySizeToLog -4, 0, lastPacketLength, header.data(), static_cast<int32_t>(header.size())));//rawBytes));
-    }
+    LOGGER_TRACE(logger,
+      "read: " + serverThreadLog +
+      Utils::hexdump(maxQuerySizeToLog -4, 0, lastPacketLength, header.data(), static_cast<int32_t>(header.size())));//rawBytes));
 
     // ***************************************************
     // In case content length is big, content will be separate in many 16Mb packets
@@ -250,11 +248,9 @@ namespace mariadb
               Arrays.copyOfRange(rawBytes, 0, off >1000 ? 1000 : off)));
         }
 #endif
-        if (logger->isTraceEnabled()) {
-          logger->trace(
-            "read: " + serverThreadLog + Utils::hexdump(
-              maxQuerySizeToLog -4, currentBufferLength, packetLength, header.data(), static_cast<int32_t>(header.size())));// rawBytes));
-        }
+        LOGGER_TRACE(logger,
+          "read: " + serverThreadLog + Utils::hexdump(
+            maxQuerySizeToLog -4, currentBufferLength, packetLength, header.data(), static_cast<int32_t>(header.size())));// rawBytes));
 
         lastPacketLength +=packetLength;
       } while (packetLength == MAX_PACKET_SIZE);
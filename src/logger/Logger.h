@@ -24,6 +24,32 @@
 #include "StringImp.h"
 #include "MariaDBException.h"
 
+/* Logging calls below MARIADB_LOGGER_LEVEL are compiled out. The build may define it to one of the levels below */
+#define MARIADB_LOGGER_TRACE 0
+#define MARIADB_LOGGER_DEBUG 1
+#define MARIADB_LOGGER_INFO  2
+#define MARIADB_LOGGER_WARN  3
+#define MARIADB_LOGGER_ERROR 4
+#define MARIADB_LOGGER_OFF   5
+
+#ifndef MARIADB_LOGGER_LEVEL
+# define MARIADB_LOGGER_LEVEL MARIADB_LOGGER_TRACE
+#endif
+
+/* Message arguments are evaluated only if the level is enabled, i.e. no strings are built for disabled levels */
+#define LOGGER_LOG(_LEVEL, _ENABLED, _METHOD, _LOGGER, ...) \
+  do { \
+    if (_LEVEL >= MARIADB_LOGGER_LEVEL && (_LOGGER)->_ENABLED()) { \
+      (_LOGGER)->_METHOD(__VA_ARGS__); \
+    } \
+  } while (false)
+
+#define LOGGER_TRACE(_LOGGER, ...) LOGGER_LOG(MARIADB_LOGGER_TRACE, isTraceEnabled, trace, _LOGGER, __VA_ARGS__)
+#define LOGGER_DEBUG(_LOGGER, ...) LOGGER_LOG(MARIADB_LOGGER_DEBUG, isDebugEnabled, debug, _LOGGER, __VA_ARGS__)
+#define LOGGER_INFO(_LOGGER, ...)  LOGGER_LOG(MARIADB_LOGGER_INFO, isInfoEnabled, info, _LOGGER, __VA_ARGS__)
+#define LOGGER_WARN(_LOGGER, ...)  LOGGER_LOG(MARIADB_LOGGER_WARN, isWarnEnabled, warn, _LOGGER, __VA_ARGS__)
+#define LOGGER_ERROR(_LOGGER, ...) LOGGER_LOG(MARIADB_LOGGER_ERROR, isErrorEnabled, error, _LOGGER, __VA_ARGS__)
+
 namespace sql
 {
 namespace mariadb
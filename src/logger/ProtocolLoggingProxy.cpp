@@ -301,6 +301,15 @@ namespace mariadb
   }
 
 
+  void ProtocolLoggingProxy::executePipeline(std::vector<Shared::Results>& results, const std::vector<SQLString>& queries,
+    const std::vector<ClientPrepareResult*>& prepareResults, std::map<std::size_t, SQLException>& errors,
+    std::size_t maxInFlight)
+  {
+    /* Add here logging if needed */
+    protocol->executePipeline(results, queries, prepareResults, errors, maxInFlight);
+  }
+
+
   void ProtocolLoggingProxy::executePreparedQuery(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results,
     std::vector<Shared::ParameterHolder>& parameters)
   {
@@ -410,6 +419,12 @@ namespace mariadb
     protocol->setLocalInfileInputStream(inputStream);
   }
 
+
+  void ProtocolLoggingProxy::executeLoadData(Shared::Results& results, const SQLString& sql, const char* data, std::size_t length)
+  {
+    protocol->executeLoadData(results, sql, data, length);
+  }
+
   int32_t ProtocolLoggingProxy::getTimeout()
 	{
 		/* Add here logging if needed */
@@ -621,6 +636,24 @@ namespace mariadb
 	}
 
 
+  void ProtocolLoggingProxy::registerStoredResult(capi::MYSQL_STMT* stmt, SelectResultSet* rs)
+  {
+    protocol->registerStoredResult(stmt, rs);
+  }
+
+
+  void ProtocolLoggingProxy::unregisterStoredResult(capi::MYSQL_STMT* stmt, SelectResultSet* rs)
+  {
+    protocol->unregisterStoredResult(stmt, rs);
+  }
+
+
+  void ProtocolLoggingProxy::unregisterPrepareResult(ServerPrepareResult* serverPrepareResult)
+  {
+    protocol->unregisterPrepareResult(serverPrepareResult);
+  }
+
+
   void ProtocolLoggingProxy::resetStateAfterFailover(int64_t maxRows, int32_t transactionIsolationLevel, const SQLString& database, bool autocommit)
   {
     /* Add here logging if needed */
@@ -91,6 +91,9 @@ public:
   bool executeBatchClient(bool mustExecuteOnMaster, Shared::Results& results, ClientPrepareResult* prepareResult,
     std::vector<std::vector<Shared::ParameterHolder>>& parametersList, bool hasLongData);
   void executeBatchStmt(bool mustExecuteOnMaster,Shared::Results& results, const std::vector<SQLString>& queries);
+  void executePipeline(std::vector<Shared::Results>& results, const std::vector<SQLString>& queries,
+    const std::vector<ClientPrepareResult*>& prepareResults, std::map<std::size_t, SQLException>& errors,
+    std::size_t maxInFlight);
   void executePreparedQuery(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results, std::vector<Shared::ParameterHolder>& parameters);
   bool executeBatchServer(bool mustExecuteOnMaster, ServerPrepareResult* serverPrepareResult, Shared::Results& results, const SQLString& sql,
                           std::vector<std::vector<Shared::ParameterHolder>>& parameterList, bool hasLongData);
@@ -108,6 +111,7 @@ public:
   uint32_t getPatchServerVersion();
   bool versionGreaterOrEqual(uint32_t major, uint32_t minor, uint32_t patch) const;
   void setLocalInfileInputStream(std::istream& inputStream);
+  void executeLoadData(Shared::Results& results, const SQLString& sql, const char* data, std::size_t length);
   int32_t getTimeout();
   void setTimeout(int32_t timeout);
   bool getPinGlobalTxToPhysicalConnection() const;
@@ -139,6 +143,9 @@ public:
   void changeSocketTcpNoDelay(bool setTcpNoDelay);
   void changeSocketSoTimeout(int32_t setSoTimeout);
   void removeActiveStreamingResult();
+  void registerStoredResult(capi::MYSQL_STMT* stmt, SelectResultSet* rs);
+  void unregisterStoredResult(capi::MYSQL_STMT* stmt, SelectResultSet* rs);
+  void unregisterPrepareResult(ServerPrepareResult* serverPrepareResult);
   void resetStateAfterFailover(int64_t maxRows,int32_t transactionIsolationLevel, const SQLString& database, bool autocommit);
   bool isServerMariaDb();
   void setActiveFutureTask(FutureTask* activeFutureTask);
@@ -0,0 +1,179 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <sstream>
+
+#include "Tracer.h"
+
+#include "conncpp/Tracing.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+  std::atomic<bool> Tracer::enabled(false);
+  std::mutex Tracer::ringsLock;
+  std::vector<std::unique_ptr<Tracer::Ring>> Tracer::rings;
+
+
+  Tracer::Ring::Ring(std::size_t _threadNumber)
+    : head(0)
+    , tail(0)
+    , owned(true)
+    , threadNumber(_threadNumber)
+  {
+    for (auto& it : slot) {
+      it.sequence.store(0, std::memory_order_relaxed);
+    }
+  }
+
+
+  Tracer::RingOwner::~RingOwner()
+  {
+    if (ring != nullptr) {
+      ring->owned.store(false, std::memory_order_release);
+    }
+  }
+
+
+  Tracer::Ring& Tracer::threadRing()
+  {
+    static thread_local RingOwner owner;
+
+    if (owner.ring == nullptr) {
+      std::lock_guard<std::mutex> localScopeLock(ringsLock);
+
+      for (auto& it : rings) {
+        bool owned= false;
+        if (it->owned.compare_exchange_strong(owned, true)) {
+          owner.ring= it.get();
+          break;
+        }
+      }
+      if (owner.ring == nullptr) {
+        rings.emplace_back(new Ring(rings.size()));
+        owner.ring= rings.back().get();
+      }
+    }
+    return *owner.ring;
+  }
+
+
+  void Tracer::record(const char* name, const std::chrono::steady_clock::time_point& start, int64_t connectionId)
+  {
+    auto end= std::chrono::steady_clock::now();
+    Ring& ring= threadRing();
+    uint64_t position= ring.head.load(std::memory_order_relaxed);
+    Slot& slot= ring.slot[position & (RING_SIZE - 1)];
+    uint64_t sequence= slot.sequence.load(std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(
+      std::chrono::duration_cast<std::chrono::microseconds>(start.time_since_epoch()).count(), std::memory_order_relaxed);
+    slot.duration.store(
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(), std::memory_order_relaxed);
+    slot.connectionId.store(connectionId, std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    ring.head.store(position + 1, std::memory_order_release);
+  }
+
+
+  void Tracer::enable(bool enable)
+  {
+    enabled.store(enable, std::memory_order_relaxed);
+  }
+
+  /* Returns spans of all threads in Chrome trace event format */
+  SQLString Tracer::dump()
+  {
+    std::ostringstream out;
+    bool first= true;
+
+    out << "{\"traceEvents\":[";
+
+    std::lock_guard<std::mutex> localScopeLock(ringsLock);
+    for (auto& ring : rings) {
+      uint64_t head= ring->head.load(std::memory_order_acquire);
+      uint64_t position= ring->tail.load(std::memory_order_relaxed);
+
+      if (head > RING_SIZE && position < head - RING_SIZE) {
+        position= head - RING_SIZE;
+      }
+      for (; position < head; ++position) {
+        Slot& slot= ring->slot[position & (RING_SIZE - 1)];
+        uint64_t sequence= slot.sequence.load(std::memory_order_acquire);
+
+        if ((sequence & 1) != 0) {
+          continue;
+        }
+        const char* name= slot.name.load(std::memory_order_relaxed);
+        int64_t start= slot.start.load(std::memory_order_relaxed);
+        int64_t duration= slot.duration.load(std::memory_order_relaxed);
+        int64_t connectionId= slot.connectionId.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+          // The writer has wrapped around and is overwriting the slot
+          continue;
+        }
+        out << (first ? "" : ",") << "{\"name\":\"" << name << "\",\"cat\":\"mariadb\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+          << ring->threadNumber << ",\"ts\":" << start << ",\"dur\":" << duration
+          << ",\"args\":{\"connection\":" << connectionId << "}}";
+        first= false;
+      }
+    }
+    out << "],\"displayTimeUnit\":\"ms\"}";
+
+    return out.str();
+  }
+
+
+  void Tracer::clear()
+  {
+    std::lock_guard<std::mutex> localScopeLock(ringsLock);
+    for (auto& ring : rings) {
+      ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+  }
+
+
+  void enable_tracing(bool enable)
+  {
+    Tracer::enable(enable);
+  }
+
+
+  SQLString dump_trace()
+  {
+    return Tracer::dump();
+  }
+
+
+  void clear_trace()
+  {
+    Tracer::clear();
+  }
+}
+}
@@ -0,0 +1,128 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _TRACER_H_
+#define _TRACER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "SQLString.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Driver-wide tracer of connect, prepare, execute, fetch and close spans. Every thread writes spans into its own
+ * ring buffer of the last RING_SIZE spans, without locks and allocations. Span names are string literals, so nothing
+ * is formatted until the trace is dumped as Chrome trace JSON. A slot is guarded by a sequence number, that is odd
+ * while the slot is being written, thus the dump can run concurrently with writers and skips torn slots.
+ */
+class Tracer final
+{
+  static const std::size_t RING_SIZE= 4096; /* Must be power of 2 */
+
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    std::atomic<const char*> name;
+    std::atomic<int64_t> start;
+    std::atomic<int64_t> duration;
+    std::atomic<int64_t> connectionId;
+  };
+
+  struct Ring {
+    Slot slot[RING_SIZE];
+    std::atomic<uint64_t> head;
+    /* Spans before this position have been cleared */
+    std::atomic<uint64_t> tail;
+    /* Ring is used by a running thread. Rings of finished threads are given to new threads */
+    std::atomic<bool> owned;
+    const std::size_t threadNumber;
+
+    Ring(std::size_t _threadNumber);
+  };
+
+  /* Returns ring to the pool when the thread finishes */
+  struct RingOwner {
+    Ring* ring= nullptr;
+    ~RingOwner();
+  };
+
+  static std::atomic<bool> enabled;
+  static std::mutex ringsLock;
+  static std::vector<std::unique_ptr<Ring>> rings;
+
+  static Ring& threadRing();
+
+  Tracer()= delete;
+
+public:
+  static bool isEnabled()
+  {
+    return enabled.load(std::memory_order_relaxed);
+  }
+
+  static void record(const char* name, const std::chrono::steady_clock::time_point& start, int64_t connectionId);
+  static void enable(bool enable);
+  static SQLString dump();
+  static void clear();
+};
+
+/* Records the span of its scope, if tracing is enabled when it's created. The connection id is read when the scope
+   ends, so it may be assigned inside of the scope, as it happens on connect */
+class TraceSpan final
+{
+  const char* name;
+  const int64_t* connectionId;
+  std::chrono::steady_clock::time_point start;
+  const bool active;
+
+  TraceSpan(const TraceSpan&)= delete;
+  void operator=(const TraceSpan&)= delete;
+
+public:
+  TraceSpan(const char* _name, const int64_t* _connectionId= nullptr)
+    : name(_name)
+    , connectionId(_connectionId)
+    , active(Tracer::isEnabled())
+  {
+    if (active) {
+      start= std::chrono::steady_clock::now();
+    }
+  }
+
+  ~TraceSpan()
+  {
+    if (active) {
+      Tracer::record(name, start, connectionId != nullptr ? *connectionId : 0);
+    }
+  }
+};
+
+}
+}
+#endif
@@ -712,7 +712,118 @@ namespace sql
         " mysql_native_password, client_ed25519, auth_gssapi_client, caching_sha2_password, dialog and mysql_clear_password",
         false,
         ""}
-      }
+      },
+      {
+        "batchChunkSize", {"batchChunkSize",
+        "1.0.9",
+        "Target size in bytes of a query assembled from a batch, when the batch is rewritten or aggregated(see "
+        "rewriteBatchedStatements and allowMultiQueries). 0 means the size is limited only by the "
+        "max_allowed_packet of the server",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "metadataCacheTtl", {"metadataCacheTtl",
+        "1.0.9",
+        "Time in milliseconds, for which results of DatabaseMetaData methods are cached by the driver and shared "
+        "between connections to the same server. 0 disables the cache",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "metadataCacheSize", {"metadataCacheSize",
+        "1.0.9",
+        "Maximum number of DatabaseMetaData results kept in the metadata cache(see metadataCacheTtl)",
+        false,
+        int32_t(256),
+        int32_t(1) }},
+      {
+        "reprepareOnReconnect", {"reprepareOnReconnect",
+        "1.0.9",
+        "Number of most executed server-side prepared statements, that are prepared again right after the connection "
+        "has been re-established. Other prepared statements are re-prepared on their next execution",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "bulkLoadBufferSize", {"bulkLoadBufferSize",
+        "1.0.9",
+        "Size in bytes of the buffer, in which BulkLoader encodes rows. Once the buffer is full, rows are sent to the "
+        "server with LOAD DATA LOCAL INFILE",
+        false,
+        int32_t(16777216),
+        int32_t(1024) }},
+      {
+        "serverStateCacheTtl", {"serverStateCacheTtl",
+        "1.0.9",
+        "Time in milliseconds, during which server variables read after connect(max_allowed_packet, time zones etc) "
+        "are shared by new connections to the same host and port with the same user and session variables. Such "
+        "connections only send the session setup query. 0 disables the cache",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "clientPrepareCacheSize", {"clientPrepareCacheSize",
+        "1.0.9",
+        "Number of parsed client-side prepared statement queries, that the driver keeps and shares between all "
+        "connections. 0 disables the cache",
+        false,
+        int32_t(256),
+        int32_t(0) }},
+      {
+        "longDataChunkSize", {"longDataChunkSize",
+        "1.0.9",
+        "Size in bytes of chunks, in which stream parameters of server-side prepared statements are sent to the server. "
+        "The buffer for chunks is allocated once per connection. Large values of binary protocol results, read with "
+        "getBinaryStream/getBlob, are read in chunks of the same size",
+        false,
+        int32_t(1048576),
+        int32_t(1024) }},
+      {
+        "resultSetMemoryLimit", {"resultSetMemoryLimit",
+        "1.0.9",
+        "Maximum size in bytes of rows, that a result set keeps in memory. Rows over the limit are written to a "
+        "temporary file. If set, results with fetchSize 0 are read from the server right away by the driver, instead "
+        "of being stored by the client library. 0 means no limit",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "galeraHealthCheckInterval", {"galeraHealthCheckInterval",
+        "1.0.9",
+        "Interval in milliseconds, with which the background monitor, shared by connections to the same cluster, "
+        "checks state of each host of the connection string. New connections skip hosts, which \"wsrep_local_state\" "
+        "is not in galeraAllowedState(default \"4\"), or which receive queue exceeds galeraMaxReceiveQueue. Is used only "
+        "with multiple hosts. 0 disables the monitor",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "galeraMaxReceiveQueue", {"galeraMaxReceiveQueue",
+        "1.0.9",
+        "Maximum length of the replication receive queue(\"wsrep_local_recv_queue\") of a host, that the health monitor "
+        "still considers healthy. 0 means no limit",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "queryResultCacheTtl", {"queryResultCacheTtl",
+        "1.0.9",
+        "Time in milliseconds, during which results of SELECT queries are kept in the cache shared by all connections, "
+        "and repeated queries get them without a round trip to the server. All cached results are dropped, when "
+        "any write is executed through the driver. Changes made by other clients, and writes made by stored "
+        "functions called from SELECT, are visible only after the time is over. 0 disables the cache",
+        false,
+        int32_t(0),
+        int32_t(0) }},
+      {
+        "queryResultCacheSize", {"queryResultCacheSize",
+        "1.0.9",
+        "Maximum size in bytes of results kept by the query result cache. Least recently used results are evicted "
+        "first. Results larger than that are not cached",
+        false,
+        int32_t(16777216),
+        int32_t(0) }}
     };
 
 //---------------------------------------- Aliases ------------------------------------------------------------------------------------
@@ -140,7 +140,20 @@ namespace mariadb
     OPTIONS_FIELD(useReadAheadInput),
     OPTIONS_FIELD(serverRsaPublicKeyFile),
     OPTIONS_FIELD(tlsPeerFP),
-    OPTIONS_FIELD(restrictedAuth)
+    OPTIONS_FIELD(restrictedAuth),
+    OPTIONS_FIELD(batchChunkSize),
+    OPTIONS_FIELD(metadataCacheTtl),
+    OPTIONS_FIELD(metadataCacheSize),
+    OPTIONS_FIELD(reprepareOnReconnect),
+    OPTIONS_FIELD(bulkLoadBufferSize),
+    OPTIONS_FIELD(serverStateCacheTtl),
+    OPTIONS_FIELD(clientPrepareCacheSize),
+    OPTIONS_FIELD(longDataChunkSize),
+    OPTIONS_FIELD(resultSetMemoryLimit),
+    OPTIONS_FIELD(galeraHealthCheckInterval),
+    OPTIONS_FIELD(galeraMaxReceiveQueue),
+    OPTIONS_FIELD(queryResultCacheTtl),
+    OPTIONS_FIELD(queryResultCacheSize)
   };
 
 
@@ -523,6 +536,45 @@ namespace mariadb
     if (!(restrictedAuth.compare(opt->restrictedAuth) == 0)) {
       return false;
     }
+    if (batchChunkSize != opt->batchChunkSize) {
+      return false;
+    }
+    if (metadataCacheTtl != opt->metadataCacheTtl) {
+      return false;
+    }
+    if (metadataCacheSize != opt->metadataCacheSize) {
+      return false;
+    }
+    if (reprepareOnReconnect != opt->reprepareOnReconnect) {
+      return false;
+    }
+    if (bulkLoadBufferSize != opt->bulkLoadBufferSize) {
+      return false;
+    }
+    if (serverStateCacheTtl != opt->serverStateCacheTtl) {
+      return false;
+    }
+    if (clientPrepareCacheSize != opt->clientPrepareCacheSize) {
+      return false;
+    }
+    if (longDataChunkSize != opt->longDataChunkSize) {
+      return false;
+    }
+    if (resultSetMemoryLimit != opt->resultSetMemoryLimit) {
+      return false;
+    }
+    if (galeraHealthCheckInterval != opt->galeraHealthCheckInterval) {
+      return false;
+    }
+    if (galeraMaxReceiveQueue != opt->galeraMaxReceiveQueue) {
+      return false;
+    }
+    if (queryResultCacheTtl != opt->queryResultCacheTtl) {
+      return false;
+    }
+    if (queryResultCacheSize != opt->queryResultCacheSize) {
+      return false;
+    }
     return minPoolSize == opt->minPoolSize;
   }
 
@@ -621,6 +673,19 @@ namespace mariadb
     result= 31*result + (!tlsPeerFPList.empty() ? tlsPeerFPList.hashCode() : 0);
     result= 31*result + (!restrictedAuth.empty() ? restrictedAuth.hashCode() : 0);
 
+    result= 31*result + batchChunkSize;
+    result= 31*result + metadataCacheTtl;
+    result= 31*result + metadataCacheSize;
+    result= 31*result + reprepareOnReconnect;
+    result= 31*result + bulkLoadBufferSize;
+    result= 31*result + serverStateCacheTtl;
+    result= 31*result + clientPrepareCacheSize;
+    result= 31*result + longDataChunkSize;
+    result= 31*result + resultSetMemoryLimit;
+    result= 31*result + galeraHealthCheckInterval;
+    result= 31*result + galeraMaxReceiveQueue;
+    result= 31*result + queryResultCacheTtl;
+    result= 31*result + queryResultCacheSize;
     return result;
   }
 
@@ -138,6 +138,19 @@ struct Options
   SQLString serverRsaPublicKeyFile;
   SQLString tlsPeerFP;
   SQLString restrictedAuth;
+  int32_t   batchChunkSize= 0;
+  int32_t   metadataCacheTtl= 0;
+  int32_t   metadataCacheSize= 256;
+  int32_t   reprepareOnReconnect= 0;
+  int32_t   bulkLoadBufferSize= 16777216;
+  int32_t   serverStateCacheTtl= 0;
+  int32_t   clientPrepareCacheSize= 256;
+  int32_t   longDataChunkSize= 1048576;
+  int32_t   resultSetMemoryLimit= 0;
+  int32_t   galeraHealthCheckInterval= 0;
+  int32_t   galeraMaxReceiveQueue= 0;
+  int32_t   queryResultCacheTtl= 0;
+  int32_t   queryResultCacheSize= 16777216;
 
   SQLString toString() const;
   bool      equals(Options* obj);
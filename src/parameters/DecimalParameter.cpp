@@ -0,0 +1,99 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include "DecimalParameter.h"
+
+namespace sql
+{
+namespace mariadb
+{
+
+  DecimalParameter::DecimalParameter(const Decimal& decimal)
+    : length(static_cast<uint32_t>(decimal.toChars(value)))
+  {
+  }
+
+
+  void DecimalParameter::writeTo(SQLString& str, capi::MYSQL*)
+  {
+    str.append(value, length);
+  }
+
+
+  void DecimalParameter::writeTo(PacketOutputStream& pos)
+  {
+    pos.write(value);
+  }
+
+
+  int64_t DecimalParameter::getApproximateTextProtocolLength()
+  {
+    return length;
+  }
+
+  /**
+    * Write data to socket in binary format.
+    *
+    * @param pos socket output stream
+    * @throws IOException if socket error occur
+    */
+  void DecimalParameter::writeBinary(PacketOutputStream& pos)
+  {
+    pos.writeFieldLength(length);
+    pos.write(value);
+  }
+
+
+  uint32_t DecimalParameter::writeBinary(sql::bytes& buffer)
+  {
+    if (buffer.size() < getValueBinLen())
+    {
+      throw SQLException("Parameter buffer size is too small for decimal value");
+    }
+    std::memcpy(buffer.arr, value, length);
+    return length;
+  }
+
+
+  const ColumnType& DecimalParameter::getColumnType() const
+  {
+    return ColumnType::DECIMAL;
+  }
+
+
+  SQLString DecimalParameter::toString()
+  {
+    return SQLString(value, length);
+  }
+
+
+  bool DecimalParameter::isNullData() const
+  {
+    return false;
+  }
+
+
+  bool DecimalParameter::isLongData()
+  {
+    return false;
+  }
+}
+}
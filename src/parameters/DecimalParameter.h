@@ -0,0 +1,57 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _DECIMALPARAMETER_H_
+#define _DECIMALPARAMETER_H_
+
+#include "Consts.h"
+#include "Decimal.hpp"
+
+#include "ParameterHolder.h"
+
+namespace sql
+{
+namespace mariadb
+{
+/* The value is formatted once, and the same characters are sent in text protocol, and bound as DECIMAL for the binary */
+class DecimalParameter  : public ParameterHolder {
+
+  char value[Decimal::BUFFER_SIZE];
+  uint32_t length;
+
+public:
+  DecimalParameter(const Decimal& decimal);
+  void writeTo(SQLString& str, capi::MYSQL*);
+  void writeTo(PacketOutputStream& pos);
+  int64_t getApproximateTextProtocolLength();
+  void writeBinary(PacketOutputStream& pos);
+  uint32_t writeBinary(sql::bytes& buffer);
+  const ColumnType& getColumnType() const;
+  SQLString toString();
+  bool isNullData() const;
+  bool isLongData();
+  void* getValuePtr() { return static_cast<void*>(value); }
+  unsigned long getValueBinLen() const { return length; }
+  };
+}
+}
+#endif
@@ -19,7 +19,7 @@
 
 
 #include "DoubleParameter.h"
-#include <iomanip>
+#include "util/FloatConversion.h"
 
 namespace sql
 {
@@ -35,20 +35,22 @@ namespace mariadb
   void DoubleParameter::writeTo(SQLString& str, capi::MYSQL*)
   {
     //std::to_string is not precise enough. at least on windows it does just sprintf("%f")
-    std::ostringstream doubleAsString("");
-    doubleAsString << std::scientific << std::setprecision(30) << value;
-    str.append(doubleAsString.str().c_str());
+    char asString[FloatConversion::BUFFER_SIZE];
+    str.append(asString, FloatConversion::format(value, asString));
   }
 
 
   void DoubleParameter:: writeTo(PacketOutputStream& pos)
   {
-    pos.write(std::to_string(value).c_str());
+    char asString[FloatConversion::BUFFER_SIZE];
+    FloatConversion::format(value, asString);
+    pos.write(asString);
   }
 
   int64_t DoubleParameter::getApproximateTextProtocolLength()
   {
-    return std::to_string(value).length();
+    char asString[FloatConversion::BUFFER_SIZE];
+    return static_cast<int64_t>(FloatConversion::format(value, asString));
   }
 
   /**
@@ -82,7 +84,8 @@ namespace mariadb
 
   SQLString DoubleParameter::toString()
   {
-    return std::to_string(value);
+    char asString[FloatConversion::BUFFER_SIZE];
+    return SQLString(asString, FloatConversion::format(value, asString));
   }
 
   bool DoubleParameter::isNullData() const
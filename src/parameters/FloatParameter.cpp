@@ -19,6 +19,7 @@
 
 
 #include "FloatParameter.h"
+#include "util/FloatConversion.h"
 
 namespace sql
 {
@@ -32,17 +33,21 @@ namespace mariadb
 
   void FloatParameter::writeTo(SQLString& str, capi::MYSQL*)
   {
-    str.append(std::to_string(value));
+    char asString[FloatConversion::BUFFER_SIZE];
+    str.append(asString, FloatConversion::format(value, asString));
   }
 
   void FloatParameter:: writeTo(PacketOutputStream& os)
   {
-    os.write(std::to_string(value).c_str());
+    char asString[FloatConversion::BUFFER_SIZE];
+    FloatConversion::format(value, asString);
+    os.write(asString);
   }
 
   int64_t FloatParameter::getApproximateTextProtocolLength()
   {
-    return std::to_string(value).length();
+    char asString[FloatConversion::BUFFER_SIZE];
+    return static_cast<int64_t>(FloatConversion::format(value, asString));
   }
 
   /**
@@ -75,7 +80,8 @@ namespace mariadb
 
   SQLString FloatParameter::toString()
   {
-    return std::to_string(value);
+    char asString[FloatConversion::BUFFER_SIZE];
+    return SQLString(asString, FloatConversion::format(value, asString));
   }
 
   bool FloatParameter::isNullData() const
@@ -48,28 +48,8 @@ namespace mariadb
   //
   void ReaderParameter::writeTo(SQLString& str, capi::MYSQL* handle)
   {
-    char buffer[8192];
-    size_t readMax= sizeof(buffer), readTotal= static_cast<size_t>(length);
-    std::streamsize readCount;
-
     str.append(QUOTE);
-
-    do {
-
-      if (readMax > readTotal)
-      {
-        readMax= readTotal;
-      }
-
-      readCount= reader.read(buffer, readMax).gcount();
-
-      if (readCount > 0)
-      {
-        readTotal-= static_cast<size_t>(readCount);
-        Utils::escapeData(handle, buffer, static_cast<size_t>(readCount), noBackslashEscapes, str);
-      }
-    } while (readTotal > 0 && readCount > 0);
-
+    Utils::escapeStream(handle, reader, length, noBackslashEscapes, str);
     str.append(QUOTE);
   }
 
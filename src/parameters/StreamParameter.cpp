@@ -55,27 +55,7 @@ namespace mariadb
       return;
     }
     str.append(BINARY_INTRODUCER);
-
-    char buffer[8192];
-    size_t readMax= sizeof(buffer), readTotal= static_cast<size_t>(length);
-    std::streamsize readCount;
-
-    do {
-
-      if (readMax > readTotal)
-      {
-        readMax= readTotal;
-      }
-
-      readCount= is.read(buffer, readMax).gcount();
-
-      if (readCount > 0)
-      {
-        readTotal-= static_cast<size_t>(readCount);
-        Utils::escapeData(handle, buffer, static_cast<size_t>(readCount), noBackslashEscapes, str);
-      }
-    } while (readTotal > 0 && readCount > 0);
-
+    Utils::escapeStream(handle, is, length, noBackslashEscapes, str);
     str.append(QUOTE);
   }
 
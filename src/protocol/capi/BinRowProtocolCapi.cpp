@@ -19,11 +19,14 @@
 
 
 #include <sstream>
+#include <cstring>
+#include <type_traits>
 
 #include "BinRowProtocolCapi.h"
 
 #include "ColumnDefinition.h"
 #include "ExceptionFactory.h"
+#include "util/FloatConversion.h"
 
 namespace sql
 {
@@ -31,6 +34,60 @@ namespace mariadb
 {
 namespace capi
 {
+namespace
+{
+  /* Numeric values come in the host byte order, in buffers of the type's size */
+  template <typename Src>
+  inline Src readNative(RowProtocol* row)
+  {
+    Src value;
+    std::memcpy(&value, row->fieldBuf.arr, sizeof(Src));
+    return value;
+  }
+
+
+  template <typename Src, typename T>
+  T binaryInteger(RowProtocol* row, ColumnDefinition* columnInfo)
+  {
+    typename std::conditional<std::is_signed<Src>::value, int64_t, uint64_t>::type value= readNative<Src>(row);
+
+    if (!RowProtocol::fitsInto<T>(value)) {
+      RowProtocol::throwOutOfRange(columnInfo, std::to_string(value), RowProtocol::TypeName<T>::get());
+    }
+    return static_cast<T>(value);
+  }
+
+
+  template <typename Src, typename T>
+  T binaryNumber(RowProtocol* row, ColumnDefinition*)
+  {
+    return static_cast<T>(readNative<Src>(row));
+  }
+
+
+  template <typename Src>
+  RowProtocol::ColumnDecoders integerDecoders()
+  {
+    RowProtocol::ColumnDecoders decoders;
+    decoders.toInt=    &binaryInteger<Src, int32_t>;
+    decoders.toLong=   &binaryInteger<Src, int64_t>;
+    decoders.toULong=  &binaryInteger<Src, uint64_t>;
+    decoders.toFloat=  &binaryNumber<Src, float>;
+    decoders.toDouble= &binaryNumber<Src, long double>;
+    return decoders;
+  }
+
+  /* Conversions of floating point values to integers have their own range checks, and stay generic */
+  template <typename Src>
+  RowProtocol::ColumnDecoders floatingDecoders()
+  {
+    RowProtocol::ColumnDecoders decoders;
+    decoders.toFloat=  &binaryNumber<Src, float>;
+    decoders.toDouble= &binaryNumber<Src, long double>;
+    return decoders;
+  }
+}
+
   /**
     * Constructor.
     *
@@ -51,11 +108,11 @@ namespace capi
      , stmt(capiStmtHandle)
   {
      bind.reserve(mysql_stmt_field_count(stmt));
+     longData.resize(columnInformation.size());
+     longDataFetched.resize(columnInformation.size(), false);
 
      for (auto& columnInfo : columnInformation)
      {
-       length= columnInfo->getLength();
-       maxFieldSize= columnInfo->getMaxLength();
        //TODO maybe change property type in the ColumnInfo?
        bind.emplace_back();
 
@@ -63,9 +120,12 @@ namespace capi
        if (bind.back().buffer_type == MYSQL_TYPE_VARCHAR) {
          bind.back().buffer_type= MYSQL_TYPE_STRING;
        }
+       // Max length of values in the resultset is not calculated(that would require extra pass over all rows), thus
+       // variable length columns get buffers of limited size, and longer values are fetched when they are read. The
+       // buffer then grows, so that following values of such length are fetched with the row
        bind.back().buffer_length= static_cast<unsigned long>(columnInfo->getColumnType().binarySize() != 0 ?
                                                          columnInfo->getColumnType().binarySize() :
-                                                         getLengthMaxFieldSize());
+                                                         std::max(1U, std::min(columnInfo->getLength(), INITIAL_BOUND_BUFFER_LENGTH)));
        bind.back().buffer=        new uint8_t[bind.back().buffer_length];
        bind.back().length=        &bind.back().length_value;
        bind.back().is_null=       &bind.back().is_null_value;
@@ -75,6 +135,7 @@ namespace capi
      if (mysql_stmt_bind_result(stmt, bind.data())) {
        throwStmtError(stmt);
      }
+     buildDecoderPlan(columnInformation);
   }
 
 
@@ -86,6 +147,46 @@ namespace capi
      }
    }
 
+  /**
+    * Picks decoders by the native type of the column values in the bound buffers.
+    *
+    * @param columns column information
+    */
+  void BinRowProtocolCapi::buildDecoderPlan(const std::vector<Shared::ColumnDefinition>& columns)
+  {
+    decoderPlan.clear();
+    decoderPlan.reserve(columns.size());
+
+    for (auto& columnInfo : columns) {
+      bool isSigned= columnInfo->isSigned();
+
+      switch (columnInfo->getColumnType().getType()) {
+      case MYSQL_TYPE_TINY:
+        decoderPlan.push_back(isSigned ? integerDecoders<int8_t>() : integerDecoders<uint8_t>());
+        break;
+      case MYSQL_TYPE_SHORT:
+      case MYSQL_TYPE_YEAR:
+        decoderPlan.push_back(isSigned ? integerDecoders<int16_t>() : integerDecoders<uint16_t>());
+        break;
+      case MYSQL_TYPE_LONG:
+      case MYSQL_TYPE_INT24:
+        decoderPlan.push_back(isSigned ? integerDecoders<int32_t>() : integerDecoders<uint32_t>());
+        break;
+      case MYSQL_TYPE_LONGLONG:
+        decoderPlan.push_back(isSigned ? integerDecoders<int64_t>() : integerDecoders<uint64_t>());
+        break;
+      case MYSQL_TYPE_FLOAT:
+        decoderPlan.push_back(floatingDecoders<float>());
+        break;
+      case MYSQL_TYPE_DOUBLE:
+        decoderPlan.push_back(floatingDecoders<double>());
+        break;
+      default:
+        decoderPlan.emplace_back();
+      }
+    }
+  }
+
   /**
     * Set length and pos indicator to requested index.
     *
@@ -105,20 +206,111 @@ namespace capi
     }
     else {
       length = bind[index].length_value;
-      fieldBuf.wrap(static_cast<char*>(bind[index].buffer), length);
+      if (length > bind[index].buffer_length && !bind[index].is_null_value) {
+        fetchLongData(index);
+        fieldBuf.wrap(longData[index].data(), length);
+      }
+      else {
+        fieldBuf.wrap(static_cast<char*>(bind[index].buffer), length);
+      }
       this->lastValueNull = bind[index].is_null_value ? BIT_LAST_FIELD_NULL : BIT_LAST_FIELD_NOT_NULL;
     }
   }
 
+  /**
+    * Positions on the column for reading its value in parts, if the value did not fit the bound buffer and is not
+    * fetched yet.
+    *
+    * @param newIndex index (0 is first)
+    * @return buffer reading the value in chunks of longDataChunkSize, or nullptr if the value is already in memory
+    */
+  std::unique_ptr<std::streambuf> BinRowProtocolCapi::getInternalStreamBuffer(int32_t newIndex)
+  {
+    const MYSQL_BIND& columnBind= bind[newIndex];
+
+    if (buf != nullptr || columnBind.is_null_value || columnBind.length_value <= columnBind.buffer_length ||
+      longDataFetched[newIndex]) {
+      return std::unique_ptr<std::streambuf>();
+    }
+    lastValueNull= BIT_LAST_FIELD_NOT_NULL;
+
+    return std::unique_ptr<std::streambuf>(new LongDataStreamBuf(*this, stmt, columnBind, static_cast<unsigned int>(newIndex),
+      static_cast<std::size_t>(std::max(1, options->longDataChunkSize))));
+  }
+
+  /**
+    * Fetches from the current row the value, that did not fit the bound buffer.
+    *
+    * @param columnIndex index of the column (0 is first)
+    */
+  void BinRowProtocolCapi::fetchLongData(int32_t columnIndex)
+  {
+    if (longDataFetched[columnIndex]) {
+      return;
+    }
+    MYSQL_BIND& columnBind= bind[columnIndex];
+    std::vector<char>& columnData= longData[columnIndex];
+    MYSQL_BIND longBind(columnBind);
+
+    columnData.resize(columnBind.length_value);
+    longBind.buffer= columnData.data();
+    longBind.buffer_length= columnBind.length_value;
+    longBind.length= &longBind.length_value;
+    longBind.is_null= &longBind.is_null_value;
+    longBind.error= &longBind.error_value;
+
+    if (mysql_stmt_fetch_column(stmt, &longBind, static_cast<unsigned int>(columnIndex), 0)) {
+      throwStmtError(stmt);
+    }
+    longDataFetched[columnIndex]= true;
+    anyLongDataFetched= true;
+
+    if (columnBind.length_value <= MAX_BOUND_BUFFER_LENGTH) {
+      growBoundBuffer(columnIndex);
+    }
+  }
+
+  /**
+    * Replaces the bound buffer of the column with the one fitting the current value, that has been fetched into
+    * longData. The value is copied to the new buffer, and the result is re-bound, so that next rows get values of
+    * this length with mysql_stmt_fetch, without extra mysql_stmt_fetch_column call.
+    *
+    * @param columnIndex index of the column (0 is first)
+    */
+  void BinRowProtocolCapi::growBoundBuffer(int32_t columnIndex)
+  {
+    MYSQL_BIND& columnBind= bind[columnIndex];
+    unsigned long newLength= std::min(std::max(columnBind.length_value, 2*columnBind.buffer_length),
+                                      static_cast<unsigned long>(MAX_BOUND_BUFFER_LENGTH));
+    uint8_t* newBuffer= new uint8_t[newLength];
+
+    std::memcpy(newBuffer, longData[columnIndex].data(), columnBind.length_value);
+    delete[] static_cast<uint8_t*>(columnBind.buffer);
+    columnBind.buffer= newBuffer;
+    columnBind.buffer_length= newLength;
+
+    if (mysql_stmt_bind_result(stmt, bind.data())) {
+      throwStmtError(stmt);
+    }
+  }
+
 
   int32_t BinRowProtocolCapi::fetchNext()
   {
-    return mysql_stmt_fetch(stmt);
+    ++rowGeneration;
+    if (anyLongDataFetched) {
+      longDataFetched.assign(longDataFetched.size(), false);
+      anyLongDataFetched= false;
+    }
+    int32_t rc= mysql_stmt_fetch(stmt);
+    // Truncation here only means, that the value did not fit the bound buffer. It's fetched from the row, when needed
+    return rc == MYSQL_DATA_TRUNCATED ? 0 : rc;
   }
 
 
   void BinRowProtocolCapi::installCursorAtPosition(int32_t rowPtr)
   {
+    ++rowGeneration;
     mysql_stmt_data_seek(stmt, static_cast<unsigned long long>(rowPtr));
   }
 
@@ -235,6 +427,9 @@ namespace capi
     if (lastValueWasNull()) {
       return 0;
     }
+    if (auto decode= decoder(&ColumnDecoders::toInt)) {
+      return decode(this, columnInfo);
+    }
 
     int64_t value;
 
@@ -316,6 +511,9 @@ namespace capi
     if (lastValueWasNull()) {
       return 0;
     }
+    if (auto decode= decoder(&ColumnDecoders::toLong)) {
+      return decode(this, columnInfo);
+    }
 
     int64_t value= 0;
 
@@ -434,6 +632,9 @@ namespace capi
     if (lastValueWasNull()) {
       return 0;
     }
+    if (auto decode= decoder(&ColumnDecoders::toULong)) {
+      return decode(this, columnInfo);
+    }
 
     int64_t value;
 
@@ -559,6 +760,9 @@ namespace capi
     if (lastValueWasNull()) {
       return 0;
     }
+    if (auto decode= decoder(&ColumnDecoders::toFloat)) {
+      return decode(this, columnInfo);
+    }
 
     int64_t value;
     switch (columnInfo->getColumnType().getType()) {
@@ -594,8 +798,9 @@ namespace capi
     case MYSQL_TYPE_STRING:
     case MYSQL_TYPE_DECIMAL:
       try {
-        char* end;
-        return std::strtof(static_cast<char*>(fieldBuf.arr), &end);
+        float result= 0;
+        FloatConversion::parse(fieldBuf.arr, fieldBuf.size(), result);
+        return result;
         // if (errno == ERANGE) ?
       }
       // Common parent for std::invalid_argument and std::out_of_range
@@ -627,6 +832,9 @@ namespace capi
     if (lastValueWasNull()) {
       return 0;
     }
+    if (auto decode= decoder(&ColumnDecoders::toDouble)) {
+      return decode(this, columnInfo);
+    }
     switch (columnInfo->getColumnType().getType()) {
     case MYSQL_TYPE_BIT:
       return static_cast<long double>(parseBit());
@@ -723,6 +931,53 @@ namespace capi
     }
   }
 
+  /**
+    * Get Decimal from raw binary format, without creating intermediate strings.
+    *
+    * @param columnInfo column information
+    * @return decimal value
+    * @throws SQLException if column type doesn't permit conversion or the value is not a number
+    */
+  Decimal BinRowProtocolCapi::getInternalDecimal(ColumnDefinition* columnInfo)
+  {
+    if (lastValueWasNull()) {
+      return Decimal();
+    }
+    switch (columnInfo->getColumnType().getType()) {
+    case MYSQL_TYPE_BIT:
+      return Decimal(parseBit());
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_YEAR:
+    case MYSQL_TYPE_LONG:
+    case MYSQL_TYPE_INT24:
+      return Decimal(getInternalLong(columnInfo));
+    case MYSQL_TYPE_LONGLONG:
+      if (columnInfo->isSigned()) {
+        return Decimal(getInternalLong(columnInfo));
+      }
+      return Decimal::fromUnsigned(getInternalULong(columnInfo));
+    case MYSQL_TYPE_FLOAT:
+    {
+      // Shortest representation of the float, and not of its double extension
+      char asString[FloatConversion::BUFFER_SIZE];
+      return Decimal(asString, FloatConversion::format(getInternalFloat(columnInfo), asString));
+    }
+    case MYSQL_TYPE_DOUBLE:
+      return Decimal::fromDouble(*reinterpret_cast<double*>(fieldBuf.arr));
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_VARCHAR:
+    case MYSQL_TYPE_STRING:
+      return Decimal(fieldBuf.arr, length);
+    default:
+      throw SQLException(
+        "getDecimal not available for data field type "
+        +columnInfo->getColumnType().getCppTypeName());
+    }
+  }
+
 
   bool isNullTimeStruct(MYSQL_TIME* mt, enum_field_types type)
   {
@@ -1707,15 +1962,147 @@ namespace capi
   void BinRowProtocolCapi::cacheCurrentRow(std::vector<sql::bytes>& rowDataCache, std::size_t columnCount)
   {
     rowDataCache.clear();
+    int32_t columnIndex= 0;
     for (auto& b : bind) {
       if (b.is_null_value != '\0') {
         rowDataCache.emplace_back(0);
       }
+      else if (b.length_value > b.buffer_length) {
+        fetchLongData(columnIndex);
+        rowDataCache.emplace_back(longData[columnIndex].data(), b.length_value);
+      }
       else {
         // C/C resets length for fixed size types, so we need to use buffer_lenght in such case as it should be equal to the that fixed size.
         rowDataCache.emplace_back(static_cast<const char*>(b.buffer), b.length_value ? b.length_value : b.buffer_length);
       }
+      ++columnIndex;
+    }
+  }
+
+
+  LongDataStreamBuf::LongDataStreamBuf(const BinRowProtocolCapi& _row, MYSQL_STMT* _stmt, const MYSQL_BIND& columnBind,
+    unsigned int _column, std::size_t chunkSize)
+    : row(_row)
+    , rowGeneration(_row.rowGeneration)
+    , stmt(_stmt)
+    , bind(columnBind)
+    , column(_column)
+    , length(columnBind.length_value)
+    , chunk(std::min(chunkSize, length))
+  {
+    bind.length= &bind.length_value;
+    bind.is_null= &bind.is_null_value;
+    bind.error= &bind.error_value;
+    setg(chunk.data(), chunk.data(), chunk.data());
+  }
+
+  /* Fetches up to size bytes of the value, starting from the offset "from", to dest. Returns the number of bytes fetched */
+  std::size_t LongDataStreamBuf::fetch(char* dest, std::size_t size, std::size_t from)
+  {
+    if (row.rowGeneration != rowGeneration || from >= length) {
+      return 0;
     }
+    size= std::min(size, length - from);
+    bind.buffer= dest;
+    bind.buffer_length= static_cast<unsigned long>(size);
+
+    // Truncation error here is expected - only the part of the value fitting the buffer is needed
+    if (mysql_stmt_fetch_column(stmt, &bind, column, static_cast<unsigned long>(from))) {
+      throwStmtError(stmt);
+    }
+    return size;
+  }
+
+
+  LongDataStreamBuf::int_type LongDataStreamBuf::underflow()
+  {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    offset+= egptr() - eback();
+    std::size_t fetched= fetch(chunk.data(), chunk.size(), offset);
+    setg(chunk.data(), chunk.data(), chunk.data() + fetched);
+
+    return fetched > 0 ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+  }
+
+
+  std::streamsize LongDataStreamBuf::xsgetn(char_type* s, std::streamsize count)
+  {
+    std::streamsize done= std::min<std::streamsize>(count, egptr() - gptr());
+
+    if (done > 0) {
+      std::memcpy(s, gptr(), static_cast<std::size_t>(done));
+      gbump(static_cast<int>(done));
+    }
+    if (done == count) {
+      return done;
+    }
+    if (static_cast<std::size_t>(count - done) < chunk.size()) {
+      return done + std::streambuf::xsgetn(s + done, count - done);
+    }
+    // Reads not smaller than the chunk go directly to the caller's buffer
+    std::size_t position= offset + (egptr() - eback());
+    std::size_t fetched= fetch(s + done, static_cast<std::size_t>(count - done), position);
+
+    offset= position + fetched;
+    setg(chunk.data(), chunk.data(), chunk.data());
+
+    return done + static_cast<std::streamsize>(fetched);
+  }
+
+
+  std::streamsize LongDataStreamBuf::showmanyc()
+  {
+    std::size_t position= offset + (gptr() - eback());
+
+    if (row.rowGeneration != rowGeneration || position >= length) {
+      return -1;
+    }
+    return static_cast<std::streamsize>(length - position);
+  }
+
+
+  LongDataStreamBuf::pos_type LongDataStreamBuf::seekTo(std::size_t position)
+  {
+    if (position > length) {
+      return pos_type(off_type(-1));
+    }
+    if (position >= offset && position <= offset + (egptr() - eback())) {
+      setg(eback(), eback() + (position - offset), egptr());
+    }
+    else {
+      offset= position;
+      setg(chunk.data(), chunk.data(), chunk.data());
+    }
+    return pos_type(static_cast<off_type>(position));
+  }
+
+
+  LongDataStreamBuf::pos_type LongDataStreamBuf::seekoff(off_type off, std::ios_base::seekdir direction, std::ios_base::openmode which)
+  {
+    if ((which & std::ios_base::in) == 0) {
+      return pos_type(off_type(-1));
+    }
+    off_type base= static_cast<off_type>(length);
+
+    if (direction == std::ios_base::beg) {
+      base= 0;
+    }
+    else if (direction == std::ios_base::cur) {
+      base= static_cast<off_type>(offset + (gptr() - eback()));
+    }
+
+    if (base + off < 0) {
+      return pos_type(off_type(-1));
+    }
+    return seekTo(static_cast<std::size_t>(base + off));
+  }
+
+
+  LongDataStreamBuf::pos_type LongDataStreamBuf::seekpos(pos_type position, std::ios_base::openmode which)
+  {
+    return seekoff(off_type(position), std::ios_base::beg, which);
   }
 }
 }
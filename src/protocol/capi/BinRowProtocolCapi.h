@@ -35,12 +35,61 @@ namespace capi
 {
 #include "mysql.h"
 
+class BinRowProtocolCapi;
+
+/**
+ * Reads the value of a column of the current row, that did not fit the bound buffer, in chunks into a reusable
+ * buffer, without copying the whole value. Once the next row is fetched, the buffer reports the end of the stream.
+ */
+class LongDataStreamBuf : public std::streambuf
+{
+  const BinRowProtocolCapi& row;
+  const uint64_t rowGeneration;
+  MYSQL_STMT* stmt;
+  MYSQL_BIND bind;
+  const unsigned int column;
+  const std::size_t length;
+  /* Offset in the value of the chunk in the get area */
+  std::size_t offset= 0;
+  std::vector<char> chunk;
+
+  std::size_t fetch(char* dest, std::size_t size, std::size_t from);
+  pos_type seekTo(std::size_t position);
+
+public:
+  LongDataStreamBuf(const BinRowProtocolCapi& row, MYSQL_STMT* stmt, const MYSQL_BIND& columnBind, unsigned int column,
+    std::size_t chunkSize);
+
+protected:
+  int_type underflow() override;
+  std::streamsize xsgetn(char_type* s, std::streamsize count) override;
+  std::streamsize showmanyc() override;
+  pos_type seekoff(off_type off, std::ios_base::seekdir direction, std::ios_base::openmode which) override;
+  pos_type seekpos(pos_type position, std::ios_base::openmode which) override;
+};
+
+
 class BinRowProtocolCapi : public RowProtocol {
+  friend class LongDataStreamBuf;
 
   const std::vector<Shared::ColumnDefinition>& columnInformation;
   int32_t columnInformationLength;
   MYSQL_STMT* stmt;
   std::vector<MYSQL_BIND> bind;
+  /* Values, that did not fit the bound buffers, are fetched on demand into these buffers */
+  std::vector<std::vector<char>> longData;
+  std::vector<bool> longDataFetched;
+  bool anyLongDataFetched= false;
+  /* Changes every time the handle moves to another row */
+  uint64_t rowGeneration= 0;
+
+  /* Variable length columns start with buffers of at most this size, that grow to the longest value read from the
+     column, up to MAX_BOUND_BUFFER_LENGTH */
+  static const uint32_t INITIAL_BOUND_BUFFER_LENGTH= 2048;
+  static const uint32_t MAX_BOUND_BUFFER_LENGTH= 1024*1024;
+
+  void fetchLongData(int32_t columnIndex);
+  void growBoundBuffer(int32_t columnIndex);
 
   SQLString * convertToString(const char * asChar, ColumnDefinition * columnInfo);
 public:
@@ -68,6 +117,7 @@ public:
   void installCursorAtPosition(int32_t rowPtr);
 
   std::unique_ptr<SQLString> getInternalString(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
+  std::unique_ptr<std::streambuf> getInternalStreamBuffer(int32_t newIndex) override;
   Date getInternalDate(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Time> getInternalTime(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Timestamp> getInternalTimestamp( ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
@@ -78,6 +128,7 @@ public:
   float getInternalFloat(ColumnDefinition* columnInfo);
   long double getInternalDouble(ColumnDefinition* columnInfo);
   std::unique_ptr<BigDecimal> getInternalBigDecimal(ColumnDefinition* columnInfo);
+  Decimal getInternalDecimal(ColumnDefinition* columnInfo);
 
   bool getInternalBoolean(ColumnDefinition* columnInfo);
   int8_t getInternalByte(ColumnDefinition* columnInfo);
@@ -85,6 +136,7 @@ public:
   SQLString getInternalTimeString(ColumnDefinition* columnInfo);
 
   bool isBinaryEncoded();
+  void buildDecoderPlan(const std::vector<Shared::ColumnDefinition>& columns) override;
   void cacheCurrentRow(std::vector<sql::bytes>& rowData, std::size_t columnCount) override;
   };
 
@@ -25,11 +25,16 @@
 #include "ConnectProtocol.h"
 
 #include "logger/LoggerFactory.h"
+#include "logger/Tracer.h"
 #include "protocol/MasterProtocol.h"
 #include "Results.h"
+#include "SelectResultSet.h"
 #include "ExceptionFactory.h"
 #include "util/Utils.h"
 #include "util/LogQueryTool.h"
+#include "util/Metrics.h"
+#include "cache/ServerStateCache.h"
+#include "failover/ClusterHealthMonitor.h"
 
 
 namespace sql
@@ -54,6 +59,8 @@ namespace capi
   ConnectProtocol::~ConnectProtocol()
   {
     if (connection) {
+      cacheStoredResults();
+      closeReleasedLeases();
       mysql_close(connection);
     }
   }
@@ -79,6 +86,9 @@ namespace capi
     , currentHost(localhost, 3306)
   {
     urlParser->auroraPipelineQuirks();
+    if (options->galeraHealthCheckInterval > 0 && urlParser->getHostAddresses().size() > 1) {
+      healthMonitor= ClusterHealthMonitor::get(*urlParser);
+    }
     if (options->cachePrepStmts && options->useServerPrepStmts){
       //ServerPrepareStatementCache::newInstance(options->prepStmtCacheSize, this);
     }
@@ -88,6 +98,8 @@ namespace capi
   void ConnectProtocol::closeSocket()
   {
     try {
+      cacheStoredResults();
+      closeReleasedLeases();
       mysql_close(connection);
       connection= nullptr;
     }catch (std::exception& ){
@@ -188,13 +200,9 @@ namespace capi
       capabilities|= MariaDbServerCapabilities::CLIENT_DEPRECATE_EOF;
     }
 
-    if (options->useCompression){
-      if ((serverCapabilities &MariaDbServerCapabilities::COMPRESS)==0){
-
-        options->useCompression= false;
-      }else {
-        capabilities|= MariaDbServerCapabilities::COMPRESS;
-      }
+    // Compression is requested only if the server supports it
+    if (options->useCompression && (serverCapabilities &MariaDbServerCapabilities::COMPRESS) != 0){
+      capabilities|= MariaDbServerCapabilities::COMPRESS;
     }
 
     if (options->interactiveClient){
@@ -265,6 +273,7 @@ namespace capi
   /** Closes socket and stream readers/writers Attempts graceful shutdown. */
   void ConnectProtocol::close()
   {
+    TraceSpan span("close", &serverThreadId);
     this->connected= false;
     try {
       // skip acquires lock
@@ -397,6 +406,7 @@ namespace capi
 
   void ConnectProtocol::createConnection(HostAddress* hostAddress, const SQLString& username)
   {
+    TraceSpan span("connect", &serverThreadId);
 
     SQLString host(hostAddress != nullptr ? hostAddress->host : "");
     int32_t port= hostAddress != nullptr ? hostAddress->port :3306;
@@ -517,6 +527,8 @@ namespace capi
   void ConnectProtocol::destroySocket()
   {
     if (connection) {
+      cacheStoredResults();
+      closeReleasedLeases();
       mysql_close(connection);
       connection= nullptr;
     }
@@ -671,7 +683,21 @@ namespace capi
 
       if (mustLoadAdditionalInfo){
         std::map<SQLString,SQLString> serverData;
-        if (options->usePipelineAuth && !options->createDatabaseIfNotExist){
+        std::string stateKey;
+        bool stateCached= false;
+
+        if (options->serverStateCacheTtl > 0) {
+          // Pipe and socket connections do not use host and port
+          const SQLString& endpoint= !options->pipe.empty() ? options->pipe :
+            (!options->localSocket.empty() ? options->localSocket : currentHost.host);
+          stateKey= ServerStateCache::makeKey(endpoint, currentHost.port, username, options->sessionVariables);
+          stateCached= ServerStateCache::getInstance().get(stateKey, serverData);
+        }
+
+        if (stateCached) {
+          sessionData();
+        }
+        else if (options->usePipelineAuth && !options->createDatabaseIfNotExist){
           try {
             sendPipelineAdditionalData();
             readPipelineAdditionalData(serverData);
@@ -687,14 +713,19 @@ namespace capi
           additionalData(serverData);
         }
 
-        std::size_t maxAllowedPacket= static_cast<std::size_t>(std::stoi(StringImp::get(serverData["max_allowed_packet"])));
-        mysql_optionsv(connection, MYSQL_OPT_MAX_ALLOWED_PACKET, &maxAllowedPacket);
+        maxAllowedPacket= std::stoll(StringImp::get(serverData["max_allowed_packet"]));
+        std::size_t maxPacket= static_cast<std::size_t>(maxAllowedPacket);
+        mysql_optionsv(connection, MYSQL_OPT_MAX_ALLOWED_PACKET, &maxPacket);
         autoIncrementIncrement= std::stoi(StringImp::get(serverData["auto_increment_increment"]));
         loadCalendar(serverData["time_zone"],serverData["system_time_zone"]);
 
+        if (!stateCached && !stateKey.empty()) {
+          ServerStateCache::getInstance().put(stateKey, serverData, options->serverStateCacheTtl);
+        }
       }else {
-        size_t maxAllowedPacket= static_cast<size_t>(globalInfo->getMaxAllowedPacket());
-        mysql_optionsv(connection, MYSQL_OPT_MAX_ALLOWED_PACKET, &maxAllowedPacket);
+        maxAllowedPacket= globalInfo->getMaxAllowedPacket();
+        size_t maxPacket= static_cast<size_t>(maxAllowedPacket);
+        mysql_optionsv(connection, MYSQL_OPT_MAX_ALLOWED_PACKET, &maxPacket);
         autoIncrementIncrement= globalInfo->getAutoIncrementIncrement();
         loadCalendar(globalInfo->getTimeZone(), globalInfo->getSystemTimeZone());
       }
@@ -853,9 +884,7 @@ namespace capi
       ResultSet* resultSet= results->getResultSet();
       if (resultSet){
         while (resultSet->next()){
-          if (logger->isDebugEnabled()){
-            logger->debug("server data " + resultSet->getString(1) + " = " + resultSet->getString(2));
-          }
+          LOGGER_DEBUG(logger, "server data " + resultSet->getString(1) + " = " + resultSet->getString(2));
           serverData.emplace(resultSet->getString(1),resultSet->getString(2));
         }
         if (serverData.size()<4){
@@ -886,6 +915,24 @@ namespace capi
     sendPipelineCheckMaster();
     readPipelineCheckMaster();
 
+    createDatabaseIfNotExist();
+  }
+
+  /**
+   * Sets up the session only. Used when server variables are known from the server state cache
+   */
+  void ConnectProtocol::sessionData()
+  {
+    Unique::Results res(new Results());
+    sendSessionInfos();
+    getResult(res.get());
+
+    createDatabaseIfNotExist();
+  }
+
+
+  void ConnectProtocol::createDatabaseIfNotExist()
+  {
     if (options->createDatabaseIfNotExist && !database.empty()){
 
       SQLString quotedDb(MariaDbConnection::quoteIdentifier(this->database));
@@ -1094,6 +1141,9 @@ namespace capi
       static auto rnd= std::default_random_engine{};
       std::shuffle(hosts.begin(), hosts.end(), rnd);
     }
+    if (healthMonitor) {
+      healthMonitor->excludeUnhealthy(hosts);
+    }
 
     if (hosts.empty() && !options->pipe.empty()){
       try {
@@ -1366,6 +1416,123 @@ namespace capi
     }
   }
 
+  /**
+   * Registers buffered binary result, that reads rows directly from the statement handle.
+   *
+   * @param stmt statement handle, that has stored the result
+   * @param rs the resultset
+   */
+  void ConnectProtocol::registerStoredResult(MYSQL_STMT* stmt, SelectResultSet* rs)
+  {
+    storedResults[stmt]= rs;
+  }
+
+
+  void ConnectProtocol::unregisterStoredResult(MYSQL_STMT* stmt, SelectResultSet* rs)
+  {
+    auto it= storedResults.find(stmt);
+    if (it != storedResults.end() && it->second == rs) {
+      storedResults.erase(it);
+    }
+    auto lease= leasedHandles.find(stmt);
+    if (lease != leasedHandles.end()) {
+      leasedHandles.erase(lease);
+      releasedLeases.push_back(stmt);
+    }
+  }
+
+  /**
+   * Checks if the statement handle still has a cursor result reading rows from it.
+   *
+   * @param stmt statement handle
+   */
+  bool ConnectProtocol::isHandleBusy(MYSQL_STMT* stmt)
+  {
+    auto it= storedResults.find(stmt);
+    return it != storedResults.end() && !it->second->isFullyLoaded();
+  }
+
+  /**
+   * Passes the ownership of the statement handle to the result reading it. The handle is closed after the result is
+   * read to the end or closed.
+   *
+   * @param stmt statement handle
+   */
+  void ConnectProtocol::leaseHandle(MYSQL_STMT* stmt)
+  {
+    leasedHandles.insert(stmt);
+  }
+
+  /**
+   * Closes leased statement handles, that are not used anymore. <i>Lock must be set before using this method</i>
+   */
+  void ConnectProtocol::closeReleasedLeases()
+  {
+    for (auto stmt : releasedLeases) {
+      mysql_stmt_close(stmt);
+    }
+    releasedLeases.clear();
+  }
+
+  /**
+   * Closes the statement handle, that has been replaced after reconnection. Buffered results reading rows from it copy
+   * them first. A cursor result can't fetch from it anymore, and fails on the next fetch. The handle is leased to
+   * such result, and is closed when the result is closed. <i>Lock must be set before using this method</i>
+   *
+   * @param stmt invalidated statement handle
+   */
+  void ConnectProtocol::closeInvalidatedHandle(MYSQL_STMT* stmt)
+  {
+    if (stmt == nullptr) {
+      return;
+    }
+    if (isHandleBusy(stmt)) {
+      leaseHandle(stmt);
+      return;
+    }
+    cacheStoredResults(stmt);
+    // The handle is not attached to the connection anymore, thus nothing is sent to the server
+    mysql_stmt_close(stmt);
+  }
+
+  /**
+   * Makes registered buffered binary results to copy their rows, since the statement handle is going to be re-executed,
+   * moved to the next result or closed.
+   *
+   * @param stmt statement handle. nullptr means all registered results have to be cached
+   */
+  void ConnectProtocol::cacheStoredResults(MYSQL_STMT* stmt)
+  {
+    std::vector<SelectResultSet*> toCache;
+
+    if (stmt == nullptr) {
+      for (auto& it : storedResults) {
+        toCache.push_back(it.second);
+      }
+      storedResults.clear();
+    }
+    else {
+      auto it= storedResults.find(stmt);
+      if (it == storedResults.end()) {
+        return;
+      }
+      toCache.push_back(it->second);
+      storedResults.erase(it);
+    }
+
+    for (auto rs : toCache) {
+      try {
+        rs->cacheCompleteLocally();
+      }
+      catch (SQLException& e) {
+        LOGGER_DEBUG(logger, SQLString("Could not cache the resultset locally: ") + e.getMessage());
+        // The result must not read from the handle anymore
+        rs->abort();
+      }
+    }
+  }
+
+
   Shared::mutex& ConnectProtocol::getLock()
   {
     return lock;
@@ -1447,6 +1614,8 @@ namespace capi
      Process error and throws execution with error info */
   void ConnectProtocol::realQuery(const SQLString& sql)
   {
+    Metrics::increment(Metrics::ROUND_TRIPS);
+    Metrics::increment(Metrics::PAYLOAD_BYTES_SENT, sql.length());
     if (capi::mysql_real_query(connection, sql.c_str(), static_cast<unsigned long>(sql.length()))) {
       throw SQLException(capi::mysql_error(connection), capi::mysql_sqlstate(connection),
                         capi::mysql_errno(connection));
@@ -1469,6 +1638,8 @@ namespace capi
 
   void ConnectProtocol::sendQuery(const SQLString & sql)
   {
+    Metrics::increment(Metrics::ROUND_TRIPS);
+    Metrics::increment(Metrics::PAYLOAD_BYTES_SENT, sql.length());
     if (capi::mysql_send_query(connection, sql.c_str(), static_cast<unsigned long>(sql.length()))) {
       throw SQLException(capi::mysql_error(connection), capi::mysql_sqlstate(connection),
         capi::mysql_errno(connection));
@@ -1478,6 +1649,8 @@ namespace capi
 
   void ConnectProtocol::sendQuery(const char * sql, std::size_t length)
   {
+    Metrics::increment(Metrics::ROUND_TRIPS);
+    Metrics::increment(Metrics::PAYLOAD_BYTES_SENT, length);
     if (capi::mysql_send_query(connection, sql, static_cast<unsigned long>(length))) {
       throw SQLException(capi::mysql_error(connection), capi::mysql_sqlstate(connection),
         capi::mysql_errno(connection));
@@ -1498,6 +1671,8 @@ namespace capi
      object if we have const char literal */
   void ConnectProtocol::realQuery(const char* sql, std::size_t len)
   {
+    Metrics::increment(Metrics::ROUND_TRIPS);
+    Metrics::increment(Metrics::PAYLOAD_BYTES_SENT, len);
     if (capi::mysql_real_query(connection, sql, static_cast<unsigned long>(len))) {
       throw SQLException(capi::mysql_error(connection), capi::mysql_sqlstate(connection),
                         capi::mysql_errno(connection));
@@ -1516,6 +1691,7 @@ namespace capi
         capi::mysql_errno(connection));
     }
     connected= true;
+    Metrics::increment(Metrics::RECONNECTS);
     if (!options->autoReconnect)
     {
       mysql_optionsv(connection, MYSQL_OPT_RECONNECT, &OptionNotSelected);
@@ -23,6 +23,7 @@
 
 #include <atomic>
 #include <map>
+#include <set>
 
 #include "Consts.h"
 #include "Protocol.h"
@@ -40,6 +41,7 @@ namespace mariadb
   class Socket;
   class SSLSocket;
   class Credential;
+  class ClusterHealthMonitor;
 
 namespace capi
 {
@@ -73,6 +75,13 @@ namespace capi
     bool hasWarningsFlag= false;
     /* This cannot be Shared as long as C/C stmt handle is owned by  statement(SSPS class in this case) object */
     Results* activeStreamingResult= nullptr;
+    /* Buffered binary results, that still read their rows from the C/C statement handle. They have to make a local copy
+       before the handle is re-executed or closed */
+    std::map<MYSQL_STMT*, SelectResultSet*> storedResults;
+    /* Statement handles owned by the cursor results reading them. Statements have got new handles meanwhile */
+    std::set<MYSQL_STMT*> leasedHandles;
+    /* Leased handles, that are not used by results anymore, and have to be closed by next command */
+    std::vector<MYSQL_STMT*> releasedLeases;
     uint32_t serverStatus= 0;
 
   protected:
@@ -88,6 +97,10 @@ namespace capi
     bool eofDeprecated= false;
     int64_t serverCapabilities= 0;
     int32_t socketTimeout= 0;
+    /* Server's max_allowed_packet, read after connection is established */
+    int64_t maxAllowedPacket= 0x00ffffff;
+    /* Monitor of the hosts health, if galeraHealthCheckInterval is set, and there are multiple hosts */
+    std::shared_ptr<ClusterHealthMonitor> healthMonitor;
 
   private:
     HostAddress currentHost;
@@ -174,6 +187,8 @@ namespace capi
     void readPipelineAdditionalData(std::map<SQLString, SQLString>& serverData);
     void requestSessionDataWithShow(std::map<SQLString, SQLString>& serverData);
     void additionalData(std::map<SQLString, SQLString>& serverData);
+    void sessionData();
+    void createDatabaseIfNotExist();
 
   public:
     bool isClosed();
@@ -236,6 +251,13 @@ namespace capi
     Results* getActiveStreamingResult();
     void setActiveStreamingResult(Results* activeStreamingResult);
     void removeActiveStreamingResult();
+    void registerStoredResult(MYSQL_STMT* stmt, SelectResultSet* rs);
+    void unregisterStoredResult(MYSQL_STMT* stmt, SelectResultSet* rs);
+    void cacheStoredResults(MYSQL_STMT* stmt= nullptr);
+    bool isHandleBusy(MYSQL_STMT* stmt);
+    void leaseHandle(MYSQL_STMT* stmt);
+    void closeReleasedLeases();
+    void closeInvalidatedHandle(MYSQL_STMT* stmt);
     Shared::mutex& getLock();
     bool hasMoreResults();
     ServerPrepareStatementCache* prepareStatementCache();
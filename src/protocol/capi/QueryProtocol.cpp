@@ -18,9 +18,14 @@
 *************************************************************************************/
 
 
+#include <cstring>
+#include <algorithm>
+#include <deque>
+
 #include "QueryProtocol.h"
 
 #include "logger/LoggerFactory.h"
+#include "logger/Tracer.h"
 #include "Results.h"
 #include "util/LogQueryTool.h"
 #include "util/ClientPrepareResult.h"
@@ -28,7 +33,10 @@
 #include "util/ServerPrepareStatementCache.h"
 #include "util/StateChange.h"
 #include "util/Utils.h"
+#include "util/Metrics.h"
 #include "protocol/MasterProtocol.h"
+#include "failover/ClusterHealthMonitor.h"
+#include "cache/QueryResultCache.h"
 #include "SqlStates.h"
 #include "com/capi/ColumnDefinitionCapi.h"
 #include "ExceptionFactory.h"
@@ -43,6 +51,7 @@ namespace mariadb
 namespace capi
 {
 #include "mysqld_error.h"
+#include "errmsg.h"
 
   static const int64_t MAX_PACKET_LENGTH= 0x00ffffff + 4;
 
@@ -72,6 +81,16 @@ namespace capi
     }
   }
 
+
+  QueryProtocol::~QueryProtocol()
+  {
+    std::lock_guard<std::mutex> localScopeLock(prepareResultsLock);
+    // Prepare results outliving the connection must not call it back
+    for (auto serverPrepareResult : prepareResults) {
+      serverPrepareResult->detachProtocol();
+    }
+  }
+
   void QueryProtocol::reset()
   {
     cmdPrologue();
@@ -110,11 +129,19 @@ namespace capi
 
   void QueryProtocol::executeQuery(bool /*mustExecuteOnMaster*/, Shared::Results& results, const SQLString& sql)
   {
+    TraceSpan span("execute", &serverThreadId);
     cmdPrologue();
+    std::string cacheKey;
+    uint64_t cacheGeneration= 0;
+
+    if (readCachedResult(results.get(), sql, cacheKey, cacheGeneration)) {
+      return;
+    }
     try {
 
       realQuery(sql);
       getResult(results.get());
+      updateResultCache(results.get(), sql, cacheKey, cacheGeneration);
 
     }catch (SQLException& sqlException){
       if (sqlException.getSQLState().compare("70100") == 0 && 1927 == sqlException.getErrorCode()){
@@ -129,11 +156,19 @@ namespace capi
 
   void QueryProtocol::executeQuery( bool /*mustExecuteOnMaster*/, Shared::Results& results, const SQLString& sql, const Charset* /*charset*/)
   {
+    TraceSpan span("execute", &serverThreadId);
     cmdPrologue();
+    std::string cacheKey;
+    uint64_t cacheGeneration= 0;
+
+    if (readCachedResult(results.get(), sql, cacheKey, cacheGeneration)) {
+      return;
+    }
     try {
 
       realQuery(sql);
       getResult(results.get());
+      updateResultCache(results.get(), sql, cacheKey, cacheGeneration);
 
     }catch (SQLException& sqlException){
       throw logQuery->exceptionWithQuery(sql, sqlException, explicitClosed);
@@ -217,10 +252,13 @@ namespace capi
       std::vector<Shared::ParameterHolder>& parameters,
       int32_t queryTimeout)
   {
+    TraceSpan span("execute", &serverThreadId);
     cmdPrologue();
 
     SQLString sql;
     addQueryTimeout(sql, queryTimeout);
+    std::string cacheKey;
+    uint64_t cacheGeneration= 0;
 
     try {
 
@@ -228,22 +266,25 @@ namespace capi
         && !clientPrepareResult->isQueryMultiValuesRewritable()) {
         if (clientPrepareResult->getQueryParts().size() == 1) {
           sql.append(clientPrepareResult->getQueryParts().front());
-          realQuery(sql);
         }
         else {
           for (const auto& query : clientPrepareResult->getQueryParts())
           {
             sql.append(query);
           }
-          realQuery(sql);
         }
       }
       else {
         /* Timeout has been added already, thus passing -1 for its value */
         assemblePreparedQueryForExec(sql, clientPrepareResult, parameters, connection, -1);
-        realQuery(sql);
       }
+      // The query with parameter values is the key of the cached result
+      if (readCachedResult(results.get(), sql, cacheKey, cacheGeneration)) {
+        return;
+      }
+      realQuery(sql);
       getResult(results.get());
+      updateResultCache(results.get(), sql, cacheKey, cacheGeneration);
 
     }
     catch (SQLException& queryException) {
@@ -272,6 +313,7 @@ namespace capi
       bool hasLongData)
 
   {
+    TraceSpan span("execute", &serverThreadId);
     // ***********************************************************************************************************
     // Multiple solution for batching :
     // - rewrite as multi-values (only if generated keys are not needed and query can be rewritten)
@@ -287,6 +329,7 @@ namespace capi
         // values rewritten in one query :
         // INSERT INTO X(a,b) VALUES (1,2), (3,4), ...
         executeBatchRewrite(results, prepareResult, parametersList, true);
+        Metrics::increment(Metrics::BATCH_REWRITE);
         return true;
 
       }else if (prepareResult->isQueryMultipleRewritable()){
@@ -296,12 +339,14 @@ namespace capi
             && prepareResult->isQueryMultipleRewritable()
             && results->getAutoGeneratedKeys()==Statement::NO_GENERATED_KEYS
             && executeBulkBatch(results, prepareResult->getSql(), nullptr, parametersList)){
+          Metrics::increment(Metrics::BATCH_BULK);
           return true;
         }
 
         // multi rewritten in one query :
         // INSERT INTO X(a,b) VALUES (1,2);INSERT INTO X(a,b) VALUES (3,4); ...
         executeBatchRewrite(results, prepareResult, parametersList, false);
+        Metrics::increment(Metrics::BATCH_MULTI_REWRITE);
         return true;
       }
     }
@@ -310,15 +355,18 @@ namespace capi
         && !hasLongData
         && results->getAutoGeneratedKeys()==Statement::NO_GENERATED_KEYS
         && executeBulkBatch(results,prepareResult->getSql(),nullptr,parametersList)){
+      Metrics::increment(Metrics::BATCH_BULK);
       return true;
     }
 
     if (options->continueBatchOnError) {//options->useBatchMultiSend) {
       executeBatchMulti(results, prepareResult, parametersList);
+      Metrics::increment(Metrics::BATCH_MULTI);
       return true;
     }
 
     executeBatchSlow(mustExecuteOnMaster, results, prepareResult, parametersList);
+    Metrics::increment(Metrics::BATCH_SLOW);
 
     return true;
   }
@@ -397,6 +445,10 @@ namespace capi
       if (!tmpServerPrepareResult){
         tmpServerPrepareResult= prepareInternal(origSql, true);
       }
+      else if (isInvalidated(tmpServerPrepareResult)) {
+        rePrepare(tmpServerPrepareResult);
+      }
+      tmpServerPrepareResult->incrementExecutionCount();
 
       // **************************************************************************************
       // send BULK
@@ -413,7 +465,9 @@ namespace capi
       capi::mysql_stmt_attr_set(statementId, STMT_ATTR_ARRAY_SIZE, (const void*)&bulkArrSize);
       auto firstParameters= parametersList.front();
 
+      cacheStoredResults(statementId);
       tmpServerPrepareResult->bindParameters(parametersList, types.data());
+      Metrics::increment(Metrics::ROUND_TRIPS);
       capi::mysql_stmt_execute(statementId);
 
       try {
@@ -584,6 +638,7 @@ namespace capi
    */
   void QueryProtocol::executeBatchStmt(bool /*mustExecuteOnMaster*/, Shared::Results& results, const std::vector<SQLString>& queries)
   {
+    TraceSpan span("execute", &serverThreadId);
     cmdPrologue();
     if (this->options->rewriteBatchedStatements) {
 
@@ -682,6 +737,88 @@ namespace capi
   }
 
 
+  /**
+   * Executes independent queries, sending next queries before results of the previous ones are read. Number of queries
+   * in flight is limited by maxInFlight, and their total size by PIPELINE_MAX_BYTES - while the client is not reading,
+   * the server may stop reading queries as well, and the client must not block on sending then. A query that does not
+   * fit the limit alone is sent when there is nothing else in flight. Errors of queries do not stop the pipeline, and
+   * are returned in the errors map by query index.
+   *
+   * @param results results object for every query
+   * @param queries queries text. For client-side prepared statements it's the query, that they have been prepared with
+   * @param prepareResults parse result of the prepared statement for the query, with parameters taken from its results
+   *        object, or nullptr if the query is sent as is
+   * @param errors errors of queries
+   * @param maxInFlight maximum number of queries sent, and which results have not been read yet
+   * @throws SQLException on connection errors
+   */
+  void QueryProtocol::executePipeline(std::vector<Shared::Results>& results, const std::vector<SQLString>& queries,
+    const std::vector<ClientPrepareResult*>& prepareResults, std::map<std::size_t, SQLException>& errors,
+    std::size_t maxInFlight)
+  {
+    TraceSpan span("execute", &serverThreadId);
+    cmdPrologue();
+    std::vector<std::size_t> sentLength(queries.size(), 0);
+    std::deque<std::size_t> inFlight;
+    std::size_t next= 0, bytesInFlight= 0;
+    SQLString query;
+    bool queryReady= false;
+
+    try {
+      while (next < queries.size() || !inFlight.empty()) {
+        while (next < queries.size()) {
+          if (!queryReady) {
+            query.clear();
+            if (prepareResults[next] != nullptr) {
+              try {
+                assemblePreparedQueryForExec(query, prepareResults[next], results[next]->getParameters(), connection, -1);
+              }
+              catch (SQLException& sqle) {
+                // Query has not been sent, there is no result to read for it
+                errors.emplace(next++, sqle);
+                continue;
+              }
+            }
+            else {
+              query.append(queries[next]);
+            }
+            queryReady= true;
+          }
+          if (!inFlight.empty() && (inFlight.size() >= maxInFlight || bytesInFlight + query.length() > PIPELINE_MAX_BYTES)) {
+            break;
+          }
+          sendQuery(query);
+          sentLength[next]= query.length();
+          bytesInFlight+= query.length();
+          inFlight.push_back(next++);
+          queryReady= false;
+        }
+        if (inFlight.empty()) {
+          break;
+        }
+
+        std::size_t current= inFlight.front();
+        inFlight.pop_front();
+        // We don't need exception on error here - getResult takes care of it
+        capi::mysql_read_query_result(connection);
+        try {
+          getResult(results[current].get(), nullptr, true);
+        }
+        catch (SQLException& sqle) {
+          if (sqle.getSQLState().startsWith("08")) {
+            throw;
+          }
+          errors.emplace(current, logQuery->exceptionWithQuery(queries[current], sqle, explicitClosed));
+        }
+        bytesInFlight-= sentLength[current];
+      }
+    }
+    catch (std::runtime_error& e) {
+      handleIoException(e).Throw();
+    }
+  }
+
+
   ServerPrepareResult* QueryProtocol::prepareInternal(const SQLString& sql, bool /*executeOnMaster*/)
   {
     if (options->cachePrepStmts && options->useServerPrepStmts) {
@@ -693,28 +830,12 @@ namespace capi
       }
     }
 
-    capi::MYSQL_STMT* stmtId = capi::mysql_stmt_init(connection);
-
-    if (stmtId == nullptr)
-    {
-      throw SQLException(capi::mysql_error(connection), capi::mysql_sqlstate(connection), capi::mysql_errno(connection));
-    }
-
-    static const my_bool updateMaxLength= 1;
-
-    capi::mysql_stmt_attr_set(stmtId, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
-
-    if (capi::mysql_stmt_prepare(stmtId, sql.c_str(), static_cast<unsigned long>(sql.length())))
+    ServerPrepareResult* res= new ServerPrepareResult(sql, prepareHandle(sql), this);
     {
-      SQLString err(mysql_stmt_error(stmtId)), sqlState(mysql_stmt_sqlstate(stmtId));
-      uint32_t errNo = mysql_stmt_errno(stmtId);
-
-      capi::mysql_stmt_close(stmtId);
-      throw SQLException(err, sqlState, errNo);
+      std::lock_guard<std::mutex> localScopeLock(prepareResultsLock);
+      prepareResults.insert(res);
     }
 
-    ServerPrepareResult* res= new ServerPrepareResult(sql, stmtId, this);
-
     if (options->cachePrepStmts
       && options->useServerPrepStmts
       && sql.length() < static_cast<size_t>(options->prepStmtCacheSqlLimit)) {
@@ -741,20 +862,136 @@ namespace capi
   }
 
 
-  bool checkRemainingSize(int64_t newQueryLen)
+  MYSQL_STMT* QueryProtocol::prepareHandle(const SQLString& sql)
+  {
+    TraceSpan span("prepare", &serverThreadId);
+    capi::MYSQL_STMT* stmtId = capi::mysql_stmt_init(connection);
+
+    if (stmtId == nullptr)
+    {
+      throw SQLException(capi::mysql_error(connection), capi::mysql_sqlstate(connection), capi::mysql_errno(connection));
+    }
+
+    Metrics::increment(Metrics::ROUND_TRIPS);
+    Metrics::increment(Metrics::SERVER_PREPARES);
+    Metrics::increment(Metrics::PAYLOAD_BYTES_SENT, sql.length());
+    if (capi::mysql_stmt_prepare(stmtId, sql.c_str(), static_cast<unsigned long>(sql.length())))
+    {
+      SQLString err(mysql_stmt_error(stmtId)), sqlState(mysql_stmt_sqlstate(stmtId));
+      uint32_t errNo = mysql_stmt_errno(stmtId);
+
+      capi::mysql_stmt_close(stmtId);
+      throw SQLException(err, sqlState, errNo);
+    }
+    return stmtId;
+  }
+
+
+  void QueryProtocol::unregisterPrepareResult(ServerPrepareResult* serverPrepareResult)
   {
-    return newQueryLen < MAX_PACKET_LENGTH;
+    std::lock_guard<std::mutex> localScopeLock(prepareResultsLock);
+    prepareResults.erase(serverPrepareResult);
   }
 
+  /**
+    * Checks if the statement handle of the prepare result belongs to the current connection. The C API detaches
+    * statement handles from the connection, when it is closed or reconnected.
+    */
+  bool QueryProtocol::isInvalidated(ServerPrepareResult* serverPrepareResult)
+  {
+    MYSQL_STMT* stmt= serverPrepareResult->getStatementId();
+    return stmt != nullptr && stmt->mysql != connection;
+  }
 
-  size_t assembleBatchAggregateSemiColonQuery(SQLString& sql, const SQLString &firstSql, const std::vector<SQLString>& queries, size_t currentIndex)
+  /**
+    * Prepares the query again on the current connection, and swaps the new statement handle into the prepare result.
+    *
+    * @param serverPrepareResult prepare result with invalidated statement handle
+    */
+  void QueryProtocol::rePrepare(ServerPrepareResult* serverPrepareResult)
+  {
+    closeInvalidatedHandle(serverPrepareResult->failover(prepareHandle(serverPrepareResult->getSql()), this));
+  }
+
+  /**
+    * If a cursor result still reads rows from the statement handle, the handle is leased to the result, and the new
+    * one is prepared for the statement, so it can be executed without fetching the whole result first.
+    *
+    * @param serverPrepareResult prepare result going to be executed
+    */
+  void QueryProtocol::leaseBusyHandle(ServerPrepareResult* serverPrepareResult)
+  {
+    if (isHandleBusy(serverPrepareResult->getStatementId())) {
+      leaseHandle(serverPrepareResult->swapStatementHandle(prepareHandle(serverPrepareResult->getSql()), this));
+    }
+  }
+
+  /**
+    * Re-prepares after reconnection up to reprepareOnReconnect most executed statements of the connection. New handles
+    * are prepared back-to-back first, and then swapped into prepare results. Remaining statements, and the ones
+    * that could not be prepared here, are re-prepared on their next execution.
+    */
+  void QueryProtocol::rePrepareStatements()
+  {
+    if (options->reprepareOnReconnect <= 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> localScopeLock(prepareResultsLock);
+    std::vector<ServerPrepareResult*> hottest;
+
+    for (auto serverPrepareResult : prepareResults) {
+      if (isInvalidated(serverPrepareResult)) {
+        hottest.push_back(serverPrepareResult);
+      }
+    }
+    std::size_t count= std::min(hottest.size(), static_cast<std::size_t>(options->reprepareOnReconnect));
+    std::partial_sort(hottest.begin(), hottest.begin() + count, hottest.end(),
+      [](ServerPrepareResult* a, ServerPrepareResult* b) { return a->getExecutionCount() > b->getExecutionCount(); });
+
+    std::vector<MYSQL_STMT*> handles(count, nullptr);
+    for (std::size_t i= 0; i < count; ++i) {
+      try {
+        handles[i]= prepareHandle(hottest[i]->getSql());
+      }
+      catch (SQLException& e) {
+        LOGGER_DEBUG(logger, SQLString("Could not re-prepare statement after reconnection: ").append(e.what()));
+      }
+    }
+    for (std::size_t i= 0; i < count; ++i) {
+      if (handles[i] != nullptr) {
+        closeInvalidatedHandle(hottest[i]->failover(handles[i], this));
+      }
+    }
+  }
+
+
+  bool checkRemainingSize(int64_t newQueryLen, int64_t maxQuerySize)
+  {
+    return newQueryLen < maxQuerySize;
+  }
+
+  /**
+   * Returns maximum length of the query, that batch can be aggregated or rewritten to. That is server's max_allowed_packet,
+   * or batchChunkSize option value, if it is set and smaller.
+   */
+  int64_t QueryProtocol::getMaxBatchQuerySize()
+  {
+    if (options->batchChunkSize > 0 && options->batchChunkSize < maxAllowedPacket) {
+      return options->batchChunkSize;
+    }
+    return maxAllowedPacket;
+  }
+
+
+  size_t assembleBatchAggregateSemiColonQuery(SQLString& sql, const SQLString &firstSql, const std::vector<SQLString>& queries, size_t currentIndex,
+    int64_t maxQuerySize)
   {
     sql.append(firstSql);
 
     // add query with ";"
     while (currentIndex < queries.size()) {
 
-      if (!checkRemainingSize(sql.length() + queries[currentIndex].length() + 1)) {
+      if (!checkRemainingSize(sql.length() + queries[currentIndex].length() + 1, maxQuerySize)) {
         break;
       }
       sql.append(';').append(queries[currentIndex]);
@@ -781,6 +1018,7 @@ namespace capi
     size_t totalQueries= queries.size();
     SQLException exception;
     SQLString sql;
+    const int64_t maxQuerySize= getMaxBatchQuerySize();
 
     do {
 
@@ -790,8 +1028,8 @@ namespace capi
         if (totalLenEstimation == 0) {
           totalLenEstimation= firstSql.length()*queries.size() + queries.size() - 1;
         }
-        sql.reserve(((std::min<int64_t>(MAX_PACKET_LENGTH, totalLenEstimation) + 7) / 8) * 8);
-        currentIndex= assembleBatchAggregateSemiColonQuery(sql, firstSql, queries, currentIndex);
+        sql.reserve(((std::min<int64_t>(maxQuerySize, totalLenEstimation) + 7) / 8) * 8);
+        currentIndex= assembleBatchAggregateSemiColonQuery(sql, firstSql, queries, currentIndex, maxQuerySize);
         realQuery(sql);
         sql.clear(); // clear is not supposed to release memory
 
@@ -827,6 +1065,7 @@ namespace capi
   * @param paramCount parameter pos
   * @param parameterList parameter list
   * @param rewriteValues is query rewritable by adding values
+  * @param maxQuerySize the length, that the query must not reach
   * @return current index
   * @throws IOException if connection fail
   */
@@ -836,7 +1075,8 @@ namespace capi
     std::size_t paramCount,
     std::vector<std::vector<Shared::ParameterHolder>> &parameterList,
     capi::MYSQL* connection,
-    bool rewriteValues)
+    bool rewriteValues,
+    int64_t maxQuerySize)
 
   {
     std::size_t index= currentIndex;
@@ -880,7 +1120,7 @@ namespace capi
         if (knownParameterSize) {
 
 
-          if (checkRemainingSize(pos.length() + staticLength + parameterLength)) {
+          if (checkRemainingSize(pos.length() + staticLength + parameterLength, maxQuerySize)) {
             pos.append(';');
             pos.append(firstPart);
             pos.append(secondPart);
@@ -941,7 +1181,7 @@ namespace capi
         if (knownParameterSize) {
 
 
-          if (checkRemainingSize(pos.length() + 1 + parameterLength + intermediatePartLength + lastPartLength)) {
+          if (checkRemainingSize(pos.length() + 1 + parameterLength + intermediatePartLength + lastPartLength, maxQuerySize)) {
             pos.append(',');
             pos.append(secondPart);
 
@@ -975,6 +1215,8 @@ namespace capi
 
   /**
    * Specific execution for batch rewrite that has specific query for memory.
+   * Next chunk of the batch is assembled, while the server is processing the previous one. Two buffers are used in turn
+   * for that, and they are reused for all chunks.
    *
    * @param results result
    * @param prepareResult prepareResult
@@ -989,27 +1231,49 @@ namespace capi
       bool rewriteValues)
   {
     cmdPrologue();
-    //std::vector<ParameterHolder>::const_iterator parameters;
     std::size_t currentIndex= 0;
     std::size_t totalParameterList= parameterList.size();
+    const int64_t maxQuerySize= getMaxBatchQuerySize();
 
     try {
-      SQLString sql;
-      sql.reserve(1024); //No estimations. Just something for beginning. stringstream ?
-      do {
-        sql.clear();
-        currentIndex= rewriteQuery(sql, prepareResult->getQueryParts(), currentIndex, prepareResult->getParamCount(), parameterList, connection, rewriteValues);
-        realQuery(sql);
-        getResult(results.get(), nullptr, !rewriteValues);
+      SQLString sql[2];
+      std::size_t inFlight= 0;
+      sql[0].reserve(1024); //No estimations. Just something for beginning.
+      sql[1].reserve(1024);
 
-#ifdef THE_TIME_HAS_COME
-        if (Thread.currentThread().isInterrupted()){
-          throw SQLException(
-              "Interrupted during batch",INTERRUPTED_EXCEPTION.getSqlState(),-1);
+      currentIndex= rewriteQuery(sql[inFlight], prepareResult->getQueryParts(), currentIndex, prepareResult->getParamCount(),
+                                 parameterList, connection, rewriteValues, maxQuerySize);
+      sendQuery(sql[inFlight]);
+
+      while (true) {
+        SQLString& next= sql[inFlight ^ 1];
+        std::size_t nextIndex= currentIndex;
+
+        next.clear(); // clear is not supposed to release memory
+        if (currentIndex < totalParameterList) {
+          try {
+            nextIndex= rewriteQuery(next, prepareResult->getQueryParts(), currentIndex, prepareResult->getParamCount(),
+                                    parameterList, connection, rewriteValues, maxQuerySize);
+          }
+          catch (...) {
+            // Previous chunk is still in flight, its results have to be read to keep the connection usable
+            capi::mysql_read_query_result(connection);
+            skipAllResults();
+            throw;
+          }
         }
-#endif
-      } while (currentIndex < totalParameterList);
+        // We don't need exception on error here - getResult takes care of it
+        capi::mysql_read_query_result(connection);
+        getResult(results.get(), nullptr, !rewriteValues);
 
+        if (nextIndex == currentIndex) {
+          break;
+        }
+        stopIfInterrupted();
+        sendQuery(next);
+        inFlight^= 1;
+        currentIndex= nextIndex;
+      }
     }catch (SQLException& sqlEx){
       throw logQuery->exceptionWithQuery(sqlEx,prepareResult);
     }catch (std::runtime_error& e){
@@ -1038,6 +1302,7 @@ namespace capi
       std::vector<std::vector<Shared::ParameterHolder>>& parametersList,
       bool hasLongData)
   {
+    TraceSpan span("execute", &serverThreadId);
     bool needToRelease= false;
     cmdPrologue();
 
@@ -1069,45 +1334,80 @@ namespace capi
   }
 
 
+  /**
+   * Returns buffer for long data chunks of longDataChunkSize bytes, allocating it on the first call.
+   */
+  sql::bytes& QueryProtocol::getLongDataBuffer()
+  {
+    if (!longDataBuffer) {
+      int64_t chunkSize= std::min<int64_t>(options->longDataChunkSize, MAX_PACKET_LENGTH - 4);
+      longDataBuffer.reset(new sql::bytes(static_cast<std::size_t>(chunkSize)));
+    }
+    return *longDataBuffer;
+  }
+
+
   void QueryProtocol::executePreparedQuery(
       bool /*mustExecuteOnMaster*/,
       ServerPrepareResult* serverPrepareResult,
       Shared::Results& results,
       std::vector<Shared::ParameterHolder>& parameters)
   {
+    TraceSpan span("execute", &serverThreadId);
     cmdPrologue();
 
     try {
-      std::unique_ptr<sql::bytes> ldBuffer;
       uint32_t bytesInBuffer;
-      uint64_t totalBytes= 0;
 
+      if (isInvalidated(serverPrepareResult)) {
+        rePrepare(serverPrepareResult);
+      }
+      serverPrepareResult->incrementExecutionCount();
+      leaseBusyHandle(serverPrepareResult);
+      // Re-execution invalidates rows the handle has stored for the previous result
+      cacheStoredResults(serverPrepareResult->getStatementId());
       serverPrepareResult->bindParameters(parameters);
 
       for (uint32_t i= 0; i < serverPrepareResult->getParameters().size(); i++) {
         if (parameters[i]->isLongData()) {
-          if (!ldBuffer) {
-            ldBuffer.reset(new sql::bytes(MAX_PACKET_LENGTH - 4));
-          }
+          sql::bytes& ldBuffer= getLongDataBuffer();
+          uint64_t totalBytes= 0;
 
-          while ((bytesInBuffer= parameters[i]->writeBinary(*ldBuffer)) > 0) {
-            capi::mysql_stmt_send_long_data(serverPrepareResult->getStatementId(), i, ldBuffer->arr, bytesInBuffer);
+          while ((bytesInBuffer= parameters[i]->writeBinary(ldBuffer)) > 0) {
+            capi::mysql_stmt_send_long_data(serverPrepareResult->getStatementId(), i, ldBuffer.arr, bytesInBuffer);
             totalBytes+= bytesInBuffer;
+            Metrics::increment(Metrics::PAYLOAD_BYTES_SENT, bytesInBuffer);
           }
           // The stream is not null, but empty. We should send 0 length so the value we put in the field is not NULL
           if (totalBytes == 0) {
-            capi::mysql_stmt_send_long_data(serverPrepareResult->getStatementId(), i, ldBuffer->arr, 0);
+            capi::mysql_stmt_send_long_data(serverPrepareResult->getStatementId(), i, ldBuffer.arr, 0);
           }
         }
       }
 
+      // With fetch size set, rows are read through the read-only cursor, fetchSize rows at a time. The connection
+      // is not blocked by the cursor, and can be used by other statements meanwhile
+      unsigned long cursorType= capi::CURSOR_TYPE_NO_CURSOR, prefetchRows= 1;
+      if (results->getFetchSize() > 0 && results->getResultSetConcurrency() == ResultSet::CONCUR_READ_ONLY) {
+        cursorType= capi::CURSOR_TYPE_READ_ONLY;
+        prefetchRows= static_cast<unsigned long>(results->getFetchSize());
+      }
+      capi::mysql_stmt_attr_set(serverPrepareResult->getStatementId(), capi::STMT_ATTR_CURSOR_TYPE, &cursorType);
+      capi::mysql_stmt_attr_set(serverPrepareResult->getStatementId(), capi::STMT_ATTR_PREFETCH_ROWS, &prefetchRows);
+
+      Metrics::increment(Metrics::ROUND_TRIPS);
       if (capi::mysql_stmt_execute(serverPrepareResult->getStatementId()) != 0) {
         throwStmtError(serverPrepareResult->getStatementId());
       }
-      /*CURSOR_TYPE_NO_CURSOR);*/
       getResult(results.get(), serverPrepareResult);
-      // We have to do this due to CONCPP-138
-      results->loadFully(false, this);
+      clearResultCacheOnWrite(serverPrepareResult->getSql());
+      // Buffered binary resultset is read directly from the statement handle, unless there are more results
+      // to read from the handle. If the handle is re-executed or closed, or connection is closed, while
+      // the resultset is still alive - it is cached locally at that moment(CONCPP-138). Cursor result is read
+      // from the handle the same way, the rest of streaming results have to be read before next command
+      if (hasMoreResults() || (results->getFetchSize() != 0 && cursorType == capi::CURSOR_TYPE_NO_CURSOR)) {
+        results->loadFully(false, this);
+      }
     }
     catch (SQLException& qex) {
       throw logQuery->exceptionWithQuery(parameters, qex, serverPrepareResult);
@@ -1146,6 +1446,13 @@ namespace capi
 
     if (lock->try_lock()) {
       checkClose();
+      if (isHandleBusy(statementId)) {
+        // The cursor result still reads rows from the handle. It's closed once the result is done with it
+        leaseHandle(statementId);
+        lock->unlock();
+        return true;
+      }
+      cacheStoredResults(statementId);
 
       if (mysql_stmt_close(statementId))
       {
@@ -1173,6 +1480,14 @@ namespace capi
    */
   void QueryProtocol::forceReleaseWaitingPrepareStatement()
   {
+    closeReleasedLeases();
+    if (statementIdToRelease != nullptr && isHandleBusy(statementIdToRelease)) {
+      leaseHandle(statementIdToRelease);
+      statementIdToRelease= nullptr;
+    }
+    if (statementIdToRelease != nullptr) {
+      cacheStoredResults(statementIdToRelease);
+    }
     if (statementIdToRelease != nullptr && capi::mysql_stmt_close(statementIdToRelease) == 0) {
       statementIdToRelease= nullptr;
     }
@@ -1205,7 +1520,12 @@ namespace capi
         this->changeSocketSoTimeout(timeout);
       }
       if (isMasterConnection() && galeraAllowedStates && galeraAllowedStates->size() != 0){
+        ClusterHealthMonitor::HostHealth health;
 
+        // State checked by the monitor not longer than its interval ago is good enough
+        if (healthMonitor && healthMonitor->lookup(getHostAddress(), health)) {
+          return health.healthy && ping();
+        }
 
         Shared::Results results(new Results());
         executeQuery(true, results, CHECK_GALERA_STATE_QUERY);
@@ -1233,7 +1553,7 @@ namespace capi
 
     }
     catch (/*SocketException*/std::runtime_error& socketException){
-      logger->trace(SQLString("Connection* is not valid").append(socketException.what()));
+      LOGGER_TRACE(logger, SQLString("Connection* is not valid").append(socketException.what()));
       connected= false;
       return false;
     }
@@ -1376,6 +1696,81 @@ namespace capi
     this->localInfileInputStream.reset(&inputStream);
   }
 
+  /* Data, that local infile handler sends to the server instead of the file content */
+  struct LoadDataSource
+  {
+    const char* data;
+    std::size_t length;
+    std::size_t position;
+  };
+
+  static int loadDataInit(void** ptr, const char* /*filename*/, void* userdata)
+  {
+    static_cast<LoadDataSource*>(userdata)->position= 0;
+    *ptr= userdata;
+    return 0;
+  }
+
+
+  static int loadDataRead(void* ptr, char* buf, unsigned int bufLen)
+  {
+    LoadDataSource* source= static_cast<LoadDataSource*>(ptr);
+    std::size_t chunk= std::min(static_cast<std::size_t>(bufLen), source->length - source->position);
+
+    std::memcpy(buf, source->data + source->position, chunk);
+    source->position+= chunk;
+    return static_cast<int>(chunk);
+  }
+
+
+  static void loadDataEnd(void* /*ptr*/)
+  {
+  }
+
+
+  static int loadDataError(void* /*ptr*/, char* errorMsg, unsigned int errorMsgLen)
+  {
+    std::strncpy(errorMsg, "Could not read data for LOAD DATA LOCAL INFILE", errorMsgLen - 1);
+    errorMsg[errorMsgLen - 1]= '\0';
+    return CR_UNKNOWN_ERROR;
+  }
+
+  /**
+   * Executes LOAD DATA LOCAL INFILE query, sending the data from the memory instead of the file, that query names.
+   * <i>Lock must be set before using this method</i>
+   *
+   * @param results results
+   * @param sql LOAD DATA LOCAL INFILE query
+   * @param data data to load
+   * @param length data length
+   */
+  void QueryProtocol::executeLoadData(Shared::Results& results, const SQLString& sql, const char* data, std::size_t length)
+  {
+    TraceSpan span("execute", &serverThreadId);
+    if (!options->allowLocalInfile) {
+      throw SQLException(
+        "Usage of LOCAL INFILE is disabled. To use it enable it via the connection property allowLocalInfile=true",
+        FEATURE_NOT_SUPPORTED.getSqlState().c_str(), -1);
+    }
+    cmdPrologue();
+
+    LoadDataSource source{ data, length, 0 };
+    mysql_set_local_infile_handler(connection, loadDataInit, loadDataRead, loadDataEnd, loadDataError, &source);
+    try {
+      realQuery(sql);
+      getResult(results.get());
+    }
+    catch (SQLException& sqlException) {
+      mysql_set_local_infile_default(connection);
+      throw logQuery->exceptionWithQuery(sql, sqlException, explicitClosed);
+    }
+    catch (std::runtime_error& e) {
+      mysql_set_local_infile_default(connection);
+      handleIoException(e).Throw();
+    }
+    mysql_set_local_infile_default(connection);
+  }
+
 
   int32_t QueryProtocol::getTimeout()
   {
@@ -1443,6 +1838,7 @@ namespace capi
   {
     int32_t res;
     if (spr != nullptr) {
+      cacheStoredResults(spr->getStatementId());
       res= capi::mysql_stmt_next_result(spr->getStatementId());
     }
     else {
@@ -1512,6 +1908,10 @@ namespace capi
     if ((serverStatus & ServerStatus::SERVER_SESSION_STATE_CHANGED_)!=0) {
       handleStateChange(results);
     }
+    // Statements of batches are not checked one by one
+    if (updateCount > 0 && !resultCacheUpdated && QueryResultCache::getInstance().isUsed()) {
+      QueryResultCache::getInstance().clear();
+    }
 
     results->addStats(updateCount, insertId, hasMoreResults());
   }
@@ -1539,7 +1939,7 @@ namespace capi
 
         case StateChange::SESSION_TRACK_SCHEMA:
           database= str;
-          logger->debug("Database change : now is '" + database + "'");
+          LOGGER_DEBUG(logger, "Database change : now is '" + database + "'");
           break;
 
         default:
@@ -1749,12 +2149,15 @@ namespace capi
    */
   void QueryProtocol::readResultSet(Results* results, ServerPrepareResult *pr)
   {
+    TraceSpan span("fetch", &serverThreadId);
     try {
 
       SelectResultSet* selectResultSet;
 
       capi::mariadb_get_infov(connection, MARIADB_CONNECTION_SERVER_STATUS, (void*)&this->serverStatus);
       bool callableResult= (serverStatus & ServerStatus::PS_OUT_PARAMETERS)!=0;
+      // Cursor result does not keep rows pending on the connection
+      bool cursorResult= pr != nullptr && (serverStatus & ServerStatus::CURSOR_EXISTS) != 0;
 
       if (pr == nullptr)
       {
@@ -1771,8 +2174,10 @@ namespace capi
           selectResultSet= UpdatableResultSet::create(results, this, pr, callableResult, eofDeprecated);
         }
       }
+      Metrics::increment(results->getFetchSize() == 0 || callableResult ?
+        Metrics::RESULT_SETS_BUFFERED : Metrics::RESULT_SETS_STREAMING);
       // Not sure where we get status and more results there is and if it's available if we are streaming result
-      bool pendingResults= hasMoreResults() || results->getFetchSize() > 0;
+      bool pendingResults= hasMoreResults() || (results->getFetchSize() > 0 && !cursorResult);
       results->addResultSet(selectResultSet, pendingResults);
       if (pendingResults) {
         setActiveStreamingResult(results);
@@ -1788,6 +2193,92 @@ namespace capi
   }
 
 
+  /**
+   * Gives the result of the query from the query result cache, if the cache is enabled, and the result may be cached.
+   *
+   * @param results result object
+   * @param sql the query, with parameter values for client-side prepared statements
+   * @param cacheKey gets the key, if the result of the query may be cached
+   * @param cacheGeneration gets the generation of the cache, that has to be passed to updateResultCache
+   * @return true if the result has been added to results
+   */
+  bool QueryProtocol::readCachedResult(Results* results, const SQLString& sql, std::string& cacheKey,
+    uint64_t& cacheGeneration)
+  {
+    resultCacheUpdated= true;
+
+    // The transaction may have its own view of the data
+    if (options->queryResultCacheTtl <= 0 || inTransaction() || results->isBatch() || results->getFetchSize() != 0
+      || results->getMaxFieldSize() != 0 || results->getResultSetConcurrency() != ResultSet::CONCUR_READ_ONLY) {
+      return false;
+    }
+    QueryResultCache& cache= QueryResultCache::getInstance();
+    const SQLString& endpoint= !options->pipe.empty() ? options->pipe :
+      (!options->localSocket.empty() ? options->localSocket : getHost());
+
+    cacheKey= QueryResultCache::makeKey(endpoint, getPort(), getUsername(), database, maxRows, sql);
+    cacheGeneration= cache.getGeneration();
+
+    std::shared_ptr<const QueryResultCache::Entry> entry(cache.get(cacheKey));
+    if (!entry) {
+      return false;
+    }
+    // Rows of the result set only wrap values of the entry
+    std::vector<Shared::ColumnDefinition> columns(entry->columns);
+    std::vector<std::vector<sql::bytes>> rows(entry->rows);
+    SelectResultSet* selectResultSet= SelectResultSet::create(columns, rows, this, results->getResultSetScrollType(), entry);
+
+    selectResultSet->setStatement(results->getStatement());
+    hasWarningsFlag= false;
+    Metrics::increment(Metrics::RESULT_CACHE_HITS);
+    results->addResultSet(selectResultSet, false);
+    return true;
+  }
+
+  /**
+   * Puts the result of the query into the query result cache, or drops all cached results, if the statement may
+   * change data.
+   *
+   * @param results result object
+   * @param sql the query
+   * @param cacheKey the key from readCachedResult. Empty, if the result may not be cached
+   * @param cacheGeneration the generation from readCachedResult
+   */
+  void QueryProtocol::updateResultCache(Results* results, const SQLString& sql, const std::string& cacheKey,
+    uint64_t cacheGeneration)
+  {
+    std::vector<std::string> tables;
+
+    if (!cacheKey.empty() && QueryResultCache::isCacheable(sql, database, tables)) {
+      SelectResultSet* selectResultSet= results->getSingleResultSet();
+
+      if (selectResultSet != nullptr && !hasMoreResults()) {
+        std::size_t maxSize= static_cast<std::size_t>(std::max(0, options->queryResultCacheSize));
+        QueryResultCache::getInstance().put(cacheKey, QueryResultCache::createEntry(selectResultSet, tables, maxSize),
+          cacheGeneration, options->queryResultCacheTtl, maxSize);
+      }
+      return;
+    }
+    clearResultCacheOnWrite(sql);
+  }
+
+  /**
+   * Drops all cached results, if the executed statement may change data. Written tables are not looked for, since
+   * triggers, foreign key actions, views and stored routines change tables, that the statement does not name.
+   *
+   * @param sql executed statement
+   */
+  void QueryProtocol::clearResultCacheOnWrite(const SQLString& sql)
+  {
+    QueryResultCache& cache= QueryResultCache::getInstance();
+
+    resultCacheUpdated= true;
+    if (cache.isUsed() && QueryResultCache::isWrite(sql)) {
+      cache.clear();
+    }
+  }
+
+
   void QueryProtocol::prologProxy(
       ServerPrepareResult* /*serverPrepareResult*/,
       int64_t maxRows,
@@ -1838,6 +2329,7 @@ namespace capi
 
   void QueryProtocol::cmdPrologue()
   {
+    resultCacheUpdated= false;
     auto activeStream= getActiveStreamingResult();
     if (activeStream) {
       activeStream->loadFully(false, this);
@@ -1888,6 +2380,15 @@ namespace capi
     if (getAutocommit()!=autocommit){
       executeQuery(SQLString("SET AUTOCOMMIT=").append(autocommit ?"1":"0"));
     }
+    rePrepareStatements();
+  }
+
+
+  void QueryProtocol::reconnect()
+  {
+    super::reconnect();
+    std::lock_guard<std::mutex> localScopeLock(*lock);
+    rePrepareStatements();
   }
 
   /**
@@ -21,7 +21,10 @@
 #ifndef _ABSTRACTQUERYPROTOCOL_H_
 #define _ABSTRACTQUERYPROTOCOL_H_
 
+#include <atomic>
 #include <istream>
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 
 #include "Consts.h"
@@ -45,20 +48,30 @@ namespace capi
 
     static const Shared::Logger logger;
     static const SQLString CHECK_GALERA_STATE_QUERY; /*"show status like 'wsrep_local_state'"*/
+    /* Limit of the size of pipelined queries, that have been sent and which results have not been read yet */
+    static const std::size_t PIPELINE_MAX_BYTES= 16384;
     std::unique_ptr<LogQueryTool> logQuery;
     Tokens galeraAllowedStates;
     //ThreadPoolExecutor readScheduler; /*NULL*/
     int32_t transactionIsolationLevel= 0;
     std::unique_ptr<std::istream> localInfileInputStream;
+    /* Buffer for sending long data parameters in chunks. Allocated on first use, and reused for the connection life */
+    std::unique_ptr<sql::bytes> longDataBuffer;
     int64_t maxRows= 0;
     /*volatile*/
     MYSQL_STMT* statementIdToRelease= nullptr;
     FutureTask* activeFutureTask= nullptr;
-    bool interrupted= false;
+    std::atomic<bool> interrupted{false};
+    /* Server prepare results, created on this connection and not destructed yet */
+    std::mutex prepareResultsLock;
+    std::unordered_set<ServerPrepareResult*> prepareResults;
+    /* Set, if the query result cache is updated according to the statement being executed. Otherwise, statements
+       changing rows drop all cached results */
+    bool resultCacheUpdated= false;
 
   protected:
     QueryProtocol(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo* globalInfo, Shared::mutex& lock);
-    virtual ~QueryProtocol() {}
+    virtual ~QueryProtocol();
 
   public:
     void reset();
@@ -113,15 +126,26 @@ namespace capi
 
   public:
     void executeBatchStmt(bool mustExecuteOnMaster, Shared::Results& results, const std::vector<SQLString>& queries);
+    void executePipeline(std::vector<Shared::Results>& results, const std::vector<SQLString>& queries,
+      const std::vector<ClientPrepareResult*>& prepareResults, std::map<std::size_t, SQLException>& errors,
+      std::size_t maxInFlight);
 
   private:
     void executeBatch(Shared::Results& results, const std::vector<SQLString>& queries);
     /* Does actual prepare job w/out locking, i.e. is good to use if lock has been already acquired */
     ServerPrepareResult* prepareInternal(const SQLString& sql, bool executeOnMaster);
+    MYSQL_STMT* prepareHandle(const SQLString& sql);
+    bool isInvalidated(ServerPrepareResult* serverPrepareResult);
+    void rePrepare(ServerPrepareResult* serverPrepareResult);
+    void leaseBusyHandle(ServerPrepareResult* serverPrepareResult);
+    sql::bytes& getLongDataBuffer();
+    void rePrepareStatements();
   public:
     ServerPrepareResult* prepare(const SQLString& sql, bool executeOnMaster);
+    void unregisterPrepareResult(ServerPrepareResult* serverPrepareResult);
 
   private:
+    int64_t getMaxBatchQuerySize();
     void executeBatchAggregateSemiColon(Shared::Results& results, const std::vector<SQLString>& queries, std::size_t totalLenEstimation= 0);
 
     void executeBatchRewrite(
@@ -161,6 +185,7 @@ namespace capi
     int64_t getMaxRows();
     void setMaxRows(int64_t max);
     void setLocalInfileInputStream(std::istream& inputStream);
+    void executeLoadData(Shared::Results& results, const SQLString& sql, const char* data, std::size_t length);
     int32_t getTimeout();
     void setTimeout(int32_t timeout);
     void setTransactionIsolation(int32_t level);
@@ -187,6 +212,9 @@ namespace capi
     SQLException readErrorPacket(Results* results, ServerPrepareResult *pr= nullptr);
     void readLocalInfilePacket(Shared::Results& results);
     void readResultSet(Results* results, ServerPrepareResult *pr);
+    bool readCachedResult(Results* results, const SQLString& sql, std::string& cacheKey, uint64_t& cacheGeneration);
+    void updateResultCache(Results* results, const SQLString& sql, const std::string& cacheKey, uint64_t cacheGeneration);
+    void clearResultCacheOnWrite(const SQLString& sql);
 
   public:
 
@@ -204,6 +232,7 @@ namespace capi
 
   public:
     void resetStateAfterFailover(int64_t maxRows, int32_t transactionIsolationLevel, const SQLString& database, bool autocommit);
+    void reconnect();
     MariaDBExceptionThrower handleIoException(std::runtime_error& initialException, bool throwRightAway=true);
     void setActiveFutureTask(FutureTask* activeFutureTask);
     void interrupt();
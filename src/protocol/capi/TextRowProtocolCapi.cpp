@@ -25,6 +25,8 @@
 #include "ExceptionFactory.h"
 #include "ColumnType.h"
 #include "ColumnDefinition.h"
+#include "util/Metrics.h"
+#include "util/FloatConversion.h"
 
 namespace sql
 {
@@ -32,6 +34,95 @@ namespace mariadb
 {
 namespace capi
 {
+namespace
+{
+  /* Integer columns are sent as plain decimal digits, optionally zero filled */
+  template <typename T>
+  T textInteger(RowProtocol* row, ColumnDefinition* columnInfo)
+  {
+    const char *it= row->fieldBuf.arr, *end= it + row->length;
+    bool negative= (it < end && *it == '-');
+    uint64_t value= 0;
+
+    if (negative || (it < end && *it == '+')) {
+      ++it;
+    }
+    bool valid= it < end;
+
+    for (; it < end && valid; ++it) {
+      uint32_t digit= static_cast<uint32_t>(*it - '0');
+      if (digit > 9 || value > (UINT64_MAX - digit) / 10) {
+        valid= false;
+      }
+      value= value*10 + digit;
+    }
+
+    if (valid) {
+      if (!negative) {
+        valid= RowProtocol::fitsInto<T>(value);
+      }
+      else if (value <= static_cast<uint64_t>(INT64_MAX) + 1) {
+        // Negating the unsigned value without overflowing int64_t
+        int64_t signedValue= value == 0 ? 0 : -static_cast<int64_t>(value - 1) - 1;
+        if (RowProtocol::fitsInto<T>(signedValue)) {
+          return static_cast<T>(signedValue);
+        }
+        valid= false;
+      }
+      else {
+        valid= false;
+      }
+    }
+    if (!valid) {
+      RowProtocol::throwOutOfRange(columnInfo, SQLString(row->fieldBuf.arr, row->length), RowProtocol::TypeName<T>::get());
+    }
+    return static_cast<T>(value);
+  }
+
+  /* Going through the Via type, integers are rounded the same way as when they are parsed as floating point text */
+  template <typename Src, typename Via, typename T>
+  T textIntegerAs(RowProtocol* row, ColumnDefinition* columnInfo)
+  {
+    return static_cast<T>(static_cast<Via>(textInteger<Src>(row, columnInfo)));
+  }
+
+
+  float textFloat(RowProtocol* row, ColumnDefinition* columnInfo)
+  {
+    try {
+      return FloatConversion::toFloat(row->fieldBuf.arr, row->length);
+    }
+    // Common parent for std::invalid_argument and std::out_of_range
+    catch (std::logic_error& nfe) {
+      throw SQLException(
+          "Incorrect format \""
+          +SQLString(row->fieldBuf.arr, row->length)
+          +"\" for getFloat for data field with type "
+          +columnInfo->getColumnType().getCppTypeName(),
+          "22003",
+          1264, &nfe);
+    }
+  }
+
+
+  long double textDouble(RowProtocol* row, ColumnDefinition*)
+  {
+    return RowProtocol::stringToDouble(row->fieldBuf.arr, row->length);
+  }
+
+
+  template <typename Src>
+  RowProtocol::ColumnDecoders integerDecoders()
+  {
+    RowProtocol::ColumnDecoders decoders;
+    decoders.toInt=    &textInteger<int32_t>;
+    decoders.toLong=   &textInteger<int64_t>;
+    decoders.toULong=  &textInteger<uint64_t>;
+    decoders.toFloat=  &textIntegerAs<Src, float, float>;
+    decoders.toDouble= &textIntegerAs<Src, double, long double>;
+    return decoders;
+  }
+}
 
 /**
  * Constructor.
@@ -79,6 +170,44 @@ namespace capi
     }
   }
 
+ /**
+  * Picks decoders for numeric columns. Others are converted by the generic getters.
+  *
+  * @param columns column information
+  */
+ void TextRowProtocolCapi::buildDecoderPlan(const std::vector<Shared::ColumnDefinition>& columns)
+ {
+   decoderPlan.clear();
+   decoderPlan.reserve(columns.size());
+
+   for (auto& columnInfo : columns) {
+     switch (columnInfo->getColumnType().getType()) {
+     case MYSQL_TYPE_TINY:
+     case MYSQL_TYPE_SHORT:
+     case MYSQL_TYPE_YEAR:
+     case MYSQL_TYPE_LONG:
+     case MYSQL_TYPE_INT24:
+     case MYSQL_TYPE_LONGLONG:
+       decoderPlan.push_back(columnInfo->isSigned() ? integerDecoders<int64_t>() : integerDecoders<uint64_t>());
+       break;
+     case MYSQL_TYPE_FLOAT:
+     case MYSQL_TYPE_DOUBLE:
+       decoderPlan.emplace_back();
+       decoderPlan.back().toFloat=  &textFloat;
+       decoderPlan.back().toDouble= &textDouble;
+       break;
+     default:
+       decoderPlan.emplace_back();
+     }
+   }
+ }
+
+ /* Values of the text protocol rows are always entirely in memory */
+ std::unique_ptr<std::streambuf> TextRowProtocolCapi::getInternalStreamBuffer(int32_t /*newIndex*/)
+ {
+   return std::unique_ptr<std::streambuf>();
+ }
+
  /**
  * Get String from raw text format.
  *
@@ -723,6 +852,9 @@ namespace capi
    if (lastValueWasNull()) {
      return 0;
    }
+   if (auto decode= decoder(&ColumnDecoders::toInt)) {
+     return decode(this, columnInfo);
+   }
    if (needsBinaryConversion(columnInfo)) {
      return parseBinaryAsInteger<int32_t>(columnInfo);
    }
@@ -744,6 +876,9 @@ namespace capi
    if (lastValueWasNull()) {
      return 0;
    }
+   if (auto decode= decoder(&ColumnDecoders::toLong)) {
+     return decode(this, columnInfo);
+   }
 
    try {
      switch (columnInfo->getColumnType().getType()) {
@@ -805,6 +940,9 @@ namespace capi
    if (lastValueWasNull()) {
      return 0;
    }
+   if (auto decode= decoder(&ColumnDecoders::toULong)) {
+     return decode(this, columnInfo);
+   }
 
    uint64_t value= 0;
 
@@ -875,6 +1013,9 @@ namespace capi
    if (lastValueWasNull()) {
      return 0;
    }
+   if (auto decode= decoder(&ColumnDecoders::toFloat)) {
+     return decode(this, columnInfo);
+   }
 
    switch (columnInfo->getColumnType().getType()) {
    case MYSQL_TYPE_BIT:
@@ -893,7 +1034,7 @@ namespace capi
    case MYSQL_TYPE_DECIMAL:
    case MYSQL_TYPE_LONGLONG:
      try {
-       return std::stof(std::string(fieldBuf.arr+pos, length));
+       return FloatConversion::toFloat(fieldBuf.arr + pos, length);
      }
      // Common parent for std::invalid_argument and std::out_of_range
      catch (std::logic_error& nfe) {
@@ -924,6 +1065,9 @@ namespace capi
    if (lastValueWasNull()) {
      return 0;
    }
+   if (auto decode= decoder(&ColumnDecoders::toDouble)) {
+     return decode(this, columnInfo);
+   }
    switch (columnInfo->getColumnType().getType()) {
    case MYSQL_TYPE_BIT:
      return static_cast<long double>(parseBit());
@@ -978,6 +1122,43 @@ namespace capi
    return std::unique_ptr<BigDecimal>(new BigDecimal(fieldBuf.arr + pos, length));
  }
 
+ /**
+  * Get Decimal from raw text format, without creating intermediate strings.
+  *
+  * @param columnInfo column information
+  * @return decimal value
+  * @throws SQLException if column type doesn't permit conversion or the value is not a number
+  */
+ Decimal TextRowProtocolCapi::getInternalDecimal(ColumnDefinition* columnInfo)
+ {
+   if (lastValueWasNull()) {
+     return Decimal();
+   }
+
+   switch (columnInfo->getColumnType().getType()) {
+   case MYSQL_TYPE_BIT:
+     return Decimal(parseBit());
+   case MYSQL_TYPE_TINY:
+   case MYSQL_TYPE_SHORT:
+   case MYSQL_TYPE_YEAR:
+   case MYSQL_TYPE_LONG:
+   case MYSQL_TYPE_INT24:
+   case MYSQL_TYPE_LONGLONG:
+   case MYSQL_TYPE_FLOAT:
+   case MYSQL_TYPE_DOUBLE:
+   case MYSQL_TYPE_NEWDECIMAL:
+   case MYSQL_TYPE_DECIMAL:
+   case MYSQL_TYPE_VAR_STRING:
+   case MYSQL_TYPE_VARCHAR:
+   case MYSQL_TYPE_STRING:
+     return Decimal(fieldBuf.arr + pos, length);
+   default:
+     throw SQLException(
+       "getDecimal not available for data field type "
+       +columnInfo->getColumnType().getCppTypeName());
+   }
+ }
+
 
   /**
   * Get boolean from raw text format.
@@ -1071,13 +1252,26 @@ namespace capi
    rowData= mysql_fetch_row(capiResults);
    lengthArr= mysql_fetch_lengths(capiResults);
 
-   return (rowData == nullptr ? MYSQL_NO_DATA : 0);
+   if (rowData == nullptr) {
+     return MYSQL_NO_DATA;
+   }
+   // Rows re-read after the cursor has been moved back, are not received again
+   if (nextRow++ >= countedRows) {
+     int64_t rowBytes= 0;
+     for (uint32_t i= 0, fieldCount= mysql_num_fields(capiResults); i < fieldCount; ++i) {
+       rowBytes+= lengthArr[i];
+     }
+     Metrics::increment(Metrics::PAYLOAD_BYTES_RECEIVED, rowBytes);
+     countedRows= nextRow;
+   }
+   return 0;
  }
 
 
  void TextRowProtocolCapi::installCursorAtPosition(int32_t rowPtr)
  {
    mysql_data_seek(capiResults, static_cast<unsigned long long>(rowPtr));
+   nextRow= static_cast<uint64_t>(rowPtr);
  }
 
 #ifdef JDBC_SPECIFIC_TYPES_IMPLEMENTED
@@ -42,6 +42,9 @@ class TextRowProtocolCapi  : public RowProtocol {
   MYSQL_RES* capiResults;
   MYSQL_ROW  rowData;
   unsigned long* lengthArr;
+  /* Index of the row, that fetchNext reads next, and number of rows, which bytes have been counted in metrics */
+  uint64_t nextRow= 0;
+  uint64_t countedRows= 0;
 
 public:
   TextRowProtocolCapi(int32_t maxFieldSize, Shared::Options options, MYSQL_RES* capiTextResults);
@@ -64,12 +67,14 @@ public:
   std::unique_ptr<Time> getInternalTime(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<Timestamp> getInternalTimestamp( ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
   std::unique_ptr<SQLString> getInternalString(ColumnDefinition* columnInfo, Calendar* cal=nullptr, TimeZone* timeZone=nullptr);
+  std::unique_ptr<std::streambuf> getInternalStreamBuffer(int32_t newIndex) override;
   int32_t getInternalInt(ColumnDefinition* columnInfo);
   int64_t getInternalLong(ColumnDefinition* columnInfo);
   uint64_t getInternalULong(ColumnDefinition* columnInfo);
   float getInternalFloat(ColumnDefinition* columnInfo);
   long double getInternalDouble(ColumnDefinition* columnInfo);
   std::unique_ptr<BigDecimal> getInternalBigDecimal(ColumnDefinition* columnInfo);
+  Decimal getInternalDecimal(ColumnDefinition* columnInfo);
 
   bool getInternalBoolean(ColumnDefinition* columnInfo);
   int8_t getInternalByte(ColumnDefinition* columnInfo);
@@ -77,6 +82,7 @@ public:
   SQLString getInternalTimeString(ColumnDefinition* columnInfo);
 
   bool isBinaryEncoded();
+  void buildDecoderPlan(const std::vector<Shared::ColumnDefinition>& columns) override;
   void cacheCurrentRow(std::vector<sql::bytes>& rowData, std::size_t columnCount) override;
   };
 
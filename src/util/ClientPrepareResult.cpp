@@ -18,6 +18,8 @@
 *************************************************************************************/
 
 
+#include <cstring>
+
 #include "ClientPrepareResult.h"
 
 namespace sql
@@ -26,6 +28,64 @@ namespace mariadb
 {
   const SQLString SpecChars("();><=-+,");
 
+  /* Characters, that may change the lexer state or flags in the normal state and inside a string literal */
+  struct LexStops
+  {
+    bool normal[256];
+    bool sqlString[256];
+
+    LexStops()
+    {
+      std::memset(normal, 0, sizeof(normal));
+      std::memset(sqlString, 0, sizeof(sqlString));
+      for (unsigned char c : std::string("*/#-\n\"';?`")) {
+        normal[c]= true;
+      }
+      for (unsigned char c : std::string("'\"\\")) {
+        sqlString[c]= true;
+      }
+    }
+  };
+
+  const LexStops lexStops;
+
+  /**
+    * Returns the position of the first character starting from pos, that the lexer has to look at in the given state.
+    * Characters before it cannot change the state. In the normal state that is only true if the caller does not look
+    * at other characters, thus it is skipped only if normalState is true.
+    */
+  static std::size_t skipInert(const char* query, std::size_t pos, std::size_t len, LexState state, bool normalState)
+  {
+    const void* found= nullptr;
+
+    switch (state) {
+    case LexState::EOLComment:
+      found= std::memchr(query + pos, '\n', len - pos);
+      break;
+    case LexState::SlashStarComment:
+      found= std::memchr(query + pos, '/', len - pos);
+      break;
+    case LexState::Backtick:
+      found= std::memchr(query + pos, '`', len - pos);
+      break;
+    case LexState::SqlString:
+      while (pos < len && !lexStops.sqlString[static_cast<unsigned char>(query[pos])]) {
+        ++pos;
+      }
+      return pos;
+    case LexState::Normal:
+      if (normalState) {
+        while (pos < len && !lexStops.normal[static_cast<unsigned char>(query[pos])]) {
+          ++pos;
+        }
+      }
+      return pos;
+    default:
+      return pos;
+    }
+    return found != nullptr ? static_cast<const char*>(found) - query : len;
+  }
+
   ClientPrepareResult::ClientPrepareResult(
     const SQLString& _sql,
     std::vector<SQLString>& _queryParts,
@@ -63,10 +123,18 @@ namespace mariadb
     bool singleQuotes= false;
     std::size_t lastParameterPosition= 0;
 
+    const char* query= queryString.c_str();
     std::size_t queryLength= queryString.length();
     for (std::size_t i= 0; i < queryLength; i++) {
 
-      char car= queryString[i];
+      std::size_t next= skipInert(query, i, queryLength, state, !endingSemicolon);
+      if (next > i) {
+        lastChar= query[next - 1];
+        if ((i= next) == queryLength) {
+          break;
+        }
+      }
+      char car= query[i];
       if (state == LexState::Escape
         && !((car == '\'' && singleQuotes) || (car == '"' && !singleQuotes))) {
         state= LexState::SqlString;
@@ -204,8 +272,18 @@ namespace mariadb
     bool singleQuotes= false;
     bool endingSemicolon= false;
 
-    for (char car : queryString) {
+    const char* query= queryString.c_str();
+    std::size_t queryLength= queryString.length();
+    for (std::size_t i= 0; i < queryLength; i++) {
 
+      std::size_t next= skipInert(query, i, queryLength, state, !endingSemicolon);
+      if (next > i) {
+        lastChar= query[next - 1];
+        if ((i= next) == queryLength) {
+          break;
+        }
+      }
+      char car= query[i];
       if (state == LexState::Escape
         &&!((car == '\''&&singleQuotes)||(car == '"'&&!singleQuotes))) {
         state= LexState::SqlString;
@@ -371,6 +449,15 @@ namespace mariadb
 
     for (size_t i= 0; i < queryLength; i++) {
 
+      // Rewrite parsing looks at many more characters in the normal state, thus only literals and comments are skipped
+      std::size_t next= skipInert(query, i, queryLength, state, false);
+      if (next > i) {
+        sb.append(query + i, next - i);
+        lastChar= query[next - 1];
+        if ((i= next) == queryLength) {
+          break;
+        }
+      }
       char car= query[i];
       if (state == LexState::Escape
         &&!((car == '\''&&singleQuotes)||(car == '"'&&!singleQuotes))) {
@@ -34,7 +34,7 @@ namespace mariadb
 
 class ClientPrepareResult : public PrepareResult
 {
-  const SQLString& sql;
+  const SQLString sql;
   const std::vector<SQLString> queryParts;
   bool rewriteType;
   uint32_t paramCount;
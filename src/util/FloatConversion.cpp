@@ -0,0 +1,308 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <cerrno>
+#include <cfloat>
+#include <clocale>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "FloatConversion.h"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace
+{
+  // If intermediate results are kept in wider registers, the arithmetic fast path would round twice
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+  const bool exactArithmetic= true;
+#else
+  const bool exactArithmetic= false;
+#endif
+
+  const double powersOf10[]= { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  const float powersOf10f[]= { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+  /* Decimal number split into parts. Exact only if no significant digit had to be dropped */
+  struct DecimalParts
+  {
+    bool negative= false;
+    uint64_t mantissa= 0;
+    int32_t exponent= 0;
+    const char* end= nullptr;
+  };
+
+
+  inline bool isDigit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+
+  inline bool isSpace(char c)
+  {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+
+  char localeDecimalPoint()
+  {
+    const char* decimalPoint= std::localeconv()->decimal_point;
+    return decimalPoint != nullptr && *decimalPoint != '\0' ? *decimalPoint : '.';
+  }
+
+  /**
+   * Splits plain decimal number into mantissa and exponent.
+   *
+   * @return false if the string has to be parsed by the C library - it doesn't start with a number, or the number has
+   *         more than 19 significant digits, or is in the hexadecimal form
+   */
+  bool scanDecimal(const char* str, std::size_t len, DecimalParts& parts)
+  {
+    const char* p= str, *end= str + len;
+    bool anyDigit= false;
+    int32_t significantDigits= 0;
+
+    while (p < end && isSpace(*p)) {
+      ++p;
+    }
+    if (p < end && (*p == '-' || *p == '+')) {
+      parts.negative= (*p == '-');
+      ++p;
+    }
+    for (; p < end && isDigit(*p); ++p) {
+      anyDigit= true;
+      if (parts.mantissa == 0 && *p == '0') {
+        continue;
+      }
+      if (significantDigits == 19) {
+        if (*p != '0') {
+          return false;
+        }
+        ++parts.exponent;
+        continue;
+      }
+      parts.mantissa= parts.mantissa * 10 + (*p - '0');
+      ++significantDigits;
+    }
+    if (p < end && (*p == 'x' || *p == 'X')) {
+      return false;
+    }
+    if (p < end && *p == '.') {
+      const char* fraction= p + 1;
+      for (; fraction < end && isDigit(*fraction); ++fraction) {
+        anyDigit= true;
+        if (parts.mantissa == 0 && *fraction == '0') {
+          --parts.exponent;
+          continue;
+        }
+        if (significantDigits == 19) {
+          if (*fraction != '0') {
+            return false;
+          }
+          continue;
+        }
+        parts.mantissa= parts.mantissa * 10 + (*fraction - '0');
+        --parts.exponent;
+        ++significantDigits;
+      }
+      if (anyDigit) {
+        p= fraction;
+      }
+    }
+    if (!anyDigit) {
+      return false;
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+      const char* exp= p + 1;
+      bool negativeExp= false;
+      int32_t expValue= 0;
+
+      if (exp < end && (*exp == '-' || *exp == '+')) {
+        negativeExp= (*exp == '-');
+        ++exp;
+      }
+      if (exp < end && isDigit(*exp)) {
+        for (; exp < end && isDigit(*exp); ++exp) {
+          // Anything this big overflows or underflows anyway, and is left to the C library
+          if (expValue < 100000) {
+            expValue= expValue * 10 + (*exp - '0');
+          }
+        }
+        parts.exponent+= negativeExp ? -expValue : expValue;
+        p= exp;
+      }
+    }
+    parts.end= p;
+    return true;
+  }
+
+  /* Calls strtod or strtof on null-terminated copy of the string, with '.' replaced by the locale decimal point */
+  template <typename T, T(*strtoT)(const char*, char**)>
+  const char* parseWithLibrary(const char* str, std::size_t len, T& result)
+  {
+    char local[FloatConversion::BUFFER_SIZE * 2];
+    std::string heap;
+    char* copy= local;
+
+    if (len >= sizeof(local)) {
+      heap.assign(str, len);
+      copy= &heap[0];
+    }
+    else {
+      std::memcpy(local, str, len);
+      local[len]= '\0';
+    }
+
+    const char decimalPoint= localeDecimalPoint();
+    if (decimalPoint != '.') {
+      for (std::size_t i= 0; i < len; ++i) {
+        if (copy[i] == decimalPoint) {
+          copy[i]= '\0';
+          break;
+        }
+        else if (copy[i] == '.') {
+          copy[i]= decimalPoint;
+        }
+      }
+    }
+    char* end= nullptr;
+    result= strtoT(copy, &end);
+    return str + (end - copy);
+  }
+
+  /* Prints value with given precision, and checks if it's parsed back to the same value */
+  template <typename T>
+  std::size_t formatShortest(T value, char* buf, int32_t minPrecision, int32_t maxPrecision)
+  {
+    const char decimalPoint= localeDecimalPoint();
+    std::size_t len= 0;
+
+    for (int32_t precision= minPrecision; precision <= maxPrecision; ++precision) {
+      int written= std::snprintf(buf, FloatConversion::BUFFER_SIZE, "%.*g", precision, static_cast<double>(value));
+      len= written > 0 ? static_cast<std::size_t>(written) : 0;
+
+      if (decimalPoint != '.') {
+        for (std::size_t i= 0; i < len; ++i) {
+          if (buf[i] == decimalPoint) {
+            buf[i]= '.';
+            break;
+          }
+        }
+      }
+      T check;
+      if (FloatConversion::parse(buf, len, check) == buf + len && check == value) {
+        break;
+      }
+    }
+    return len;
+  }
+}
+
+
+  std::size_t FloatConversion::format(double value, char* buf)
+  {
+    return formatShortest(value, buf, DBL_DIG, DBL_DIG + 2);
+  }
+
+
+  std::size_t FloatConversion::format(float value, char* buf)
+  {
+    return formatShortest(value, buf, FLT_DIG, FLT_DIG + 3);
+  }
+
+
+  const char* FloatConversion::parse(const char* str, std::size_t len, double& result)
+  {
+    DecimalParts parts;
+
+    if (exactArithmetic && scanDecimal(str, len, parts)) {
+      // Both the mantissa and the power of 10 are exact doubles, thus the result of one operation is correctly rounded
+      if (parts.mantissa == 0) {
+        result= parts.negative ? -0.0 : 0.0;
+        return parts.end;
+      }
+      if (parts.mantissa <= (1ULL << 53) && parts.exponent >= -22 && parts.exponent <= 22) {
+        double value= static_cast<double>(parts.mantissa);
+        value= parts.exponent < 0 ? value / powersOf10[-parts.exponent] : value * powersOf10[parts.exponent];
+        result= parts.negative ? -value : value;
+        return parts.end;
+      }
+    }
+    return parseWithLibrary<double, std::strtod>(str, len, result);
+  }
+
+
+  const char* FloatConversion::parse(const char* str, std::size_t len, float& result)
+  {
+    DecimalParts parts;
+
+    if (exactArithmetic && scanDecimal(str, len, parts)) {
+      if (parts.mantissa == 0) {
+        result= parts.negative ? -0.0f : 0.0f;
+        return parts.end;
+      }
+      if (parts.mantissa <= (1ULL << 24) && parts.exponent >= -10 && parts.exponent <= 10) {
+        float value= static_cast<float>(parts.mantissa);
+        value= parts.exponent < 0 ? value / powersOf10f[-parts.exponent] : value * powersOf10f[parts.exponent];
+        result= parts.negative ? -value : value;
+        return parts.end;
+      }
+    }
+    return parseWithLibrary<float, std::strtof>(str, len, result);
+  }
+
+
+  double FloatConversion::toDouble(const char* str, std::size_t len)
+  {
+    double result;
+    errno= 0;
+    if (parse(str, len, result) == str) {
+      throw std::invalid_argument("FloatConversion::toDouble");
+    }
+    if (errno == ERANGE) {
+      throw std::out_of_range("FloatConversion::toDouble");
+    }
+    return result;
+  }
+
+
+  float FloatConversion::toFloat(const char* str, std::size_t len)
+  {
+    float result;
+    errno= 0;
+    if (parse(str, len, result) == str) {
+      throw std::invalid_argument("FloatConversion::toFloat");
+    }
+    if (errno == ERANGE) {
+      throw std::out_of_range("FloatConversion::toFloat");
+    }
+    return result;
+  }
+}
+}
@@ -0,0 +1,65 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _FLOATCONVERSION_H_
+#define _FLOATCONVERSION_H_
+
+#include <cstddef>
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Locale-independent conversions of floating point numbers to and from text, that do not allocate memory.
+ * Formatting produces the shortest representation, that is parsed back to exactly the same value. Parsing of
+ * numbers with up to 19 significant digits and moderate exponent is done without calling the C library.
+ */
+class FloatConversion final
+{
+  FloatConversion()= delete;
+
+public:
+  /* Buffer size sufficient for any value, including terminating null */
+  static const std::size_t BUFFER_SIZE= 32;
+
+  /* Writes the value to buf of at least BUFFER_SIZE bytes. Returns length of the written string */
+  static std::size_t format(double value, char* buf);
+  static std::size_t format(float value, char* buf);
+
+  /**
+   * Parses the number in the same way as std::strtod does, but with '.' as decimal point regardless of the locale,
+   * and not reading past str + len.
+   *
+   * @return pointer to the first character after the number, or str if no conversion could be performed
+   */
+  static const char* parse(const char* str, std::size_t len, double& result);
+  static const char* parse(const char* str, std::size_t len, float& result);
+
+  /* Like std::stod/std::stof - throws std::invalid_argument or std::out_of_range if the string can't be converted */
+  static double toDouble(const char* str, std::size_t len);
+  static float toFloat(const char* str, std::size_t len);
+};
+
+}
+}
+#endif
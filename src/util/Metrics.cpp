@@ -0,0 +1,268 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <chrono>
+#include <sstream>
+
+#include "Metrics.h"
+
+#include "conncpp/Metrics.hpp"
+#include "conncpp/Exception.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+  namespace
+  {
+    struct CounterInfo {
+      const char* key;
+      const char* name;
+      const char* label;
+      const char* help;
+    };
+
+    /* In the order of Metrics::Counter. Counters with the same name must go one after another */
+    const CounterInfo counterInfo[]= {
+      {"round_trips", "round_trips_total", nullptr, "Commands sent to the server"},
+      {"payload_bytes_sent", "payload_bytes_sent_total", nullptr,
+        "Bytes of query texts and long data parameters sent to the server"},
+      {"payload_bytes_received", "payload_bytes_received_total", nullptr,
+        "Bytes of text protocol row values received from the server"},
+      {"server_prepares", "server_prepares_total", nullptr, "Statements prepared on the server"},
+      {"batch_rewrite", "client_batches_total", "strategy=\"rewrite\"",
+        "Batches of client-side prepared statements by the way they have been executed"},
+      {"batch_multi_rewrite", "client_batches_total", "strategy=\"multi_rewrite\"", nullptr},
+      {"batch_bulk", "client_batches_total", "strategy=\"bulk\"", nullptr},
+      {"batch_multi", "client_batches_total", "strategy=\"multi\"", nullptr},
+      {"batch_slow", "client_batches_total", "strategy=\"slow\"", nullptr},
+      {"reconnects", "reconnects_total", nullptr, "Reconnects of connections"},
+      {"result_sets_buffered", "result_sets_total", "mode=\"buffered\"", "Result sets by the way their rows are read"},
+      {"result_sets_streaming", "result_sets_total", "mode=\"streaming\"", nullptr},
+      {"result_cache_hits", "result_cache_hits_total", nullptr, "Queries served from the query result cache"}
+    };
+    static_assert(sizeof(counterInfo)/sizeof(counterInfo[0]) == Metrics::COUNTER_COUNT, "Counter without description");
+
+    const char* PREFIX= "mariadb_";
+
+    /* Prints microseconds as seconds without losing precision */
+    void printSeconds(std::ostringstream& out, int64_t micros)
+    {
+      int64_t fraction= micros % 1000000;
+      out << micros / 1000000 << '.';
+      for (int64_t digit= 100000; digit > 0; digit/= 10) {
+        out << static_cast<char>('0' + (fraction / digit) % 10);
+      }
+    }
+  }
+
+  const int64_t Metrics::BUCKET_BOUNDS[]= {1, 4, 16, 64, 256, 1024, 4096, 16384, 65536, 262144, 1048576, INT64_MAX};
+
+  Metrics::Shard Metrics::shards[SHARD_COUNT];
+  std::atomic<std::size_t> Metrics::nextShard(0);
+
+
+  Metrics::Shard& Metrics::shard()
+  {
+    /* Constant initialization, i.e. no guard on every call */
+    static thread_local std::size_t threadShard= SHARD_COUNT;
+
+    if (threadShard == SHARD_COUNT) {
+      threadShard= nextShard.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT;
+    }
+    return shards[threadShard];
+  }
+
+
+  void Metrics::observe(Histogram histogram, int64_t micros)
+  {
+    std::size_t i= 0;
+
+    while (micros > BUCKET_BOUNDS[i]) {
+      ++i;
+    }
+    Shard& current= shard();
+    current.bucket[histogram][i].fetch_add(1, std::memory_order_relaxed);
+    current.sum[histogram].fetch_add(micros, std::memory_order_relaxed);
+  }
+
+
+  std::unique_lock<std::mutex> Metrics::lock(std::mutex& mutex)
+  {
+    std::unique_lock<std::mutex> locked(mutex, std::try_to_lock);
+
+    if (locked.owns_lock()) {
+      observe(LOCK_WAIT, 0);
+    }
+    else {
+      auto start= std::chrono::steady_clock::now();
+      locked.lock();
+      observe(LOCK_WAIT,
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+    return locked;
+  }
+
+
+  int64_t Metrics::total(Counter counter)
+  {
+    int64_t result= 0;
+    for (auto& it : shards) {
+      result+= it.counter[counter].load(std::memory_order_relaxed);
+    }
+    return result;
+  }
+
+
+  int64_t Metrics::get(const SQLString& name)
+  {
+    for (std::size_t i= 0; i < COUNTER_COUNT; ++i) {
+      if (name.compare(counterInfo[i].key) == 0) {
+        return total(static_cast<Counter>(i));
+      }
+    }
+
+    bool count= name.compare("lock_waits") == 0;
+    if (count || name.compare("lock_wait_micros") == 0) {
+      int64_t result= 0;
+      for (auto& it : shards) {
+        if (count) {
+          for (auto& bucket : it.bucket[LOCK_WAIT]) {
+            result+= bucket.load(std::memory_order_relaxed);
+          }
+        }
+        else {
+          result+= it.sum[LOCK_WAIT].load(std::memory_order_relaxed);
+        }
+      }
+      return result;
+    }
+    throw IllegalArgumentException("Unknown metric: " + name, "HY000");
+  }
+
+
+  SQLString Metrics::dump(bool json)
+  {
+    std::ostringstream out;
+
+    if (json) {
+      out << '{';
+    }
+    for (std::size_t i= 0; i < COUNTER_COUNT; ++i) {
+      const CounterInfo& info= counterInfo[i];
+      int64_t value= total(static_cast<Counter>(i));
+
+      if (json) {
+        out << '"' << info.key << "\":" << value << ',';
+        continue;
+      }
+      if (info.help != nullptr) {
+        out << "# HELP " << PREFIX << info.name << ' ' << info.help << '\n';
+        out << "# TYPE " << PREFIX << info.name << " counter\n";
+      }
+      out << PREFIX << info.name;
+      if (info.label != nullptr) {
+        out << '{' << info.label << '}';
+      }
+      out << ' ' << value << '\n';
+    }
+
+    int64_t bucketTotal[BUCKET_COUNT]= {0}, sum= 0, cumulative= 0;
+    for (auto& it : shards) {
+      for (std::size_t i= 0; i < BUCKET_COUNT; ++i) {
+        bucketTotal[i]+= it.bucket[LOCK_WAIT][i].load(std::memory_order_relaxed);
+      }
+      sum+= it.sum[LOCK_WAIT].load(std::memory_order_relaxed);
+    }
+
+    if (json) {
+      out << "\"lock_wait\":{\"buckets\":{";
+      for (std::size_t i= 0; i < BUCKET_COUNT; ++i) {
+        cumulative+= bucketTotal[i];
+        out << (i > 0 ? "," : "") << '"';
+        if (i + 1 < BUCKET_COUNT) {
+          out << BUCKET_BOUNDS[i];
+        }
+        else {
+          out << "+Inf";
+        }
+        out << "\":" << cumulative;
+      }
+      out << "},\"count\":" << cumulative << ",\"sum_micros\":" << sum << "}}";
+    }
+    else {
+      out << "# HELP " << PREFIX << "lock_wait_seconds Time statement executions have waited for the connection\n";
+      out << "# TYPE " << PREFIX << "lock_wait_seconds histogram\n";
+      for (std::size_t i= 0; i < BUCKET_COUNT; ++i) {
+        cumulative+= bucketTotal[i];
+        out << PREFIX << "lock_wait_seconds_bucket{le=\"";
+        if (i + 1 < BUCKET_COUNT) {
+          printSeconds(out, BUCKET_BOUNDS[i]);
+        }
+        else {
+          out << "+Inf";
+        }
+        out << "\"} " << cumulative << '\n';
+      }
+      out << PREFIX << "lock_wait_seconds_sum ";
+      printSeconds(out, sum);
+      out << '\n' << PREFIX << "lock_wait_seconds_count " << cumulative << '\n';
+    }
+    return out.str();
+  }
+
+
+  void Metrics::reset()
+  {
+    for (auto& it : shards) {
+      for (auto& counter : it.counter) {
+        counter.store(0, std::memory_order_relaxed);
+      }
+      for (auto& histogram : it.bucket) {
+        for (auto& bucket : histogram) {
+          bucket.store(0, std::memory_order_relaxed);
+        }
+      }
+      for (auto& sum : it.sum) {
+        sum.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+
+  int64_t get_metric(const SQLString& name)
+  {
+    return Metrics::get(name);
+  }
+
+
+  SQLString dump_metrics(bool json)
+  {
+    return Metrics::dump(json);
+  }
+
+
+  void reset_metrics()
+  {
+    Metrics::reset();
+  }
+}
+}
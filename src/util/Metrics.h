@@ -0,0 +1,107 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _METRICS_H_
+#define _METRICS_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+#include "SQLString.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Driver-wide metrics registry. Counters are sharded - each thread updates the shard it has been assigned on first
+ * use, with relaxed atomic operations only, so threads do not contend for the same cache line. Shards are summed up
+ * on read.
+ */
+class Metrics final
+{
+public:
+  enum Counter {
+    ROUND_TRIPS= 0,
+    PAYLOAD_BYTES_SENT,
+    PAYLOAD_BYTES_RECEIVED,
+    SERVER_PREPARES,
+    BATCH_REWRITE,
+    BATCH_MULTI_REWRITE,
+    BATCH_BULK,
+    BATCH_MULTI,
+    BATCH_SLOW,
+    RECONNECTS,
+    RESULT_SETS_BUFFERED,
+    RESULT_SETS_STREAMING,
+    RESULT_CACHE_HITS,
+    COUNTER_COUNT
+  };
+
+  enum Histogram {
+    LOCK_WAIT= 0,
+    HISTOGRAM_COUNT
+  };
+
+  /* Upper bounds of histogram buckets in microseconds. The last bucket is unbounded */
+  static const int64_t BUCKET_BOUNDS[];
+  static const std::size_t BUCKET_COUNT= 12;
+
+private:
+  static const std::size_t SHARD_COUNT= 16;
+
+  struct Shard {
+    std::atomic<int64_t> counter[COUNTER_COUNT];
+    std::atomic<int64_t> bucket[HISTOGRAM_COUNT][BUCKET_COUNT];
+    std::atomic<int64_t> sum[HISTOGRAM_COUNT];
+    /* Keeps neighbour shards off this shard's cache lines */
+    char padding[64];
+  };
+
+  static Shard shards[SHARD_COUNT];
+  static std::atomic<std::size_t> nextShard;
+
+  static Shard& shard();
+  static int64_t total(Counter counter);
+
+  Metrics()= delete;
+
+public:
+  static void increment(Counter counter, int64_t delta= 1)
+  {
+    shard().counter[counter].fetch_add(delta, std::memory_order_relaxed);
+  }
+
+  static void observe(Histogram histogram, int64_t micros);
+  /* Locks the mutex, and observes in the LOCK_WAIT histogram how long it has waited for it. The clock is read only
+     if the mutex is already locked */
+  static std::unique_lock<std::mutex> lock(std::mutex& mutex);
+
+  static int64_t get(const SQLString& name);
+  static SQLString dump(bool json);
+  static void reset();
+};
+
+}
+}
+#endif
@@ -0,0 +1,335 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+
+#ifdef _WIN32
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+#include "ResultSetExporter.h"
+
+#include "SelectResultSet.h"
+#include "Exception.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace
+{
+  const char HEX_DIGITS[]= "0123456789ABCDEF";
+
+  /* Character, that follows the escape character for the special character c */
+  char escapeSequence(char c)
+  {
+    switch (c) {
+    case '\0':
+      return '0';
+    case '\n':
+      return 'n';
+    case '\r':
+      return 'r';
+    case '\t':
+      return 't';
+    default:
+      return c;
+    }
+  }
+
+
+  SelectResultSet* toSelectResultSet(ResultSet* rs)
+  {
+    SelectResultSet* selectResultSet= dynamic_cast<SelectResultSet*>(rs);
+
+    if (selectResultSet == nullptr) {
+      throw IllegalArgumentException("ResultSet object does not belong to this driver", "HY000");
+    }
+    return selectResultSet;
+  }
+
+
+  void writeToStream(const char* data, std::size_t length, void* context)
+  {
+    std::ostream* out= static_cast<std::ostream*>(context);
+
+    out->write(data, static_cast<std::streamsize>(length));
+    if (!*out) {
+      throw SQLException("Could not write exported rows to the stream", "HY000");
+    }
+  }
+
+
+  void writeToFile(const char* data, std::size_t length, void* context)
+  {
+    int fd= *static_cast<int*>(context);
+
+    while (length > 0) {
+#ifdef _WIN32
+      int written= _write(fd, data, static_cast<unsigned int>(std::min<std::size_t>(length, INT32_MAX)));
+#else
+      ssize_t written= write(fd, data, length);
+#endif
+      if (written < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        throw SQLException(SQLString("Could not write exported rows: ") + std::strerror(errno), "HY000");
+      }
+      data+= written;
+      length-= static_cast<std::size_t>(written);
+    }
+  }
+}
+
+
+  ResultSetExporter::ResultSetExporter(ExportWriter _writer, void* _context, const ExportOptions& _options)
+    : options(_options)
+    , writer(_writer)
+    , context(_context)
+    , capacity(std::max<std::size_t>(_options.bufferSize, 1))
+    , nullValueLength(_options.nullValue != nullptr ? std::strlen(_options.nullValue) : 0)
+    , lineTerminatorLength(_options.lineTerminator != nullptr ? std::strlen(_options.lineTerminator) : 0)
+  {
+    buffer.reset(new char[capacity]);
+    std::memset(special, 0, sizeof(special));
+
+    special[static_cast<unsigned char>(options.fieldSeparator)]= true;
+    special[static_cast<unsigned char>('\n')]= true;
+    special[static_cast<unsigned char>('\r')]= true;
+    if (lineTerminatorLength > 0) {
+      special[static_cast<unsigned char>(options.lineTerminator[0])]= true;
+    }
+    if (options.escape != '\0') {
+      special[static_cast<unsigned char>(options.escape)]= true;
+    }
+    if (options.quoting == ExportOptions::QUOTE_NONE) {
+      special[static_cast<unsigned char>('\0')]= options.escape != '\0';
+      special[static_cast<unsigned char>('\t')]= true;
+    }
+    else {
+      special[static_cast<unsigned char>(options.quote)]= true;
+    }
+  }
+
+
+  void ResultSetExporter::append(const char* str, std::size_t length)
+  {
+    while (length > 0) {
+      if (used == capacity) {
+        flush();
+      }
+      std::size_t portion= std::min(length, capacity - used);
+      std::memcpy(buffer.get() + used, str, portion);
+      used+= portion;
+      str+= portion;
+      length-= portion;
+    }
+  }
+
+  /* Writes the value content between quotes, escaping or doubling quotes */
+  void ResultSetExporter::appendQuoted(const char* str, std::size_t length)
+  {
+    const char* end= str + length;
+    const char* runStart= str;
+
+    for (const char* it= str; it < end; ++it) {
+      if (*it == options.quote || (*it == options.escape && options.escape != '\0')) {
+        append(runStart, it - runStart);
+        put(options.escape != '\0' ? options.escape : options.quote);
+        runStart= it;
+      }
+    }
+    append(runStart, end - runStart);
+  }
+
+  /* Writes unquoted value, prefixing special characters with the escape character. With QUOTE_MINIMAL unquoted values
+     do not contain special characters */
+  void ResultSetExporter::appendEscaped(const char* str, std::size_t length)
+  {
+    if (options.escape == '\0' || options.quoting != ExportOptions::QUOTE_NONE) {
+      append(str, length);
+      return;
+    }
+    const char* end= str + length;
+    const char* runStart= str;
+
+    for (const char* it= str; it < end; ++it) {
+      if (isSpecial(*it)) {
+        append(runStart, it - runStart);
+        put(options.escape);
+        put(escapeSequence(*it));
+        runStart= it + 1;
+      }
+    }
+    append(runStart, end - runStart);
+  }
+
+
+  void ResultSetExporter::appendHex(const char* str, std::size_t length)
+  {
+    const char* end= str + length;
+
+    for (const char* it= str; it < end; ++it) {
+      put(HEX_DIGITS[static_cast<unsigned char>(*it) >> 4]);
+      put(HEX_DIGITS[static_cast<unsigned char>(*it) & 0x0f]);
+    }
+  }
+
+
+  void ResultSetExporter::appendContent(const char* str, std::size_t length, bool binary, bool quoted)
+  {
+    if (binary && options.binaryAsHex) {
+      appendHex(str, length);
+    }
+    else if (quoted) {
+      appendQuoted(str, length);
+    }
+    else {
+      appendEscaped(str, length);
+    }
+  }
+
+
+  void ResultSetExporter::separate()
+  {
+    if (firstInRow) {
+      firstInRow= false;
+    }
+    else {
+      put(options.fieldSeparator);
+    }
+  }
+
+
+  void ResultSetExporter::addNull()
+  {
+    separate();
+    append(options.nullValue, nullValueLength);
+  }
+
+
+  void ResultSetExporter::addValue(const char* str, std::size_t length, bool binary)
+  {
+    bool quoted= false;
+
+    separate();
+    switch (options.quoting) {
+    case ExportOptions::QUOTE_ALL:
+      quoted= true;
+      break;
+    case ExportOptions::QUOTE_MINIMAL:
+      if (length == 0) {
+        quoted= nullValueLength == 0;
+      }
+      else if (!binary || !options.binaryAsHex) {
+        const char* end= str + length;
+        for (const char* it= str; it < end && !quoted; ++it) {
+          quoted= isSpecial(*it);
+        }
+      }
+      break;
+    case ExportOptions::QUOTE_NONE:
+      break;
+    }
+
+    if (quoted) {
+      put(options.quote);
+      appendContent(str, length, binary, true);
+      put(options.quote);
+    }
+    else {
+      appendContent(str, length, binary, false);
+    }
+  }
+
+
+  void ResultSetExporter::beginValue(bool binary)
+  {
+    separate();
+    partBinary= binary;
+    // The content is not known in advance, thus quoting it, if that is not forbidden
+    partQuoted= options.quoting != ExportOptions::QUOTE_NONE;
+    if (partQuoted) {
+      put(options.quote);
+    }
+  }
+
+
+  void ResultSetExporter::appendPart(const char* str, std::size_t length)
+  {
+    appendContent(str, length, partBinary, partQuoted);
+  }
+
+
+  void ResultSetExporter::endValue()
+  {
+    if (partQuoted) {
+      put(options.quote);
+    }
+  }
+
+
+  void ResultSetExporter::endRow()
+  {
+    append(options.lineTerminator, lineTerminatorLength);
+    firstInRow= true;
+  }
+
+
+  void ResultSetExporter::flush()
+  {
+    if (used > 0) {
+      writer(buffer.get(), used, context);
+      used= 0;
+    }
+  }
+
+
+  int64_t export_result_set(ResultSet* rs, std::ostream& out, const ExportOptions& options)
+  {
+    return export_result_set(rs, writeToStream, static_cast<void*>(&out), options);
+  }
+
+
+  int64_t export_result_set(ResultSet* rs, int fd, const ExportOptions& options)
+  {
+    return export_result_set(rs, writeToFile, static_cast<void*>(&fd), options);
+  }
+
+
+  int64_t export_result_set(ResultSet* rs, ExportWriter writer, void* context, const ExportOptions& options)
+  {
+    SelectResultSet* selectResultSet= toSelectResultSet(rs);
+
+    if (writer == nullptr) {
+      throw IllegalArgumentException("Export writer cannot be null", "HY000");
+    }
+    ResultSetExporter exporter(writer, context, options);
+    return selectResultSet->exportRows(exporter);
+  }
+}
+}
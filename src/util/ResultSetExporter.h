@@ -0,0 +1,92 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _RESULTSETEXPORTER_H_
+#define _RESULTSETEXPORTER_H_
+
+#include <memory>
+
+#include "ResultSetExport.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Encodes values of exported rows in CSV or TSV format into the output buffer, and passes the buffer to the writer, when it
+ * gets full. Values are taken as pointer and length, thus they can be written right from the row buffers.
+ */
+class ResultSetExporter final
+{
+  const ExportOptions options;
+  ExportWriter writer;
+  void* context;
+  std::unique_ptr<char[]> buffer;
+  std::size_t capacity;
+  std::size_t used= 0;
+  std::size_t nullValueLength;
+  std::size_t lineTerminatorLength;
+  /* Characters, that make the value to be quoted with QUOTE_MINIMAL, or that are escaped with QUOTE_NONE */
+  bool special[256];
+  bool firstInRow= true;
+  /* State of the value written in parts */
+  bool partQuoted= false;
+  bool partBinary= false;
+
+  void put(char c)
+  {
+    if (used == capacity) {
+      flush();
+    }
+    buffer[used++]= c;
+  }
+
+  bool isSpecial(char c) const { return special[static_cast<unsigned char>(c)]; }
+  void append(const char* str, std::size_t length);
+  void appendQuoted(const char* str, std::size_t length);
+  void appendEscaped(const char* str, std::size_t length);
+  void appendHex(const char* str, std::size_t length);
+  void appendContent(const char* str, std::size_t length, bool binary, bool quoted);
+  void separate();
+
+public:
+  ResultSetExporter(ExportWriter writer, void* context, const ExportOptions& options);
+
+  ResultSetExporter(const ResultSetExporter&)= delete;
+  ResultSetExporter& operator=(const ResultSetExporter&)= delete;
+
+  bool withHeader() const { return options.header; }
+
+  void addNull();
+  void addValue(const char* str, std::size_t length, bool binary);
+  /* Value, that is not in memory as a whole, is added with beginValue, any number of appendPart and endValue */
+  void beginValue(bool binary);
+  void appendPart(const char* str, std::size_t length);
+  void endValue();
+  void endRow();
+  /* Passes buffered data to the writer */
+  void flush();
+};
+
+}
+}
+#endif
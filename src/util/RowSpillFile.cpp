@@ -0,0 +1,200 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+#include <cerrno>
+#include <cstring>
+
+#ifndef _WIN32
+# include <sys/mman.h>
+#endif
+
+#include "RowSpillFile.h"
+
+#include "Exception.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+namespace
+{
+  const unsigned char NULL_VALUE= 251;
+
+  void throwFileError(const char* operation)
+  {
+    throw SQLException(SQLString("Could not ") + operation + " temporary file for result set rows: " + std::strerror(errno),
+      "HY000");
+  }
+
+
+  void storeInt(std::vector<char>& buf, uint64_t value, std::size_t bytes)
+  {
+    for (std::size_t i= 0; i < bytes; ++i, value>>= 8) {
+      buf.push_back(static_cast<char>(value & 0xff));
+    }
+  }
+
+
+  uint64_t readInt(const char*& pos, std::size_t bytes)
+  {
+    uint64_t value= 0;
+    for (std::size_t i= 0; i < bytes; ++i) {
+      value|= static_cast<uint64_t>(static_cast<unsigned char>(*pos++)) << (8*i);
+    }
+    return value;
+  }
+}
+
+
+  RowSpillFile::RowSpillFile()
+    : file(std::tmpfile())
+    , offsets(1, 0)
+  {
+    if (file == nullptr) {
+      throwFileError("create");
+    }
+  }
+
+
+  RowSpillFile::~RowSpillFile()
+  {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+      munmap(mapping, mappingSize);
+    }
+#endif
+    // The file is deleted once closed
+    std::fclose(file);
+  }
+
+
+  void RowSpillFile::append(const std::vector<sql::bytes>& row)
+  {
+    encoded.clear();
+
+    for (auto& value : row) {
+      uint64_t length= value.size();
+
+      if (value.arr == nullptr) {
+        encoded.push_back(static_cast<char>(NULL_VALUE));
+        continue;
+      }
+      else if (length < 251) {
+        storeInt(encoded, length, 1);
+      }
+      else if (length < 0x10000) {
+        encoded.push_back(static_cast<char>(0xfc));
+        storeInt(encoded, length, 2);
+      }
+      else if (length < 0x1000000) {
+        encoded.push_back(static_cast<char>(0xfd));
+        storeInt(encoded, length, 3);
+      }
+      else {
+        encoded.push_back(static_cast<char>(0xfe));
+        storeInt(encoded, length, 8);
+      }
+      encoded.insert(encoded.end(), value.begin(), value.end());
+      // Some conversions treat values as null-terminated strings, and the value may be at the end of the mapping
+      encoded.push_back('\0');
+    }
+#ifdef _WIN32
+    if (!atEnd && _fseeki64(file, 0, SEEK_END) != 0) {
+      throwFileError("write to");
+    }
+    atEnd= true;
+#else
+    flushed= false;
+#endif
+    if (!encoded.empty() && std::fwrite(encoded.data(), 1, encoded.size(), file) != encoded.size()) {
+      throwFileError("write to");
+    }
+    offsets.push_back(offsets.back() + encoded.size());
+  }
+
+
+  const char* RowSpillFile::rowStart(std::size_t rowNum)
+  {
+    uint64_t start= offsets[rowNum], end= offsets[rowNum + 1];
+#ifdef _WIN32
+    readBuffer.resize(static_cast<std::size_t>(end - start) + 1);
+    atEnd= false;
+    if (_fseeki64(file, static_cast<__int64>(start), SEEK_SET) != 0 ||
+      std::fread(readBuffer.data(), 1, static_cast<std::size_t>(end - start), file) != end - start) {
+      throwFileError("read from");
+    }
+    return readBuffer.data();
+#else
+    if (end > mappingSize) {
+      if (!flushed && std::fflush(file) != 0) {
+        throwFileError("write to");
+      }
+      flushed= true;
+      if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+        mapping= nullptr;
+      }
+      // Private writable mapping - values are never written by the getters, but they are not required to be read-only
+      mappingSize= static_cast<std::size_t>(offsets.back());
+      void* newMapping= mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(file), 0);
+      if (newMapping == MAP_FAILED) {
+        mappingSize= 0;
+        throwFileError("map");
+      }
+      mapping= static_cast<char*>(newMapping);
+    }
+    return mapping + start;
+#endif
+  }
+
+
+  void RowSpillFile::read(std::size_t rowNum, std::vector<sql::bytes>& row)
+  {
+    const char* pos= rowStart(rowNum);
+    const char* end= pos + (offsets[rowNum + 1] - offsets[rowNum]);
+
+    row.clear();
+    while (pos < end) {
+      unsigned char prefix= static_cast<unsigned char>(*pos++);
+      uint64_t length= prefix;
+
+      switch (prefix) {
+      case NULL_VALUE:
+        row.emplace_back();
+        continue;
+      case 0xfc:
+        length= readInt(pos, 2);
+        break;
+      case 0xfd:
+        length= readInt(pos, 3);
+        break;
+      case 0xfe:
+        length= readInt(pos, 8);
+        break;
+      default:
+        break;
+      }
+      row.emplace_back(const_cast<char*>(pos), static_cast<std::size_t>(length));
+      pos+= length + 1;
+    }
+  }
+}
+}
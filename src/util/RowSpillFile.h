@@ -0,0 +1,75 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+
+
+#ifndef _ROWSPILLFILE_H_
+#define _ROWSPILLFILE_H_
+
+#include <cstdio>
+#include <vector>
+
+#include "CArray.hpp"
+
+namespace sql
+{
+namespace mariadb
+{
+/**
+ * Temporary file, to which a result set writes rows, that do not fit its memory limit. Rows are stored in the
+ * compact form - each value is prefixed with its length encoded the same way as in the protocol, and followed by
+ * the terminating null. The offset index is kept in memory. Rows are read back through the memory mapping of the file, without copying.
+ */
+class RowSpillFile final
+{
+  std::FILE* file;
+  /* Offsets of all rows in the file, and the end of the last row */
+  std::vector<uint64_t> offsets;
+  std::vector<char> encoded;
+#ifdef _WIN32
+  std::vector<char> readBuffer;
+  bool atEnd= true;
+#else
+  char* mapping= nullptr;
+  std::size_t mappingSize= 0;
+  bool flushed= true;
+#endif
+
+  const char* rowStart(std::size_t rowNum);
+
+public:
+  RowSpillFile();
+  ~RowSpillFile();
+
+  RowSpillFile(const RowSpillFile&)= delete;
+  RowSpillFile& operator=(const RowSpillFile&)= delete;
+
+  std::size_t size() const { return offsets.size() - 1; }
+  /* Returns total size of the stored rows in bytes */
+  uint64_t byteSize() const { return offsets.back(); }
+
+  void append(const std::vector<sql::bytes>& row);
+  /* Makes the row to wrap values of the stored row. They stay valid until the next call to read */
+  void read(std::size_t rowNum, std::vector<sql::bytes>& row);
+};
+
+}
+}
+#endif
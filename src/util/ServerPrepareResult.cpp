@@ -18,6 +18,8 @@
 *************************************************************************************/
 
 
+#include <cstring>
+
 #include "ServerPrepareResult.h"
 
 #include "Protocol.h"
@@ -51,6 +53,9 @@ namespace mariadb
 {
   ServerPrepareResult::~ServerPrepareResult()
   {
+    if (unProxiedProtocol != nullptr) {
+      unProxiedProtocol->unregisterPrepareResult(this);
+    }
     if (metadata) {
       capi::mysql_free_result(metadata);
     }
@@ -127,9 +132,58 @@ namespace mariadb
   }
 
 
+  static bool sameName(const char* str1, unsigned int len1, const char* str2, unsigned int len2)
+  {
+    return len1 == len2 && (len1 == 0 || std::memcmp(str1, str2, len1) == 0);
+  }
+
+  /**
+    * Checks if the metadata, that the statement handle got with the last result, differs from the one
+    * column definitions have been created from. With metadata caching the server does not send
+    * the metadata if it hasn't changed, and the connector library keeps the one from the prepare.
+    *
+    * @return true if column definitions have to be re-created
+    */
+  bool ServerPrepareResult::columnsChanged() const
+  {
+    if (mysql_stmt_field_count(statementId) != columns.size()) {
+      return true;
+    }
+    if (metadata == nullptr) {
+      return columns.size() > 0;
+    }
+    const capi::MYSQL_FIELD* current= statementId->fields;
+    const capi::MYSQL_FIELD* cached= capi::mysql_fetch_fields(metadata);
+
+    if (current == nullptr || cached == nullptr) {
+      return columns.size() > 0;
+    }
+    for (std::size_t i= 0; i < columns.size(); ++i, ++current, ++cached) {
+      if (current->type != cached->type || current->charsetnr != cached->charsetnr || current->flags != cached->flags ||
+        current->decimals != cached->decimals || current->length != cached->length ||
+        !sameName(current->name, current->name_length, cached->name, cached->name_length) ||
+        !sameName(current->org_name, current->org_name_length, cached->org_name, cached->org_name_length) ||
+        !sameName(current->table, current->table_length, cached->table, cached->table_length) ||
+        !sameName(current->org_table, current->org_table_length, cached->org_table, cached->org_table_length) ||
+        !sameName(current->db, current->db_length, cached->db, cached->db_length)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+
   void ServerPrepareResult::reReadColumnInfo()
   {
+    // Column definitions are shared with result sets and their metadata objects, thus re-used as long as they are valid
+    if (!columnsChanged()) {
+      return;
+    }
     if (metadata) {
+      // Objects created before have to stay valid after metadata is freed
+      for (auto& column : columns) {
+        column->makeLocalCopy();
+      }
       capi::mysql_free_result(metadata);
     }
     metadata= mysql_stmt_result_metadata(statementId);
@@ -150,18 +204,51 @@ namespace mariadb
   }
 
   /**
-    * Update information after a failover.
+    * Update information after a failover or reconnection. The statement handle, invalidated by the reconnection, is
+    * replaced with the one prepared on the new connection.
+    *
+    * @param statementId new statement Id
+    * @param unProxiedProtocol the protocol on which the prepare has been done
+    * @return invalidated statement handle. Resultsets can still read it, and the protocol has to close it
+    */
+  capi::MYSQL_STMT* ServerPrepareResult::failover(capi::MYSQL_STMT* statementId, Protocol* unProxiedProtocol)
+  {
+    return swapStatementHandle(statementId, unProxiedProtocol);
+  }
+
+  /**
+    * Replaces the statement handle with the new one, prepared for the same query.
     *
     * @param statementId new statement Id
     * @param unProxiedProtocol the protocol on which the prepare has been done
+    * @return replaced statement handle. The caller is responsible for closing it
     */
-  void ServerPrepareResult::failover(capi::MYSQL_STMT* statementId, Shared::Protocol& unProxiedProtocol)
+  capi::MYSQL_STMT* ServerPrepareResult::swapStatementHandle(capi::MYSQL_STMT* statementId, Protocol* unProxiedProtocol)
   {
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    capi::MYSQL_STMT* replaced= this->statementId;
+
+    // Column definitions can be shared with metadata and resultset objects, and have to outlive the old handle
+    for (auto& column : columns) {
+      column->makeLocalCopy();
+    }
+    if (metadata != nullptr) {
+      capi::mysql_free_result(metadata);
+      metadata= nullptr;
+    }
     this->statementId= statementId;
-    this->unProxiedProtocol= unProxiedProtocol.get();
+    this->unProxiedProtocol= unProxiedProtocol;
+    reReadColumnInfo();
     resetParameterTypeHeader();
-    this->shareCounter= 1;
     this->isBeingDeallocate= false;
+
+    return replaced;
+  }
+
+  /* Called by the protocol, if it is destructed before this object */
+  void ServerPrepareResult::detachProtocol()
+  {
+    unProxiedProtocol= nullptr;
   }
 
   void ServerPrepareResult::setAddToCache()
@@ -228,6 +315,18 @@ namespace mariadb
     return shareCounter;
   }
 
+  void ServerPrepareResult::incrementExecutionCount()
+  {
+    ++executionCount;
+  }
+
+
+  uint64_t ServerPrepareResult::getExecutionCount() const
+  {
+    return executionCount.load();
+  }
+
+
   capi::MYSQL_STMT* ServerPrepareResult::getStatementId()
   {
     return statementId;
@@ -53,6 +53,7 @@ class ServerPrepareResult  : public PrepareResult {
   Protocol* unProxiedProtocol= nullptr;
   std::atomic<int32_t> shareCounter{1};
   std::atomic<bool> isBeingDeallocate{false};
+  std::atomic<uint64_t> executionCount{0};
   std::mutex lock;
 
 public:
@@ -70,10 +71,13 @@ public:
     capi::MYSQL_STMT* statementId,
     Protocol* unProxiedProtocol);
 
+  bool columnsChanged() const;
   void reReadColumnInfo();
 
   void resetParameterTypeHeader();
-  void failover(capi::MYSQL_STMT* statementId, Shared::Protocol& unProxiedProtocol);
+  capi::MYSQL_STMT* failover(capi::MYSQL_STMT* statementId, Protocol* unProxiedProtocol);
+  capi::MYSQL_STMT* swapStatementHandle(capi::MYSQL_STMT* statementId, Protocol* unProxiedProtocol);
+  void detachProtocol();
   void setAddToCache();
   void setRemoveFromCache();
   bool incrementShareCounter();
@@ -81,6 +85,8 @@ public:
   bool canBeDeallocate();
   size_t getParamCount() const;
   int32_t getShareCounter();
+  void incrementExecutionCount();
+  uint64_t getExecutionCount() const;
   capi::MYSQL_STMT* getStatementId();
   const std::vector<Shared::ColumnDefinition>& getColumns() const;
   const std::vector<Shared::ColumnDefinition>& getParameters() const;
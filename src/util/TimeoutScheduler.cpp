@@ -0,0 +1,210 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#include <system_error>
+
+#include "TimeoutScheduler.h"
+
+namespace sql
+{
+namespace mariadb
+{
+  const std::chrono::milliseconds TimeoutScheduler::TICK(100);
+
+  TimeoutScheduler::TimeoutScheduler()
+    : wheel(WHEEL_SIZE)
+    , start(std::chrono::steady_clock::now())
+  {
+  }
+
+
+  TimeoutScheduler::~TimeoutScheduler()
+  {
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      stopped= true;
+    }
+    wakeUp.notify_all();
+    if (worker.joinable()) {
+      worker.join();
+    }
+    // Action threads are detached, and use the scheduler until they finish
+    std::unique_lock<std::mutex> localScopeLock(lock);
+    taskDone.wait(localScopeLock, [this]() { return running == 0; });
+  }
+
+
+  TimeoutScheduler& TimeoutScheduler::getInstance()
+  {
+    static TimeoutScheduler scheduler;
+    return scheduler;
+  }
+
+
+  uint64_t TimeoutScheduler::currentTick()
+  {
+    return static_cast<uint64_t>((std::chrono::steady_clock::now() - start) / TICK);
+  }
+
+  /**
+   * Arms new timer.
+   *
+   * @param action - function to run once the delay expires
+   * @param delay - the delay. Rounded up to the scheduler tick
+   * @return handle to pass to cancel()
+   */
+  std::shared_ptr<TimeoutTask> TimeoutScheduler::schedule(std::function<void()> action, std::chrono::milliseconds delay)
+  {
+    std::shared_ptr<TimeoutTask> task(new TimeoutTask(std::move(action)));
+    uint64_t ticks= static_cast<uint64_t>((delay + TICK - std::chrono::milliseconds(1)) / TICK);
+    std::unique_lock<std::mutex> localScopeLock(lock);
+    uint64_t now= currentTick();
+
+    // Nothing to catch up with - no need to make the thread to walk through idle slots
+    if (armed == 0 && now > processedTick) {
+      processedTick= now;
+    }
+    uint64_t deadline= std::max(processedTick + 1, now + (ticks > 0 ? ticks : 1));
+
+    task->slot= static_cast<std::size_t>(deadline & (WHEEL_SIZE - 1));
+    task->rounds= (deadline - processedTick - 1) / WHEEL_SIZE;
+    auto& bucket= wheel[task->slot];
+    task->position= bucket.insert(bucket.end(), task);
+
+    if (++armed == 1) {
+      if (!worker.joinable()) {
+        worker= std::thread(&TimeoutScheduler::run, this);
+      }
+      localScopeLock.unlock();
+      wakeUp.notify_one();
+    }
+    return task;
+  }
+
+  /**
+   * Disarms the timer. If its action is being run at the moment, waits for it to finish, so the caller can
+   * safely destroy the objects the action refers to.
+   *
+   * @param task - handle returned by schedule()
+   * @return true if the timer was disarmed before it has expired
+   */
+  bool TimeoutScheduler::cancel(const std::shared_ptr<TimeoutTask>& task)
+  {
+    if (!task) {
+      return false;
+    }
+    std::unique_lock<std::mutex> localScopeLock(lock);
+
+    switch (task->state) {
+    case TimeoutTask::PENDING:
+      wheel[task->slot].erase(task->position);
+      --armed;
+      task->state= TimeoutTask::CANCELLED;
+      return true;
+    case TimeoutTask::RUNNING:
+      // The action itself may want to disarm the timer - it must not wait for itself
+      if (std::this_thread::get_id() != task->runner) {
+        taskDone.wait(localScopeLock, [&task]() { return task->state != TimeoutTask::RUNNING; });
+      }
+      return false;
+    default:
+      return false;
+    }
+  }
+
+
+  void TimeoutScheduler::run()
+  {
+    std::vector<std::shared_ptr<TimeoutTask>> expired;
+    std::unique_lock<std::mutex> localScopeLock(lock);
+
+    while (!stopped) {
+      if (armed == 0) {
+        wakeUp.wait(localScopeLock);
+        continue;
+      }
+      uint64_t now= currentTick();
+
+      if (now <= processedTick) {
+        wakeUp.wait_until(localScopeLock, start + TICK*(processedTick + 1));
+        continue;
+      }
+
+      while (processedTick < now && armed > 0) {
+        auto& bucket= wheel[static_cast<std::size_t>(++processedTick & (WHEEL_SIZE - 1))];
+
+        for (auto it= bucket.begin(); it != bucket.end();) {
+          if ((*it)->rounds > 0) {
+            --(*it)->rounds;
+            ++it;
+          }
+          else {
+            (*it)->state= TimeoutTask::RUNNING;
+            expired.push_back(*it);
+            it= bucket.erase(it);
+            --armed;
+          }
+        }
+      }
+      if (armed == 0) {
+        processedTick= now;
+      }
+
+      for (auto& task : expired) {
+        ++running;
+        try {
+          std::thread(&TimeoutScheduler::runAction, this, task).detach();
+        }
+        catch (std::system_error&) {
+          // No thread - the action is run here, as the last resort
+          localScopeLock.unlock();
+          runAction(task);
+          localScopeLock.lock();
+        }
+      }
+      expired.clear();
+    }
+  }
+
+  /**
+   * Runs the action of the expired timer, and wakes up those, who wait for it in cancel().
+   *
+   * @param task - expired timer
+   */
+  void TimeoutScheduler::runAction(std::shared_ptr<TimeoutTask> task)
+  {
+    {
+      std::lock_guard<std::mutex> localScopeLock(lock);
+      task->runner= std::this_thread::get_id();
+    }
+    try {
+      task->action();
+    }
+    catch (...) {
+      // Nobody to report to
+    }
+    std::lock_guard<std::mutex> localScopeLock(lock);
+    task->state= TimeoutTask::DONE;
+    task->action= nullptr;
+    --running;
+    taskDone.notify_all();
+  }
+}
+}
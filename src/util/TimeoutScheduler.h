@@ -0,0 +1,104 @@
+/************************************************************************************
+   Copyright (C) 2023 MariaDB Corporation AB
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Library General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this library; if not see <http://www.gnu.org/licenses>
+   or write to the Free Software Foundation, Inc.,
+   51 Franklin St., Fifth Floor, Boston, MA 02110, USA
+*************************************************************************************/
+
+
+#ifndef _TIMEOUTSCHEDULER_H_
+#define _TIMEOUTSCHEDULER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sql
+{
+namespace mariadb
+{
+class TimeoutScheduler;
+
+/* Timer armed in the TimeoutScheduler. Opaque for everybody but the scheduler */
+class TimeoutTask final
+{
+  friend class TimeoutScheduler;
+
+  enum State {
+    PENDING,
+    RUNNING,
+    DONE,
+    CANCELLED
+  };
+
+  std::function<void()> action;
+  std::size_t slot= 0;
+  uint64_t rounds= 0;
+  State state= PENDING;
+  std::list<std::shared_ptr<TimeoutTask>>::iterator position;
+  /* Thread running the action, once the timer has expired */
+  std::thread::id runner;
+
+public:
+  TimeoutTask(std::function<void()>&& _action) : action(std::move(_action)) {}
+};
+
+/**
+ * Driver-wide scheduler of client-side query timeouts. Implemented as hashed timing wheel, served by one
+ * background thread, that is started on first use. Arming and disarming a timer are O(1) and do not
+ * involve the thread. The wheel thread only does the bookkeeping - action of each expired timer is run
+ * in a separate thread, since it may take long(e.g. KILL QUERY needs new connection to the server).
+ */
+class TimeoutScheduler final
+{
+  static const std::chrono::milliseconds TICK;
+  static const std::size_t WHEEL_SIZE= 512; /* Must be power of 2 */
+
+  std::mutex lock;
+  std::condition_variable wakeUp;
+  std::condition_variable taskDone;
+  std::vector<std::list<std::shared_ptr<TimeoutTask>>> wheel;
+  const std::chrono::steady_clock::time_point start;
+  uint64_t processedTick= 0;
+  std::size_t armed= 0;
+  /* Number of expired timers, which actions are still running */
+  std::size_t running= 0;
+  bool stopped= false;
+  std::thread worker;
+
+  TimeoutScheduler();
+  TimeoutScheduler(const TimeoutScheduler&)= delete;
+  TimeoutScheduler& operator=(const TimeoutScheduler&)= delete;
+
+  uint64_t currentTick();
+  void run();
+  void runAction(std::shared_ptr<TimeoutTask> task);
+
+public:
+  ~TimeoutScheduler();
+  static TimeoutScheduler& getInstance();
+
+  std::shared_ptr<TimeoutTask> schedule(std::function<void()> action, std::chrono::milliseconds delay);
+  bool cancel(const std::shared_ptr<TimeoutTask>& task);
+};
+
+}
+}
+#endif
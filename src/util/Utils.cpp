@@ -19,11 +19,21 @@
 
 
 #include <cctype>
+#include <cstring>
 #include <array>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define ESCAPE_WITH_SSE2
+# include <emmintrin.h>
+# ifdef _MSC_VER
+#  include <intrin.h>
+# endif
+#endif
+
 #include "Utils.h"
 
 #include "LogQueryTool.h"
+#include "ServerStatus.h"
 #include "logger/ProtocolLoggingProxy.h"
 #include "protocol/MasterProtocol.h"
 
@@ -80,17 +90,177 @@ namespace mariadb
     return replace(escaped, "\\", "\\\\");
   }
 
+  /* Second character of the escape sequence for every byte, that has to be escaped with backslash. 0 for the rest */
+  struct EscapeTable
+  {
+    char sequence[256];
+
+    EscapeTable()
+    {
+      std::memset(sequence, 0, sizeof(sequence));
+      sequence[0]= '0';
+      sequence[static_cast<unsigned char>('\n')]= 'n';
+      sequence[static_cast<unsigned char>('\r')]= 'r';
+      sequence[static_cast<unsigned char>('\\')]= '\\';
+      sequence[static_cast<unsigned char>('\'')]= '\'';
+      sequence[static_cast<unsigned char>('"')]= '"';
+      sequence[static_cast<unsigned char>('\032')]= 'Z';
+    }
+  };
+
+  const EscapeTable escapeTable;
+
+#ifdef ESCAPE_WITH_SSE2
+  static inline std::size_t lowestSetBit(uint32_t mask)
+  {
+# ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+# else
+    return static_cast<std::size_t>(__builtin_ctz(mask));
+# endif
+  }
+#endif
+
+  /**
+    * Returns position of the first byte starting from pos, that has to be escaped, or len if there is none.
+    *
+    * @param quotesOnly - if only single quotes are escaped, i.e. server is in NO_BACKSLASH_ESCAPES mode
+    */
+  static std::size_t findEscaped(const char* in, std::size_t pos, std::size_t len, bool quotesOnly)
+  {
+#ifdef ESCAPE_WITH_SSE2
+    const __m128i quote= _mm_set1_epi8('\'');
+
+    if (quotesOnly) {
+      for (; pos + 16 <= len; pos+= 16) {
+        __m128i chunk= _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+        uint32_t mask= static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)));
+        if (mask != 0) {
+          return pos + lowestSetBit(mask);
+        }
+      }
+    }
+    else {
+      const __m128i zero= _mm_setzero_si128(), lf= _mm_set1_epi8('\n'), cr= _mm_set1_epi8('\r'),
+        backslash= _mm_set1_epi8('\\'), dquote= _mm_set1_epi8('"'), ctrlZ= _mm_set1_epi8('\032');
+
+      for (; pos + 16 <= len; pos+= 16) {
+        __m128i chunk= _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + pos));
+        __m128i hits= _mm_or_si128(
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, zero), _mm_cmpeq_epi8(chunk, lf)),
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, cr), _mm_cmpeq_epi8(chunk, backslash))),
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, dquote)),
+            _mm_cmpeq_epi8(chunk, ctrlZ)));
+        uint32_t mask= static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        if (mask != 0) {
+          return pos + lowestSetBit(mask);
+        }
+      }
+    }
+#endif
+    if (quotesOnly) {
+      const void* found= std::memchr(in + pos, '\'', len - pos);
+      return found != nullptr ? static_cast<const char*>(found) - in : len;
+    }
+    while (pos < len && escapeTable.sequence[static_cast<unsigned char>(in[pos])] == 0) {
+      ++pos;
+    }
+    return pos;
+  }
+
+  /**
+    * Appends escaped data to the out string. Escaping is done the same way, as mysql_real_escape_string does it -
+    * depending on NO_BACKSLASH_ESCAPES status of the connection, and not on the noBackslashEscapes parameter.
+    * Runs of bytes, that do not need escaping, are copied as a whole.
+    */
   void Utils::escapeData(capi::MYSQL* conn, const char* in, size_t len, bool noBackslashEscapes, SQLString& out)
   {
     std::string &realOut= StringImp::get(out);
-    auto offset= realOut.length();
-    realOut.resize(offset + len*2);
+    const capi::MARIADB_CHARSET_INFO* cs= nullptr;
+
+    capi::mariadb_get_infov(conn, capi::MARIADB_CONNECTION_MARIADB_CHARSET_INFO, (void*)&cs);
+    // Bytes of multibyte characters in utf8 never take values of the escaped characters, and can be scanned byte by byte.
+    // Trailing bytes in some other multibyte charsets(e.g. sjis, big5, gbk) can, and those are left for the library
+    if (cs == nullptr || (cs->char_maxlen > 1 && std::strncmp(cs->csname, "utf8", 4) != 0)) {
+      auto offset= realOut.length();
+      realOut.resize(offset + len*2);
+
+      realOut.resize(offset + capi::mysql_real_escape_string(conn,
+        const_cast<char*>(realOut.data() + offset), in, static_cast<unsigned long>(len)));
+      return;
+    }
+
+    uint32_t serverStatus= 0;
+    capi::mariadb_get_infov(conn, capi::MARIADB_CONNECTION_SERVER_STATUS, (void*)&serverStatus);
+    bool quotesOnly= (serverStatus & ServerStatus::NO_BACKSLASH_ESCAPES) != 0;
+    std::size_t runStart= 0;
 
-    realOut.resize(offset + capi::mysql_real_escape_string(conn,
-      const_cast<char*>(realOut.data() + offset), in, static_cast<unsigned long>(len)));
+    realOut.reserve(realOut.length() + len + (len >> 4) + 2);
+    for (std::size_t pos= findEscaped(in, 0, len, quotesOnly); pos < len; pos= findEscaped(in, runStart, len, quotesOnly)) {
+      realOut.append(in + runStart, pos - runStart);
+      if (quotesOnly) {
+        realOut.append("''", 2);
+      }
+      else {
+        realOut.push_back('\\');
+        realOut.push_back(escapeTable.sequence[static_cast<unsigned char>(in[pos])]);
+      }
+      runStart= pos + 1;
+    }
+    realOut.append(in + runStart, len - runStart);
   }
 
 
+  /**
+    * Appends escaped content of the stream to the out string. If the size of the stream is known, the string is
+    * extended once beforehand, so the query is not copied while it grows.
+    *
+    * @param length maximum number of bytes to read, INT64_MAX to read the whole stream
+    */
+  void Utils::escapeStream(capi::MYSQL* conn, std::istream& in, int64_t length, bool noBackslashEscapes, SQLString& out)
+  {
+    const std::size_t chunkSize= 65536;
+    int64_t remaining= -1;
+    std::streampos start= in.tellg();
+
+    if (start != std::streampos(-1)) {
+      in.seekg(0, std::ios::end);
+      std::streampos end= in.tellg();
+      in.seekg(start);
+      if (in.fail()) {
+        in.clear();
+        in.seekg(start);
+      }
+      else if (end != std::streampos(-1)) {
+        remaining= static_cast<int64_t>(end - start);
+      }
+    }
+    if (remaining < 0 || remaining > length) {
+      remaining= length;
+    }
+    if (remaining != INT64_MAX) {
+      std::size_t expected= static_cast<std::size_t>(remaining);
+      // Not many bytes are expected to be escaped
+      out.reserve(out.length() + expected + expected / 8 + 2);
+    }
+
+    std::unique_ptr<char[]> buffer(new char[chunkSize]);
+    uint64_t readTotal= static_cast<uint64_t>(length);
+    std::streamsize readCount;
+
+    do {
+      std::size_t readMax= readTotal < chunkSize ? static_cast<std::size_t>(readTotal) : chunkSize;
+
+      readCount= in.read(buffer.get(), readMax).gcount();
+      if (readCount > 0) {
+        readTotal-= static_cast<uint64_t>(readCount);
+        escapeData(conn, buffer.get(), static_cast<std::size_t>(readCount), noBackslashEscapes, out);
+      }
+    } while (readTotal > 0 && readCount > 0);
+  }
+
   /**
     * Copies the original byte array content to a new byte array. The resulting byte array is always
     * "length" size. If length is smaller than the original byte array, the resulting byte array is
@@ -481,12 +651,11 @@ namespace mariadb
     * @return protocol
     * @throws SQLException if any error occur during connection
     */
-  Shared::Protocol Utils::retrieveProxy(UrlParser& urlParser, GlobalStateInfo* globalInfo)
+  Shared::Protocol Utils::retrieveProxy(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo* globalInfo)
   {
     Shared::mutex lock(new std::mutex());
-    std::shared_ptr<UrlParser> shUrlParser(&urlParser);
 
-    switch (urlParser.getHaMode())
+    switch (urlParser->getHaMode())
     {
       case AURORA:
 #ifdef AURORA_SUPPORT_IMPLEMENTED
@@ -520,10 +689,10 @@ namespace mariadb
               new FailoverProxy(new MastersFailoverListener(urlParser,globalInfo), lock)));
 #else
         /* This exception supposed to be already thrown*/
-        throw SQLFeatureNotImplementedException(SQLString("Support of the HA mode") + HaModeStrMap[urlParser.getHaMode()] + "is not yet implemented");
+        throw SQLFeatureNotImplementedException(SQLString("Support of the HA mode") + HaModeStrMap[urlParser->getHaMode()] + "is not yet implemented");
 #endif
       default:
-        Shared::Protocol protocol(getProxyLoggingIfNeeded(urlParser, new MasterProtocol(shUrlParser, globalInfo, lock)));
+        Shared::Protocol protocol(getProxyLoggingIfNeeded(*urlParser, new MasterProtocol(urlParser, globalInfo, lock)));
         protocol->connectWithoutProxy();
 
         return protocol;
@@ -48,6 +48,7 @@ public:
   static SQLString escapeString(const SQLString& value, bool noBackslashEscapes);
   // MYSQL handle is needed ans it encapsulates connection charset information we need to know for correct escaping
   static void escapeData(capi::MYSQL* conn, const char* in, size_t len, bool noBackslashEscapes, SQLString& out);
+  static void escapeStream(capi::MYSQL* conn, std::istream& in, int64_t length, bool noBackslashEscapes, SQLString& out);
 #ifdef THIS_FUNCTION_MAKES_SENSE
   static char* copyWithLength(char* orig,int32_t length);
   static char* copyRange(char* orig,int32_t from,int32_t to);
@@ -57,7 +58,7 @@ private:
   static SQLString resolveEscapes(SQLString& escaped, Protocol* protocol);
 public:
   static SQLString nativeSql(const SQLString& sql, Protocol* protocol);
-  static Shared::Protocol retrieveProxy(UrlParser& urlParser, GlobalStateInfo* globalInfo);
+  static Shared::Protocol retrieveProxy(std::shared_ptr<UrlParser>& urlParser, GlobalStateInfo* globalInfo);
 
 private:
   static Protocol* getProxyLoggingIfNeeded(const UrlParser& urlParser, Protocol* protocol);
@@ -39,10 +39,19 @@
 #include "Connection.hpp"
 
 #include "Exception.hpp"
+#include "BulkLoader.hpp"
+#include "Pipeline.hpp"
+#include "Metrics.hpp"
+#include "Tracing.hpp"
+#include "ParallelScan.hpp"
+#include "ResultCache.hpp"
 
 #include <memory>
 #include <list>
+#include <chrono>
 #include <thread>
+#include <thread>
+#include <atomic>
 #include <functional>
 
 namespace testsuite
@@ -2991,6 +3000,598 @@ void connection::reconnect()
   }
 }
 
+
+void connection::reprepareOnReconnect()
+{
+  logMsg("connection::reprepareOnReconnect - server side prepared statements after reconnection");
+
+  sql::ConnectOptionsMap connection_properties;
+
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["OPT_READ_TIMEOUT"]= "1000";
+  connection_properties["useServerPrepStmts"]= "true";
+  connection_properties["reprepareOnReconnect"]= "1";
+
+  created_objects.clear();
+  con.reset(driver->connect(connection_properties));
+  con->setSchema(db);
+
+  // First one is executed more often, and is re-prepared right after reconnection, second one - on its execution
+  PreparedStatement hot(con->prepareStatement("SELECT ? + 1")), cold(con->prepareStatement("SELECT ? + 2"));
+  for (int32_t i= 0; i < 3; ++i) {
+    hot->setInt(1, i);
+    res.reset(hot->executeQuery());
+  }
+  cold->setInt(1, 1);
+  res.reset(cold->executeQuery());
+
+  stmt.reset(con->createStatement());
+  try
+  {
+    res.reset(stmt->executeQuery("SELECT sleep(10)"));
+    FAIL("Connection didn't timed out");
+  }
+  catch (sql::SQLException &/*e*/)
+  {
+    ASSERT(con->reconnect());
+  }
+
+  hot->setInt(1, 1);
+  res.reset(hot->executeQuery());
+  ASSERT(res->next());
+  ASSERT_EQUALS(2, res->getInt(1));
+
+  cold->setInt(1, 1);
+  res.reset(cold->executeQuery());
+  ASSERT(res->next());
+  ASSERT_EQUALS(3, res->getInt(1));
+
+  // Buffered result of the statement stays readable, after the statement is re-prepared on the new connection
+  hot->setInt(1, 5);
+  ResultSet buffered(hot->executeQuery());
+  try
+  {
+    res.reset(stmt->executeQuery("SELECT sleep(10)"));
+    FAIL("Connection didn't timed out");
+  }
+  catch (sql::SQLException &/*e*/)
+  {
+    ASSERT(con->reconnect());
+  }
+  ASSERT(buffered->next());
+  ASSERT_EQUALS(6, buffered->getInt(1));
+  ASSERT(!buffered->next());
+
+  hot->setInt(1, 7);
+  res.reset(hot->executeQuery());
+  ASSERT(res->next());
+  ASSERT_EQUALS(8, res->getInt(1));
+}
+
+
+void connection::bulkLoader()
+{
+  logMsg("connection::bulkLoader - loading rows from the memory with LOAD DATA LOCAL INFILE");
+
+  sql::ConnectOptionsMap connection_properties;
+
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["allowLocalInfile"]= "true";
+  // Small buffer to make loader send rows in several loads
+  connection_properties["bulkLoadBufferSize"]= "1024";
+
+  created_objects.clear();
+  con.reset(driver->connect(connection_properties));
+  con->setSchema(db);
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test_bulk_loader");
+  stmt->execute("CREATE TABLE test_bulk_loader(id INT NOT NULL, val VARCHAR(32), d DOUBLE)");
+
+  std::unique_ptr<sql::BulkLoader> loader(sql::mariadb::create_bulk_loader(con.get(), "test_bulk_loader"));
+  for (int32_t i= 1; i <= 100; ++i) {
+    loader->setInt(1, i);
+    if (i % 10 == 0) {
+      loader->setNull(2);
+    }
+    else {
+      loader->setString(2, "a\tb\\c\n" + std::to_string(i));
+    }
+    loader->setDouble(3, i / 3.0);
+    loader->addRow();
+  }
+  loader->close();
+  ASSERT(loader->isClosed());
+  ASSERT_EQUALS(100LL, loader->getRowCount());
+  ASSERT(loader->getByteCount() > 1024);
+
+  res.reset(stmt->executeQuery("SELECT COUNT(*), COUNT(val) FROM test_bulk_loader"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(100, res->getInt(1));
+  ASSERT_EQUALS(90, res->getInt(2));
+
+  res.reset(stmt->executeQuery("SELECT val, d FROM test_bulk_loader WHERE id=7"));
+  ASSERT(res->next());
+  ASSERT_EQUALS("a\tb\\c\n7", res->getString(1));
+  ASSERT_EQUALS(7 / 3.0, res->getDouble(2));
+
+  // Explicit columns list, the rest get default values
+  loader.reset(sql::mariadb::create_bulk_loader(con.get(), "test_bulk_loader", { "id" }));
+  loader->setInt(1, 101);
+  loader->addRow();
+  ASSERT_EQUALS(1LL, loader->flush());
+
+  // Multibyte value is read back unchanged, though the file would be decoded as latin1 by default
+  const sql::SQLString multibyte("\xC3\xA4\xC3\xB6\xE2\x82\xAC\xF0\x9F\x98\x80");
+  stmt->execute("DROP TABLE IF EXISTS test_bulk_loader");
+  stmt->execute("CREATE TABLE test_bulk_loader(id INT NOT NULL, val VARCHAR(32) CHARACTER SET utf8mb4)");
+  stmt->execute("SET character_set_database=latin1");
+  loader.reset(sql::mariadb::create_bulk_loader(con.get(), "test_bulk_loader"));
+  loader->setInt(1, 1);
+  loader->setString(2, multibyte);
+  loader->addRow();
+  loader->close();
+
+  res.reset(stmt->executeQuery("SELECT val, CHAR_LENGTH(val) FROM test_bulk_loader"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(multibyte, res->getString(1));
+  ASSERT_EQUALS(5, res->getInt(2));
+  stmt->execute("DROP TABLE IF EXISTS test_bulk_loader");
+}
+
+
+void connection::serverStateCache()
+{
+  logMsg("connection::serverStateCache - connections reusing server variables read by previous connection");
+
+  sql::ConnectOptionsMap connection_properties;
+
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["serverStateCacheTtl"]= "60000";
+  connection_properties["sessionVariables"]= "auto_increment_increment=3";
+
+  created_objects.clear();
+  for (int32_t i= 0; i < 3; ++i) {
+    if (i == 2) {
+      // Different session variables must not get state cached for other ones
+      connection_properties["sessionVariables"]= "auto_increment_increment=5";
+    }
+    con.reset(driver->connect(connection_properties));
+    stmt.reset(con->createStatement());
+    res.reset(stmt->executeQuery("SELECT @@auto_increment_increment, @@autocommit"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(i == 2 ? 5 : 3, res->getInt(1));
+    ASSERT_EQUALS(1, res->getInt(2));
+  }
+
+  con->setSchema(db);
+  stmt.reset(con->createStatement());
+  stmt->execute("DROP TABLE IF EXISTS test_server_state_cache");
+  stmt->execute("CREATE TABLE test_server_state_cache(id INT NOT NULL AUTO_INCREMENT PRIMARY KEY, val INT)");
+  stmt->execute("INSERT INTO test_server_state_cache(val) VALUES(1),(2)");
+  res.reset(stmt->executeQuery("SELECT MAX(id) - MIN(id) FROM test_server_state_cache"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(5, res->getInt(1));
+  stmt->execute("DROP TABLE IF EXISTS test_server_state_cache");
+}
+
+
+void connection::pipeline()
+{
+  logMsg("connection::pipeline - executing independent statements without waiting for results of previous ones");
+
+  sql::ConnectOptionsMap connection_properties;
+
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs) {
+    connection_properties["useServerPrepStmts"]= serverPs ? "true" : "false";
+    created_objects.clear();
+    con.reset(driver->connect(connection_properties));
+    con->setSchema(db);
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test_pipeline");
+    stmt->execute("CREATE TABLE test_pipeline(id INT NOT NULL PRIMARY KEY, val VARCHAR(32))");
+
+    std::unique_ptr<sql::PreparedStatement> ps(con->prepareStatement("SELECT val FROM test_pipeline WHERE id=?"));
+    // Small window to have statements waiting for the window to open
+    std::unique_ptr<sql::Pipeline> pipeline(sql::mariadb::create_pipeline(con.get(), 3));
+
+    ASSERT_EQUALS(0ULL, static_cast<uint64_t>(pipeline->add("INSERT INTO test_pipeline VALUES(1,'a'),(2,'b')")));
+    pipeline->add("SELECT * FROM test_pipeline_does_not_exist");
+    ps->setInt(1, 2);
+    pipeline->add(ps.get());
+    for (int32_t i= 3; i < 50; ++i) {
+      pipeline->add("INSERT INTO test_pipeline VALUES(" + std::to_string(i) + ",'" + std::to_string(i) + "')");
+    }
+    pipeline->add("SELECT COUNT(*) FROM test_pipeline");
+    ASSERT_EQUALS(51ULL, static_cast<uint64_t>(pipeline->size()));
+    pipeline->execute();
+
+    ASSERT_EQUALS(2LL, pipeline->getUpdateCount(0));
+    try {
+      pipeline->getResultSet(1);
+      FAIL("Error of the pipelined query has not been thrown");
+    }
+    catch (sql::SQLException& e) {
+      ASSERT_EQUALS(1146, e.getErrorCode());
+    }
+    res.reset(pipeline->getResultSet(2));
+    ASSERT(res->next());
+    ASSERT_EQUALS("b", res->getString(1));
+    ASSERT(!res->next());
+    ASSERT_EQUALS(1LL, pipeline->getUpdateCount(49));
+    res.reset(pipeline->getResultSet(50));
+    ASSERT(res->next());
+    ASSERT_EQUALS(49, res->getInt(1));
+
+    // Connection stays usable after the pipeline
+    res.reset(stmt->executeQuery("SELECT val FROM test_pipeline WHERE id=49"));
+    ASSERT(res->next());
+    ASSERT_EQUALS("49", res->getString(1));
+
+    pipeline->close();
+    ASSERT(pipeline->isClosed());
+    stmt->execute("DROP TABLE IF EXISTS test_pipeline");
+  }
+}
+
+
+void connection::metrics()
+{
+  logMsg("connection::metrics - driver-wide counters and their dump");
+
+  sql::mariadb::reset_metrics();
+  ASSERT_EQUALS(static_cast<int64_t>(0), sql::mariadb::get_metric("round_trips"));
+
+  stmt.reset(con->createStatement());
+  res.reset(stmt->executeQuery("SELECT 1"));
+  ASSERT(res->next());
+  ASSERT(sql::mariadb::get_metric("round_trips") > 0);
+  ASSERT(sql::mariadb::get_metric("payload_bytes_sent") >= 8);
+  ASSERT(sql::mariadb::get_metric("payload_bytes_received") >= 1);
+  ASSERT_EQUALS(static_cast<int64_t>(1), sql::mariadb::get_metric("result_sets_buffered"));
+  ASSERT(sql::mariadb::get_metric("lock_waits") > 0);
+
+  // Re-reading rows of the scrollable result set does not count them again
+  stmt.reset(con->createStatement(sql::ResultSet::TYPE_SCROLL_INSENSITIVE, sql::ResultSet::CONCUR_READ_ONLY));
+  res.reset(stmt->executeQuery("SELECT 'abc' UNION ALL SELECT 'def'"));
+  ASSERT(res->next());
+  ASSERT_EQUALS("abc", res->getString(1));
+  ASSERT(res->next());
+  ASSERT_EQUALS("def", res->getString(1));
+  int64_t received= sql::mariadb::get_metric("payload_bytes_received");
+  ASSERT(res->first());
+  ASSERT_EQUALS("abc", res->getString(1));
+  ASSERT(res->next());
+  ASSERT_EQUALS("def", res->getString(1));
+  ASSERT_EQUALS(received, sql::mariadb::get_metric("payload_bytes_received"));
+
+  sql::ConnectOptionsMap connection_properties;
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["useServerPrepStmts"]= "true";
+  created_objects.clear();
+  con.reset(driver->connect(connection_properties));
+
+  int64_t prepares= sql::mariadb::get_metric("server_prepares");
+  pstmt.reset(con->prepareStatement("SELECT ?"));
+  ASSERT_EQUALS(prepares + 1, sql::mariadb::get_metric("server_prepares"));
+
+  std::string text(sql::mariadb::dump_metrics().c_str());
+  ASSERT(text.find("# TYPE mariadb_round_trips_total counter") != std::string::npos);
+  ASSERT(text.find("mariadb_client_batches_total{strategy=\"bulk\"}") != std::string::npos);
+  ASSERT(text.find("mariadb_lock_wait_seconds_bucket{le=\"+Inf\"}") != std::string::npos);
+
+  sql::SQLString json(sql::mariadb::dump_metrics(true));
+  ASSERT(json.startsWith("{\"round_trips\":"));
+  ASSERT(json.endsWith("}"));
+
+  try {
+    sql::mariadb::get_metric("no_such_metric");
+    FAIL("Unknown metric name has not caused exception");
+  }
+  catch (sql::IllegalArgumentException&) {
+  }
+}
+
+void connection::tracing()
+{
+  logMsg("connection::tracing - spans of connection operations in Chrome trace format");
+
+  sql::mariadb::enable_tracing(true);
+  sql::mariadb::clear_trace();
+
+  sql::ConnectOptionsMap connection_properties;
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["useServerPrepStmts"]= "true";
+  created_objects.clear();
+  con.reset(driver->connect(connection_properties));
+
+  pstmt.reset(con->prepareStatement("SELECT ?"));
+  pstmt->setInt(1, 1);
+  res.reset(pstmt->executeQuery());
+  ASSERT(res->next());
+  con->close();
+
+  std::string trace(sql::mariadb::dump_trace().c_str());
+  ASSERT_EQUALS(0, static_cast<int32_t>(trace.find("{\"traceEvents\":[{")));
+  ASSERT(trace.find("\"name\":\"connect\"") != std::string::npos);
+  ASSERT(trace.find("\"name\":\"prepare\"") != std::string::npos);
+  ASSERT(trace.find("\"name\":\"execute\"") != std::string::npos);
+  ASSERT(trace.find("\"name\":\"fetch\"") != std::string::npos);
+  ASSERT(trace.find("\"name\":\"close\"") != std::string::npos);
+
+  sql::mariadb::clear_trace();
+  sql::mariadb::enable_tracing(false);
+  con.reset(driver->connect(connection_properties));
+  stmt.reset(con->createStatement());
+  stmt->execute("SELECT 1");
+  trace= sql::mariadb::dump_trace().c_str();
+  ASSERT_EQUALS("{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}", trace);
+}
+
+
+namespace
+{
+  struct PartitionTotals
+  {
+    std::atomic<int64_t> rows;
+    std::atomic<int64_t> idSum;
+    std::atomic<int32_t> streamed;
+  };
+
+
+  void countPartition(std::size_t /*partition*/, sql::ResultSet* rs, void* context)
+  {
+    PartitionTotals* totals= static_cast<PartitionTotals*>(context);
+    if (rs->getFetchSize() > 0) {
+      ++totals->streamed;
+    }
+    while (rs->next()) {
+      ++totals->rows;
+      totals->idSum+= rs->getInt(1);
+    }
+  }
+}
+
+
+void connection::parallelScan()
+{
+  logMsg("connection::parallelScan - reading table by ranges of the key on several connections");
+
+  const int32_t rowCount= 1000;
+  createSchemaObject("TABLE", "test_parallel_scan", "(id INT NOT NULL PRIMARY KEY, val VARCHAR(16))");
+  std::string insert("INSERT INTO test_parallel_scan VALUES");
+  for (int32_t i= 1; i <= rowCount; ++i) {
+    insert.append(i > 1 ? ",(" : "(").append(std::to_string(i)).append(",'").append(std::to_string(i)).append("')");
+  }
+  stmt->executeUpdate(insert);
+
+  std::unique_ptr<sql::ParallelScan> scan(sql::mariadb::create_parallel_scan(con.get(), "test_parallel_scan", 3));
+  scan->setPartitionCount(7);
+  scan->setFetchSize(10);
+  ASSERT_EQUALS("id", scan->getKey());
+  ASSERT_EQUALS(1LL, scan->getMinKey());
+  ASSERT_EQUALS(static_cast<int64_t>(rowCount), scan->getMaxKey());
+  ASSERT_EQUALS(7ULL, static_cast<uint64_t>(scan->getPartitionCount()));
+
+  PartitionTotals totals;
+  totals.rows= 0;
+  totals.idSum= 0;
+  totals.streamed= 0;
+  scan->forEachPartition(countPartition, &totals);
+  ASSERT_EQUALS(static_cast<int64_t>(rowCount), totals.rows.load());
+  ASSERT_EQUALS(static_cast<int64_t>(rowCount)*(rowCount + 1)/2, totals.idSum.load());
+  // All partitions are streamed, whatever useServerPrepStmts of the connection is
+  ASSERT_EQUALS(7, totals.streamed.load());
+
+  // Merged stream returns rows in the key order
+  int32_t id= 0;
+  while (scan->next()) {
+    ASSERT_EQUALS(10, scan->getResultSet()->getFetchSize());
+    ASSERT_EQUALS(++id, scan->getResultSet()->getInt(1));
+    ASSERT_EQUALS(std::to_string(id), scan->getResultSet()->getString(2));
+  }
+  ASSERT_EQUALS(rowCount, id);
+  scan->close();
+  ASSERT(scan->isClosed());
+
+  scan.reset(sql::mariadb::create_parallel_query_scan(con.get(), "SELECT id FROM test_parallel_scan WHERE id % 2 = 0", "id", 2));
+  id= 0;
+  while (scan->next()) {
+    id+= 2;
+    ASSERT_EQUALS(id, scan->getResultSet()->getInt(1));
+  }
+  ASSERT_EQUALS(rowCount, id);
+
+  scan.reset(sql::mariadb::create_parallel_scan(con.get(), "test_parallel_scan", 2, "val"));
+  try {
+    scan->getPartitionCount();
+    FAIL("Non-integer scan key has not caused exception");
+  }
+  catch (sql::SQLFeatureNotSupportedException&) {
+  }
+}
+
+
+void connection::queryResultCache()
+{
+  logMsg("connection::queryResultCache - repeated queries served from the driver-global result cache");
+
+  createSchemaObject("TABLE", "test_result_cache", "(id INT NOT NULL PRIMARY KEY, code VARCHAR(8), note VARCHAR(8))");
+  stmt->executeUpdate("INSERT INTO test_result_cache VALUES(1,'usd',NULL),(2,'eur','')");
+  sql::mariadb::clear_result_cache();
+
+  sql::ConnectOptionsMap connection_properties;
+
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["schema"]=db;
+  connection_properties["queryResultCacheTtl"]= "60000";
+
+  Connection con2(driver->connect(connection_properties));
+  Statement stmt2(con2->createStatement());
+  int64_t hits= sql::mariadb::get_metric("result_cache_hits");
+
+  for (int32_t i= 0; i < 2; ++i) {
+    res.reset(stmt2->executeQuery("SELECT id, code, note FROM test_result_cache ORDER BY id"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(1, res->getInt(1));
+    ASSERT_EQUALS("usd", res->getString(2));
+    ASSERT(res->getString(3).empty());
+    ASSERT(res->wasNull());
+    ASSERT(res->next());
+    ASSERT_EQUALS("eur", res->getString("code"));
+    ASSERT(res->getString(3).empty());
+    ASSERT(!res->wasNull());
+    ASSERT(!res->next());
+  }
+  ASSERT_EQUALS(hits + 1, sql::mariadb::get_metric("result_cache_hits"));
+
+  // Parameter values are part of the key
+  PreparedStatement pstmt2(con2->prepareStatement("SELECT code FROM test_result_cache WHERE id=?"));
+  for (int32_t id : {1, 2, 1}) {
+    pstmt2->setInt(1, id);
+    res.reset(pstmt2->executeQuery());
+    ASSERT(res->next());
+    ASSERT_EQUALS(id == 1 ? "usd" : "eur", res->getString(1));
+  }
+  ASSERT_EQUALS(hits + 2, sql::mariadb::get_metric("result_cache_hits"));
+
+  // Write through the driver drops results of the table
+  stmt->executeUpdate("UPDATE test_result_cache SET code='gbp' WHERE id=1");
+  res.reset(stmt2->executeQuery("SELECT id, code, note FROM test_result_cache ORDER BY id"));
+  ASSERT(res->next());
+  ASSERT_EQUALS("gbp", res->getString(2));
+  ASSERT_EQUALS(hits + 2, sql::mariadb::get_metric("result_cache_hits"));
+
+  res.reset(stmt2->executeQuery("SELECT id, code, note FROM test_result_cache ORDER BY id"));
+  ASSERT_EQUALS(hits + 3, sql::mariadb::get_metric("result_cache_hits"));
+  sql::mariadb::invalidate_result_cache("test_result_cache");
+  res.reset(stmt2->executeQuery("SELECT id, code, note FROM test_result_cache ORDER BY id"));
+  ASSERT_EQUALS(hits + 3, sql::mariadb::get_metric("result_cache_hits"));
+
+  // Statement may change tables it does not name, e.g. by trigger, and the view does not name its base table
+  createSchemaObject("VIEW", "test_result_cache_view", "AS SELECT code FROM test_result_cache WHERE id=2");
+  createSchemaObject("TABLE", "test_result_cache_log", "(id INT)");
+  createSchemaObject("TRIGGER", "test_result_cache_trigger", "AFTER INSERT ON test_result_cache_log FOR EACH ROW "
+    "UPDATE test_result_cache SET code='chf' WHERE id=NEW.id");
+  for (int32_t i= 0; i < 2; ++i) {
+    res.reset(stmt2->executeQuery("SELECT code FROM test_result_cache_view"));
+    ASSERT(res->next());
+    ASSERT_EQUALS("eur", res->getString(1));
+  }
+  ASSERT_EQUALS(hits + 4, sql::mariadb::get_metric("result_cache_hits"));
+
+  pstmt.reset(con->prepareStatement("INSERT INTO test_result_cache_log VALUES(?)"));
+  pstmt->setInt(1, 2);
+  pstmt->executeUpdate();
+  res.reset(stmt2->executeQuery("SELECT code FROM test_result_cache_view"));
+  ASSERT(res->next());
+  ASSERT_EQUALS("chf", res->getString(1));
+  ASSERT_EQUALS(hits + 4, sql::mariadb::get_metric("result_cache_hits"));
+
+  // Not cached inside transaction
+  con2->setAutoCommit(false);
+  res.reset(stmt2->executeQuery("SELECT 1"));
+  res.reset(stmt2->executeQuery("SELECT id, code, note FROM test_result_cache ORDER BY id"));
+  ASSERT_EQUALS(hits + 3, sql::mariadb::get_metric("result_cache_hits"));
+  con2->commit();
+
+  res.reset();
+  sql::mariadb::clear_result_cache();
+}
+
+
+void connection::sharedProfile()
+{
+  logMsg("connection::sharedProfile - connections with the same properties do not affect each other");
+
+  sql::ConnectOptionsMap connection_properties;
+
+  connection_properties["hostName"]=url;
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["schema"]=db;
+  connection_properties["useTls"]= useTls ? "true" : "false";
+
+  Connection con1(driver->connect(connection_properties));
+  Connection con2(driver->connect(connection_properties));
+
+  con1->setSchema("mysql");
+  ASSERT_EQUALS(db, con2->getSchema());
+
+  // Connection made after the change of the other one
+  Connection con3(driver->connect(connection_properties));
+  ASSERT_EQUALS(db, con3->getSchema());
+  con3->setSchema("information_schema");
+  ASSERT_EQUALS("mysql", con1->getSchema());
+
+  con1->close();
+  Statement st(con2->createStatement());
+  res.reset(st->executeQuery("SELECT DATABASE()"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(db, res->getString(1));
+}
+
+
+void connection::galeraHealthMonitor()
+{
+  logMsg("connection::galeraHealthMonitor - new connections skip hosts the background monitor found unreachable");
+
+  if (commonProperties.find("localSocket") != commonProperties.end()
+    || commonProperties.find("pipe") != commonProperties.end()) {
+    SKIP("The test needs TCP connection to the server");
+  }
+  const sql::SQLString prefix("jdbc:mariadb://");
+  std::size_t hostsEnd= url.find_first_of('/', prefix.length());
+  sql::SQLString reachable(url.substr(prefix.length(),
+    hostsEnd == std::string::npos ? std::string::npos : hostsEnd - prefix.length()));
+
+  sql::ConnectOptionsMap connection_properties;
+
+  // Hosts are tried from the end of the list, and the blackholed TEST-NET address would be the first one
+  connection_properties["hostName"]= prefix + reachable + ",192.0.2.1:3306";
+  connection_properties["userName"]=user;
+  connection_properties["password"]=passwd;
+  connection_properties["schema"]=db;
+  connection_properties["useTls"]= useTls ? "true" : "false";
+  connection_properties["connectTimeout"]= "5000";
+  connection_properties["galeraHealthCheckInterval"]= "200";
+  connection_properties["galeraAllowedState"]= "4";
+
+  Connection con1(driver->connect(connection_properties));
+  // Each host is checked with timeout not longer than a second
+  std::this_thread::sleep_for(std::chrono::milliseconds(2000));
+
+  for (int32_t i= 0; i < 3; ++i) {
+    auto start= std::chrono::steady_clock::now();
+    Connection con2(driver->connect(connection_properties));
+    auto elapsed= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    ASSERT(elapsed.count() < 2000);
+    ASSERT(con2->isValid(1));
+    Statement st(con2->createStatement());
+    res.reset(st->executeQuery("SELECT DATABASE()"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(db, res->getString(1));
+  }
+  ASSERT(con1->isValid(1));
+}
+
+
 void connection::ssl_mode()
 {
   logMsg("connection::ssl_mode - useTls");
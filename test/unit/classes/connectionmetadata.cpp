@@ -2571,5 +2571,46 @@ void connectionmetadata::bugCpp25()
 
 }
 
+
+void connectionmetadata::metadataCache()
+{
+  logMsg("connectionmetadata::metadataCache");
+  sql::Properties p{{"metadataCacheTtl", "60000"}};
+  Connection con2(unit_fixture::getConnection(&p));
+  Statement stmt2(con2->createStatement());
+
+  stmt2->executeUpdate("DROP TABLE IF EXISTS test_metadata_cache");
+  stmt2->executeUpdate("CREATE TABLE test_metadata_cache(id INT NOT NULL PRIMARY KEY, val VARCHAR(20) DEFAULT '')");
+
+  DatabaseMetaData dbmeta(con2->getMetaData());
+  res.reset(dbmeta->getColumns(con2->getSchema(), "", "test_metadata_cache", "%"));
+  ASSERT(res->next());
+  ASSERT_EQUALS("id", res->getString("COLUMN_NAME"));
+  ASSERT(res->next());
+  ASSERT_EQUALS("val", res->getString("COLUMN_NAME"));
+  ASSERT(!res->next());
+
+  // The table is changed by other connection - the cached result should be returned
+  stmt->executeUpdate("ALTER TABLE test_metadata_cache ADD COLUMN val2 INT");
+  res.reset(dbmeta->getColumns(con2->getSchema(), "", "test_metadata_cache", "%"));
+  ASSERT(res->next());
+  ASSERT(res->next());
+  ASSERT_EQUALS("val", res->getString("COLUMN_NAME"));
+  ASSERT(!res->next());
+
+  sql::mariadb::invalidate_metadata_cache();
+  res.reset(dbmeta->getColumns(con2->getSchema(), "", "test_metadata_cache", "%"));
+  ASSERT(res->last());
+  ASSERT_EQUALS("val2", res->getString("COLUMN_NAME"));
+
+  // DDL via the connection with the cache enabled invalidates it
+  stmt2->executeUpdate("ALTER TABLE test_metadata_cache DROP COLUMN val2");
+  res.reset(dbmeta->getColumns(con2->getSchema(), "", "test_metadata_cache", "%"));
+  ASSERT(res->last());
+  ASSERT_EQUALS("val", res->getString("COLUMN_NAME"));
+
+  stmt2->executeUpdate("DROP TABLE test_metadata_cache");
+}
+
 } /* namespace connectionmetadata */
 } /* namespace testsuite */
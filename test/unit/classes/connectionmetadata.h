@@ -106,6 +106,7 @@ public:
   TEST_CASE(getTableCharset);
   TEST_CASE(getTables);
   TEST_CASE(bugCpp25);
+  TEST_CASE(metadataCache);
   }
 
   /**
@@ -391,6 +392,11 @@ public:
    * Test of server version
    */
   void bugCpp25();
+
+  /**
+   * Test of the metadata cache(metadataCacheTtl option) and its invalidation by DDL
+   */
+  void metadataCache();
 };
 
 REGISTER_FIXTURE(connectionmetadata);
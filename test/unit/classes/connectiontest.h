@@ -85,6 +85,16 @@ public:
     TEST_CASE(localInfile);
     TEST_CASE(isValid);
     TEST_CASE(reconnect);
+    TEST_CASE(reprepareOnReconnect);
+    TEST_CASE(bulkLoader);
+    TEST_CASE(serverStateCache);
+    TEST_CASE(pipeline);
+    TEST_CASE(metrics);
+    TEST_CASE(tracing);
+    TEST_CASE(parallelScan);
+    TEST_CASE(queryResultCache);
+    TEST_CASE(sharedProfile);
+    TEST_CASE(galeraHealthMonitor);
     TEST_CASE(ssl_mode);
     TEST_CASE(tls_version);
     TEST_CASE(cached_sha2_auth);
@@ -251,6 +261,66 @@ public:
    */
   void reconnect();
 
+  /*
+   * Test of server side prepared statements after reconnection(reprepareOnReconnect option)
+   *
+   */
+  void reprepareOnReconnect();
+
+  /*
+   * Test of BulkLoader
+   *
+   */
+  void bulkLoader();
+
+  /*
+   * Test of connections using cached server state
+   *
+   */
+  void serverStateCache();
+
+  /*
+   * Test of Pipeline
+   *
+   */
+  void pipeline();
+
+  /*
+   * Test of driver-wide metrics
+   *
+   */
+  void metrics();
+
+  /*
+   * Test of tracing of connection operations
+   *
+   */
+  void tracing();
+
+  /*
+   * Test of ParallelScan
+   *
+   */
+  void parallelScan();
+
+  /*
+   * Test of the query result cache
+   *
+   */
+  void queryResultCache();
+
+  /*
+   * Test of connections sharing parsed connection profile
+   *
+   */
+  void sharedProfile();
+
+  /*
+   * Test of the background health monitor of multiple hosts
+   *
+   */
+  void galeraHealthMonitor();
+
   /*
    * Test of MySQL_Connection::ssl_mode()
    *
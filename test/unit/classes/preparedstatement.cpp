@@ -2291,5 +2291,397 @@ void preparedstatement::concpp153_mbCsParamEscaping()
   }
 }
 
+
+void preparedstatement::bufferedLongValues()
+{
+  pstmt.reset(sspsCon->prepareStatement("SELECT REPEAT('a', 70000), 'short', NULL, REPEAT('b', ?) UNION SELECT 'x', REPEAT('c', 3000), 'y', 'z'"));
+  pstmt->setInt(1, 5000);
+
+  res.reset(pstmt->executeQuery());
+  ASSERT(res->next());
+  ASSERT_EQUALS(70000ULL, static_cast<uint64_t>(res->getString(1).length()));
+  ASSERT_EQUALS("short", res->getString(2));
+  ASSERT(res->getString(3).empty());
+  ASSERT(res->wasNull());
+  ASSERT_EQUALS(std::string(5000, 'b'), std::string(res->getString(4).c_str()));
+  // Reading the same value twice
+  ASSERT_EQUALS(70000ULL, static_cast<uint64_t>(res->getString(1).length()));
+  ASSERT(res->next());
+  ASSERT_EQUALS("x", res->getString(1));
+  ASSERT_EQUALS(std::string(3000, 'c'), std::string(res->getString(2).c_str()));
+  ASSERT(!res->next());
+
+  // Bound buffer grows to fit the long value, and next values are read with it
+  pstmt.reset(sspsCon->prepareStatement("SELECT REPEAT('d', 4000) UNION ALL SELECT REPEAT('e', 3000) UNION ALL "
+    "SELECT REPEAT('f', 9000) UNION ALL SELECT 'g'"));
+  res.reset(pstmt->executeQuery());
+  ASSERT(res->next());
+  ASSERT_EQUALS(std::string(4000, 'd'), std::string(res->getString(1).c_str()));
+  ASSERT(res->next());
+  ASSERT_EQUALS(std::string(3000, 'e'), std::string(res->getString(1).c_str()));
+  ASSERT(res->next());
+  ASSERT_EQUALS(std::string(9000, 'f'), std::string(res->getString(1).c_str()));
+  ASSERT_EQUALS(std::string(9000, 'f'), std::string(res->getString(1).c_str()));
+  ASSERT(res->next());
+  ASSERT_EQUALS("g", res->getString(1));
+  ASSERT(!res->next());
+}
+
+
+void preparedstatement::cursorFetchSize()
+{
+  createSchemaObject("TABLE", "cursor_fetch", "(id INT NOT NULL PRIMARY KEY, val VARCHAR(32))");
+  stmt->executeUpdate("INSERT INTO cursor_fetch VALUES (1,'a'),(2,'b'),(3,'c'),(4,'d'),(5,'e'),(6,'f'),(7,'g')");
+
+  pstmt.reset(sspsCon->prepareStatement("SELECT id, val FROM cursor_fetch WHERE id > ? ORDER BY id"));
+  pstmt->setFetchSize(2);
+  ASSERT_EQUALS(2, pstmt->getFetchSize());
+  pstmt->setInt(1, 0);
+  res.reset(pstmt->executeQuery());
+
+  ASSERT(res->next());
+  ASSERT_EQUALS(1, res->getInt(1));
+  ASSERT_EQUALS("a", res->getString(2));
+  ASSERT(res->next());
+  ASSERT(res->next());
+  ASSERT_EQUALS(3, res->getInt(1));
+
+  // The connection is not blocked by the open cursor
+  Statement st2(sspsCon->createStatement());
+  ResultSet rs2(st2->executeQuery("SELECT COUNT(*) FROM cursor_fetch"));
+  ASSERT(rs2->next());
+  ASSERT_EQUALS(7, rs2->getInt(1));
+
+  // Re-execution while the first result still has rows to fetch
+  pstmt->setInt(1, 5);
+  ResultSet res2(pstmt->executeQuery());
+
+  ASSERT(res2->next());
+  ASSERT_EQUALS(6, res2->getInt(1));
+  for (int32_t i= 4; i < 8; ++i) {
+    ASSERT(res->next());
+    ASSERT_EQUALS(i, res->getInt(1));
+  }
+  ASSERT(!res->next());
+  ASSERT(res2->next());
+  ASSERT_EQUALS("g", res2->getString(2));
+  ASSERT(!res2->next());
+
+  // Closing result with pending rows
+  pstmt->setInt(1, 0);
+  res.reset(pstmt->executeQuery());
+  ASSERT(res->next());
+  res->close();
+  pstmt->close();
+
+  rs2.reset(st2->executeQuery("SELECT 1"));
+  ASSERT(rs2->next());
+}
+
+
+void preparedstatement::clientPrepareCache()
+{
+  Connection cspsCon;
+  sql::Properties props(commonProperties);
+  props["useServerPrepStmts"]= "false";
+  props["rewriteBatchedStatements"]= "true";
+  cspsCon.reset(getConnection(&props));
+
+  createSchemaObject("TABLE", "client_prepare_cache", "(a INT, b VARCHAR(16), c INT, d VARCHAR(16))");
+  // Query and its parse result outlive the first statement
+  for (int32_t i= 0; i < 2; ++i) {
+    pstmt.reset(cspsCon->prepareStatement("INSERT INTO client_prepare_cache VALUES (?, /* ? */ ?, ?, ?) -- '?'\n"));
+    ASSERT_EQUALS(4, pstmt->getParameterMetaData()->getParameterCount());
+    for (int32_t j= 0; j < 3; ++j) {
+      pstmt->setInt(1, i*10 + j);
+      pstmt->setString(2, "b?'");
+      pstmt->setInt(3, j);
+      pstmt->setString(4, "`?`");
+      pstmt->addBatch();
+    }
+    pstmt->executeBatch();
+  }
+
+  for (int32_t i= 0; i < 2; ++i) {
+    pstmt.reset(cspsCon->prepareStatement("SELECT COUNT(*), MAX(d) FROM client_prepare_cache WHERE b='b?''' AND a > ? # ?"));
+    ASSERT_EQUALS(1, pstmt->getParameterMetaData()->getParameterCount());
+    pstmt->setInt(1, 0);
+    res.reset(pstmt->executeQuery());
+    ASSERT(res->next());
+    ASSERT_EQUALS(5, res->getInt(1));
+    ASSERT_EQUALS("`?`", res->getString(2));
+  }
+}
+
+
+void preparedstatement::escapeLongString()
+{
+  Connection cspsCon;
+  sql::Properties props(commonProperties);
+  props["useServerPrepStmts"]= "false";
+  cspsCon.reset(getConnection(&props));
+
+  std::string value;
+  const std::string special("\0\n\r\\'\"\032", 7);
+  for (int32_t i= 0; i < 10000; ++i) {
+    value.append("{\"key\": \"\xc3\xa4\xe2\x82\xac value\"}").append(1, special[i % special.length()]);
+  }
+
+  std::unique_ptr<sql::Statement> st(cspsCon->createStatement());
+  pstmt.reset(cspsCon->prepareStatement("SELECT ?, ?"));
+  for (int32_t noBackslashEscapes= 0; noBackslashEscapes < 2; ++noBackslashEscapes) {
+    if (noBackslashEscapes) {
+      st->execute("SET SESSION sql_mode=CONCAT(@@sql_mode, ',NO_BACKSLASH_ESCAPES')");
+    }
+    pstmt->setString(1, value);
+    sql::bytes binaryValue(value.c_str(), value.length());
+    pstmt->setBytes(2, &binaryValue);
+    res.reset(pstmt->executeQuery());
+    ASSERT(res->next());
+    ASSERT_EQUALS(value, std::string(res->getString(1).c_str(), res->getString(1).length()));
+    ASSERT_EQUALS(value, std::string(res->getString(2).c_str(), res->getString(2).length()));
+  }
+}
+
+void preparedstatement::streamLongData()
+{
+  std::string value;
+  const std::string special("\0\n\r\\'\"\032", 7);
+  for (int32_t i= 0; i < 200000; ++i) {
+    value.append("stream data ").append(1, special[i % special.length()]);
+  }
+
+  createSchemaObject("TABLE", "test_stream_long_data", "(id INT NOT NULL PRIMARY KEY, val LONGBLOB)");
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs) {
+    Connection con2;
+    sql::Properties props(commonProperties);
+    props["useServerPrepStmts"]= serverPs ? "true" : "false";
+    props["longDataChunkSize"]= "65536";
+    con2.reset(getConnection(&props));
+
+    std::unique_ptr<sql::Statement> st(con2->createStatement());
+    st->execute("DELETE FROM test_stream_long_data");
+    pstmt.reset(con2->prepareStatement("INSERT INTO test_stream_long_data(id, val) VALUES (?, ?)"));
+    // Several executions to make sure the long data buffer is reused correctly
+    for (int32_t id= 1; id < 4; ++id) {
+      std::stringstream blob(value);
+      pstmt->setInt(1, id);
+      pstmt->setBlob(2, &blob);
+      ASSERT_EQUALS(1, pstmt->executeUpdate());
+    }
+    res.reset(st->executeQuery("SELECT val FROM test_stream_long_data ORDER BY id"));
+    for (int32_t id= 1; id < 4; ++id) {
+      ASSERT(res->next());
+      ASSERT_EQUALS(value, std::string(res->getString(1).c_str(), res->getString(1).length()));
+    }
+    ASSERT(!res->next());
+  }
+}
+
+void preparedstatement::metadataReuse()
+{
+  createSchemaObject("TABLE", "test_metadata_reuse", "(id INT NOT NULL PRIMARY KEY, val VARCHAR(32))");
+
+  Connection con2;
+  sql::Properties props(commonProperties);
+  props["useServerPrepStmts"]= "true";
+  con2.reset(getConnection(&props));
+
+  std::unique_ptr<sql::Statement> st(con2->createStatement());
+  st->execute("INSERT INTO test_metadata_reuse VALUES(1, 'one')");
+  pstmt.reset(con2->prepareStatement("SELECT * FROM test_metadata_reuse WHERE id > ?"));
+  pstmt->setInt(1, 0);
+
+  res.reset(pstmt->executeQuery());
+  ResultSetMetaData firstMd(res->getMetaData());
+  ResultSet res2;
+  // Metadata and the result sets of previous executions have to stay valid
+  for (int32_t i= 0; i < 10; ++i) {
+    res2.reset(pstmt->executeQuery());
+    ASSERT(res2->next());
+    ASSERT_EQUALS(1, res2->getInt("id"));
+    ASSERT_EQUALS("one", res2->getString("val"));
+  }
+  ASSERT_EQUALS(2, firstMd->getColumnCount());
+  ASSERT_EQUALS("id", firstMd->getColumnName(1));
+  ASSERT_EQUALS("val", firstMd->getColumnName(2));
+  ASSERT_EQUALS("test_metadata_reuse", firstMd->getTableName(2));
+  ASSERT(res->next());
+  ASSERT_EQUALS("one", res->getString("val"));
+
+  // Changed table definition has to be reflected in the metadata of the next execution
+  st->execute("ALTER TABLE test_metadata_reuse CHANGE COLUMN val txt VARCHAR(32)");
+  res2.reset(pstmt->executeQuery());
+  ASSERT(res2->next());
+  ResultSetMetaData md(res2->getMetaData());
+  ASSERT_EQUALS("txt", md->getColumnName(2));
+  ASSERT_EQUALS("one", res2->getString("txt"));
+  ASSERT_EQUALS("val", firstMd->getColumnName(2));
+}
+
+void preparedstatement::doubleRoundTrip()
+{
+  const double values[]= { 0.1, -23.5, 1.0 / 3, 6.02214076e23, 2.2250738585072014e-308, 1.7976931348623157e308, 0.0, 123456789.987654321 };
+  const float floatValues[]= { 0.1f, -23.5f, 1.0f / 3, 3.4028235e38f, 0.0f, 1234.567f };
+
+  createSchemaObject("TABLE", "test_double_round_trip", "(id INT NOT NULL PRIMARY KEY, d DOUBLE, f FLOAT)");
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs) {
+    Connection con2;
+    sql::Properties props(commonProperties);
+    props["useServerPrepStmts"]= serverPs ? "true" : "false";
+    con2.reset(getConnection(&props));
+
+    std::unique_ptr<sql::Statement> st(con2->createStatement());
+    st->execute("DELETE FROM test_double_round_trip");
+    pstmt.reset(con2->prepareStatement("INSERT INTO test_double_round_trip(id, d, f) VALUES (?, ?, ?)"));
+    for (int32_t i= 0; i < static_cast<int32_t>(sizeof(values)/sizeof(values[0])); ++i) {
+      pstmt->setInt(1, i);
+      pstmt->setDouble(2, values[i]);
+      pstmt->setFloat(3, floatValues[i % (sizeof(floatValues)/sizeof(floatValues[0]))]);
+      ASSERT_EQUALS(1, pstmt->executeUpdate());
+    }
+    // Doubles have to be exactly the same when read as text and in binary protocol. Server sends FLOAT as text with 6 digits only
+    res.reset(st->executeQuery("SELECT d, f FROM test_double_round_trip ORDER BY id"));
+    pstmt.reset(con2->prepareStatement("SELECT d, f FROM test_double_round_trip ORDER BY id"));
+    ResultSet res2(pstmt->executeQuery());
+    for (int32_t i= 0; i < static_cast<int32_t>(sizeof(values)/sizeof(values[0])); ++i) {
+      const float expectedFloat= floatValues[i % (sizeof(floatValues)/sizeof(floatValues[0]))];
+      ASSERT(res->next());
+      ASSERT(res2->next());
+      ASSERT(values[i] == static_cast<double>(res->getDouble(1)));
+      ASSERT(values[i] == static_cast<double>(res2->getDouble(1)));
+      ASSERT(expectedFloat == res2->getFloat(2));
+    }
+  }
+}
+
+void preparedstatement::decimalType()
+{
+  const std::string maxValue(std::string(35, '9') + "." + std::string(30, '9'));
+  const char* values[]= { "0.000000000000000000000000000000", "0.000000000000000000000000000001", "-12345.678900000000000000000000000000",
+    "1.100000000000000000000000000000", maxValue.c_str() };
+
+  // Arithmetic, rounding and the range check
+  ASSERT_EQUALS("0.3", (sql::Decimal(sql::SQLString("0.1")) + sql::Decimal(sql::SQLString("0.2"))).toString());
+  ASSERT_EQUALS("-5.250", (sql::Decimal(sql::SQLString("1.25")) * sql::Decimal(sql::SQLString("-4.2"))).toString());
+  ASSERT_EQUALS("10.00", sql::Decimal(sql::SQLString("9.995")).setScale(2).toString());
+  ASSERT(sql::Decimal(sql::SQLString("1.5")) == sql::Decimal(sql::SQLString("1.500")));
+  sql::Decimal max(maxValue.c_str(), maxValue.length());
+  ASSERT_EQUALS(65, max.getPrecision());
+  try {
+    max+= sql::Decimal(sql::SQLString(values[1]));
+    FAIL("Decimal overflow has not been detected");
+  }
+  catch (sql::SQLException& e) {
+    ASSERT_EQUALS("22003", e.getSQLState());
+  }
+
+  createSchemaObject("TABLE", "test_decimal_type", "(id INT NOT NULL PRIMARY KEY, d DECIMAL(65,30), i BIGINT UNSIGNED)");
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs) {
+    Connection con2;
+    sql::Properties props(commonProperties);
+    props["useServerPrepStmts"]= serverPs ? "true" : "false";
+    con2.reset(getConnection(&props));
+
+    std::unique_ptr<sql::Statement> st(con2->createStatement());
+    st->execute("DELETE FROM test_decimal_type");
+    pstmt.reset(con2->prepareStatement("INSERT INTO test_decimal_type(id, d, i) VALUES (?, ?, ?)"));
+    for (int32_t i= 0; i < static_cast<int32_t>(sizeof(values)/sizeof(values[0])); ++i) {
+      pstmt->setInt(1, i);
+      sql::mariadb::set_decimal(pstmt.get(), 2, sql::Decimal(sql::SQLString(values[i])));
+      pstmt->setUInt64(3, 18446744073709551615ULL);
+      ASSERT_EQUALS(1, pstmt->executeUpdate());
+    }
+    pstmt->setInt(1, 100);
+    pstmt->setNull(2, sql::DataType::DECIMAL);
+    pstmt->setNull(3, sql::DataType::BIGINT);
+    ASSERT_EQUALS(1, pstmt->executeUpdate());
+
+    res.reset(st->executeQuery("SELECT d, i FROM test_decimal_type ORDER BY id"));
+    pstmt.reset(con2->prepareStatement("SELECT d, i FROM test_decimal_type ORDER BY id"));
+    ResultSet res2(pstmt->executeQuery());
+    for (int32_t i= 0; i < static_cast<int32_t>(sizeof(values)/sizeof(values[0])); ++i) {
+      ASSERT(res->next());
+      ASSERT(res2->next());
+      // Text and binary protocol values have the scale of the column
+      ASSERT_EQUALS(values[i], sql::mariadb::get_decimal(res.get(), 1).toString());
+      ASSERT_EQUALS(values[i], sql::mariadb::get_decimal(res2.get(), "d").toString());
+      ASSERT_EQUALS(30, sql::mariadb::get_decimal(res2.get(), 1).getScale());
+      ASSERT_EQUALS("18446744073709551615", sql::mariadb::get_decimal(res.get(), 2).toString());
+      ASSERT_EQUALS("18446744073709551615", sql::mariadb::get_decimal(res2.get(), 2).toString());
+    }
+    ASSERT(res->next());
+    ASSERT(res2->next());
+    ASSERT(sql::mariadb::get_decimal(res.get(), 1).isZero());
+    ASSERT(res->wasNull());
+    ASSERT(sql::mariadb::get_decimal(res2.get(), 1).isZero());
+    ASSERT(res2->wasNull());
+  }
+}
+
+void preparedstatement::blobStreamRead()
+{
+  // Value is considerably larger than the chunk, and not multiple of it
+  std::string value(3*65536 + 1234, '\0');
+  for (std::size_t i= 0; i < value.length(); ++i) {
+    value[i]= static_cast<char>(i*31 % 251);
+  }
+
+  createSchemaObject("TABLE", "test_blob_stream", "(id INT NOT NULL PRIMARY KEY, b LONGBLOB)");
+
+  sql::Properties props(commonProperties);
+  props["useServerPrepStmts"]= "true";
+  props["longDataChunkSize"]= "65536";
+  Connection con2(getConnection(&props));
+
+  pstmt.reset(con2->prepareStatement("INSERT INTO test_blob_stream VALUES(?, ?)"));
+  std::istringstream valueStream(value);
+  pstmt->setInt(1, 1);
+  pstmt->setBlob(2, &valueStream);
+  ASSERT_EQUALS(1, pstmt->executeUpdate());
+  pstmt->setInt(1, 2);
+  pstmt->setNull(2, sql::DataType::LONGVARBINARY);
+  ASSERT_EQUALS(1, pstmt->executeUpdate());
+
+  pstmt.reset(con2->prepareStatement("SELECT b FROM test_blob_stream ORDER BY id"));
+  res.reset(pstmt->executeQuery());
+  ASSERT(res->next());
+
+  std::unique_ptr<std::istream> blob(res->getBlob(1));
+  ASSERT(blob.get() != nullptr);
+  std::string read;
+  char small[1000];
+
+  // Reads smaller and larger than the chunk
+  blob->read(small, sizeof(small));
+  read.append(small, static_cast<std::size_t>(blob->gcount()));
+  std::vector<char> big(100000);
+  blob->read(big.data(), big.size());
+  read.append(big.data(), static_cast<std::size_t>(blob->gcount()));
+  while (blob->read(small, sizeof(small)) || blob->gcount() > 0) {
+    read.append(small, static_cast<std::size_t>(blob->gcount()));
+  }
+  ASSERT(read == value);
+
+  blob->clear();
+  blob->seekg(70000);
+  blob->read(small, 10);
+  ASSERT(std::string(small, 10) == value.substr(70000, 10));
+
+  // The value is also available with other getters, and through another stream
+  ASSERT(res->getString(1) == value);
+  blob.reset(res->getBinaryStream(1));
+  read.assign(std::istreambuf_iterator<char>(*blob), std::istreambuf_iterator<char>());
+  ASSERT(read == value);
+
+  ASSERT(res->next());
+  blob.reset(res->getBlob(1));
+  ASSERT(!blob);
+  ASSERT(res->wasNull());
+}
+
 } /* namespace preparedstatement */
 } /* namespace testsuite */
@@ -82,6 +82,15 @@ public:
     TEST_CASE(bytesArrParam);
     TEST_CASE(concpp138_useRsAfterConClose);
     TEST_CASE(concpp153_mbCsParamEscaping);
+    TEST_CASE(bufferedLongValues);
+    TEST_CASE(cursorFetchSize);
+    TEST_CASE(clientPrepareCache);
+    TEST_CASE(escapeLongString);
+    TEST_CASE(streamLongData);
+    TEST_CASE(metadataReuse);
+    TEST_CASE(doubleRoundTrip);
+    TEST_CASE(decimalType);
+    TEST_CASE(blobStreamRead);
   }
 
   /**
@@ -182,6 +191,34 @@ public:
 
   void concpp153_mbCsParamEscaping();
 
+  /* Values in buffered binary resultset longer than bound buffers */
+  void bufferedLongValues();
+
+  /* Server-side prepared statement with fetch size reads rows through the cursor, and can be re-executed while
+     the previous result is still read */
+  void cursorFetchSize();
+
+  /* Client-side prepared statements sharing parsed queries */
+  void clientPrepareCache();
+
+  /* Long string and binary parameters with characters to escape, with and without NO_BACKSLASH_ESCAPES */
+  void escapeLongString();
+
+  /* Multi-megabyte stream parameter sent with client and server side prepared statements */
+  void streamLongData();
+
+  /* Server-side prepared statement re-executions re-using and refreshing column definitions */
+  void metadataReuse();
+
+  /* DOUBLE and FLOAT parameters and values restored exactly in text and binary protocol */
+  void doubleRoundTrip();
+
+  /* Decimal values in the full DECIMAL(65,30) range set and read in text and binary protocol */
+  void decimalType();
+
+  /* Reading of a large binary protocol value through the stream in parts, and seeking in it */
+  void blobStreamRead();
+
   /* unit_fixture methods overriding */
   void setUp();
 };
@@ -1341,5 +1341,279 @@ void resultset::JSON_support()
 }
 
 
+void resultset::numericGetters()
+{
+  logMsg("resultset::numericGetters - MySQL_ResultSet::getInt*, getDouble, getFloat");
+
+  try
+  {
+    stmt.reset(con->createStatement());
+    stmt->execute("DROP TABLE IF EXISTS test");
+    stmt->execute("CREATE TABLE test(ti TINYINT, usi SMALLINT UNSIGNED, i INT, ubi BIGINT UNSIGNED, bi BIGINT, f FLOAT, d DOUBLE)");
+    stmt->execute("INSERT INTO test VALUES(-128, 65535, -2147483648, 18446744073709551615, -9223372036854775808, 0.5, -2.25),"
+      "(7, 8, 9, 10, 11, 12, 13), (NULL, NULL, NULL, NULL, NULL, NULL, NULL)");
+
+    pstmt.reset(con->prepareStatement("SELECT * FROM test ORDER BY i"));
+
+    for (int32_t binary= 0; binary < 2; ++binary)
+    {
+      res.reset(binary ? pstmt->executeQuery() : stmt->executeQuery("SELECT * FROM test ORDER BY i"));
+
+      logMsg(binary ? "... binary protocol" : "... text protocol");
+      ASSERT(res->next());
+      ASSERT_EQUALS(0, res->getInt(1));
+      ASSERT(res->wasNull());
+      ASSERT_EQUALS(static_cast<int64_t>(0), res->getInt64(4));
+      ASSERT_EQUALS(0.0, res->getDouble(7));
+
+      ASSERT(res->next());
+      ASSERT_EQUALS(-128, res->getInt(1));
+      ASSERT_EQUALS(static_cast<int64_t>(-128), res->getInt64("ti"));
+      ASSERT_EQUALS(-128.0, res->getDouble(1));
+      ASSERT_EQUALS(65535, res->getInt(2));
+      ASSERT_EQUALS(static_cast<uint64_t>(65535), res->getUInt64(2));
+      ASSERT_EQUALS(static_cast<int32_t>(INT32_MIN), res->getInt(3));
+      ASSERT_EQUALS(UINT64_MAX, res->getUInt64(4));
+      ASSERT_EQUALS(static_cast<int64_t>(INT64_MIN), res->getInt64(5));
+      ASSERT_EQUALS(0.5f, res->getFloat(6));
+      ASSERT_EQUALS(0.5, res->getDouble(6));
+      ASSERT_EQUALS(-2.25f, res->getFloat(7));
+      ASSERT_EQUALS(-2.25, res->getDouble(7));
+
+      try
+      {
+        res->getInt(4);
+        FAIL("Out of range value not detected");
+      }
+      catch (sql::SQLException& e)
+      {
+        ASSERT_EQUALS("22003", e.getSQLState());
+      }
+
+      try
+      {
+        res->getInt64(4);
+        FAIL("Out of range value not detected");
+      }
+      catch (sql::SQLException& e)
+      {
+        ASSERT_EQUALS("22003", e.getSQLState());
+      }
+
+      try
+      {
+        res->getUInt64(5);
+        FAIL("Out of range value not detected");
+      }
+      catch (sql::SQLException& e)
+      {
+        ASSERT_EQUALS("22003", e.getSQLState());
+      }
+
+      ASSERT(res->next());
+      for (int32_t col= 1; col <= 7; ++col)
+      {
+        ASSERT_EQUALS(col + 6, res->getInt(col));
+        ASSERT_EQUALS(static_cast<int64_t>(col + 6), res->getInt64(col));
+        ASSERT_EQUALS(static_cast<uint64_t>(col + 6), res->getUInt64(col));
+        ASSERT_EQUALS(static_cast<double>(col + 6), res->getDouble(col));
+        ASSERT_EQUALS(static_cast<float>(col + 6), res->getFloat(col));
+      }
+      ASSERT(!res->next());
+    }
+
+    stmt->execute("DROP TABLE IF EXISTS test");
+  }
+  catch (sql::SQLException &e)
+  {
+    logErr(e.what());
+    logErr("SQLState: " + std::string(e.getSQLState()));
+    fail(e.what(), __FILE__, __LINE__);
+  }
+}
+
+
+void resultset::memoryLimit()
+{
+  logMsg("resultset::memoryLimit - rows over resultSetMemoryLimit are spilled to the temporary file");
+
+  const int32_t rowCount= 300;
+  createSchemaObject("TABLE", "test_memory_limit", "(id INT NOT NULL PRIMARY KEY, val VARCHAR(300), n INT)");
+
+  pstmt.reset(con->prepareStatement("INSERT INTO test_memory_limit VALUES(?, ?, ?)"));
+  for (int32_t i= 1; i <= rowCount; ++i) {
+    pstmt->setInt(1, i);
+    pstmt->setString(2, std::string(i, 'a' + i % 26));
+    if (i % 3 == 0) {
+      pstmt->setNull(3, sql::DataType::INTEGER);
+    }
+    else {
+      pstmt->setInt(3, -i);
+    }
+    pstmt->executeUpdate();
+  }
+
+  sql::Properties props(commonProperties);
+  props["resultSetMemoryLimit"]= "4096";
+  props["defaultStatementResultType"]= std::to_string(sql::ResultSet::TYPE_SCROLL_INSENSITIVE);
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs)
+  {
+    props["useServerPrepStmts"]= serverPs ? "true" : "false";
+    Connection con2(getConnection(&props));
+
+    // Only server side prepared statements can stream the result
+    for (int32_t fetchSize : {0, 7})
+    {
+      if (fetchSize > 0 && !serverPs) {
+        continue;
+      }
+      pstmt.reset(con2->prepareStatement("SELECT id, val, n FROM test_memory_limit ORDER BY id"));
+      pstmt->setFetchSize(fetchSize);
+      res.reset(pstmt->executeQuery());
+
+      int32_t id= 0;
+      while (res->next()) {
+        ++id;
+        ASSERT_EQUALS(id, res->getInt(1));
+        ASSERT_EQUALS(std::string(id, 'a' + id % 26), res->getString(2));
+        ASSERT_EQUALS(id % 3 == 0 ? 0 : -id, res->getInt(3));
+        ASSERT_EQUALS(id % 3 == 0, res->wasNull());
+      }
+      ASSERT_EQUALS(rowCount, id);
+
+      ASSERT(res->last());
+      ASSERT_EQUALS(rowCount, res->getInt(1));
+      ASSERT(res->absolute(150));
+      ASSERT_EQUALS(150, res->getInt(1));
+      ASSERT_EQUALS(std::string(150, 'a' + 150 % 26), res->getString(2));
+      ASSERT(res->previous());
+      ASSERT_EQUALS(149, res->getInt(1));
+      ASSERT(res->relative(-140));
+      ASSERT_EQUALS(9, res->getInt(1));
+      ASSERT(res->relative(250));
+      ASSERT_EQUALS(259, res->getInt(1));
+      ASSERT(res->first());
+      ASSERT_EQUALS(1, res->getInt(1));
+      res->afterLast();
+      ASSERT(res->previous());
+      ASSERT_EQUALS(rowCount, res->getInt(1));
+      ASSERT(!res->absolute(rowCount + 1));
+
+      // The connection is usable while the resultset is open
+      std::unique_ptr<sql::Statement> st(con2->createStatement());
+      ResultSet count(st->executeQuery("SELECT COUNT(*) FROM test_memory_limit"));
+      ASSERT(count->next());
+      ASSERT_EQUALS(rowCount, count->getInt(1));
+      ASSERT(res->absolute(77));
+      ASSERT_EQUALS(std::string(77, 'a' + 77 % 26), res->getString(2));
+    }
+  }
+}
+
+
+void resultset::memoryLimitBuffered()
+{
+  logMsg("resultset::memoryLimitBuffered - fully buffered resultset over resultSetMemoryLimit");
+
+  const int32_t rowCount= 200;
+  createSchemaObject("TABLE", "test_memory_limit_buf", "(id INT NOT NULL PRIMARY KEY, val VARCHAR(500))");
+  pstmt.reset(con->prepareStatement("INSERT INTO test_memory_limit_buf VALUES(?, ?)"));
+  for (int32_t i= 1; i <= rowCount; ++i) {
+    pstmt->setInt(1, i);
+    pstmt->setString(2, std::string(100 + i, static_cast<char>('a' + i % 26)));
+    pstmt->executeUpdate();
+  }
+
+  sql::Properties props(commonProperties);
+  // The result is about 60k, most of the rows go to the temporary file
+  props["resultSetMemoryLimit"]= "1024";
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs)
+  {
+    props["useServerPrepStmts"]= serverPs ? "true" : "false";
+    Connection con2(getConnection(&props));
+    Statement st(con2->createStatement()), st2(con2->createStatement());
+
+    for (int32_t prepared= 0; prepared < 2; ++prepared)
+    {
+      const sql::SQLString query("SELECT id, val FROM test_memory_limit_buf ORDER BY id");
+      if (prepared) {
+        pstmt.reset(con2->prepareStatement(query));
+        res.reset(pstmt->executeQuery());
+      }
+      else {
+        res.reset(st->executeQuery(query));
+      }
+      // All rows have been read, and the connection can run other queries
+      ResultSet count(st2->executeQuery("SELECT COUNT(*) FROM test_memory_limit_buf"));
+      ASSERT(count->next());
+      ASSERT_EQUALS(rowCount, count->getInt(1));
+
+      int32_t id= 0;
+      while (res->next()) {
+        ++id;
+        ASSERT_EQUALS(id, res->getInt(1));
+        ASSERT_EQUALS(std::string(100 + id, static_cast<char>('a' + id % 26)), res->getString(2));
+      }
+      ASSERT_EQUALS(rowCount, id);
+    }
+  }
+}
+
+void resultset::exportRows()
+{
+  logMsg("resultset::exportRows - export of rows in CSV and TSV formats");
+
+  createSchemaObject("TABLE", "test_export", "(id INT NOT NULL PRIMARY KEY, val VARCHAR(32), bin VARBINARY(8), d DOUBLE)");
+  stmt->executeUpdate("INSERT INTO test_export VALUES(1, 'plain', 0x41, 1.5), (2, 'a,b \"c\"', NULL, -2),"
+    "(3, 'line\\nbreak\\ttab', 0x00FF, NULL), (4, '', '', 0)");
+
+  const std::string csv(std::string("id,val,bin,d\r\n"
+                                    "1,plain,A,1.5\r\n"
+                                    "2,\"a,b \"\"c\"\"\",,-2\r\n"
+                                    "3,\"line\nbreak\ttab\",") + std::string("\0\xFF", 2) + ",\r\n"
+                                    "4,\"\",\"\",0\r\n");
+  const std::string tsv("1\tplain\t41\t1.5\n"
+                        "2\ta,b \"c\"\t\\N\t-2\n"
+                        "3\tline\\nbreak\\ttab\t00FF\t\\N\n"
+                        "4\t\t\t0\n");
+  sql::Properties props(commonProperties);
+
+  for (int32_t serverPs= 0; serverPs < 2; ++serverPs)
+  {
+    props["useServerPrepStmts"]= serverPs ? "true" : "false";
+    Connection con2(getConnection(&props));
+
+    pstmt.reset(con2->prepareStatement("SELECT id, val, bin, d FROM test_export ORDER BY id"));
+    res.reset(pstmt->executeQuery());
+
+    sql::ExportOptions csvOptions;
+    csvOptions.header= true;
+    std::ostringstream out;
+    ASSERT_EQUALS(static_cast<int64_t>(4), sql::mariadb::export_result_set(res.get(), out, csvOptions));
+    ASSERT_EQUALS(csv, out.str());
+    ASSERT(res->isAfterLast());
+
+    res.reset(pstmt->executeQuery());
+    sql::ExportOptions tsvOptions(sql::ExportOptions::tsv());
+    tsvOptions.binaryAsHex= true;
+    // Small buffer to make the writer to be called many times
+    tsvOptions.bufferSize= 5;
+    std::string exported;
+    ASSERT_EQUALS(static_cast<int64_t>(4), sql::mariadb::export_result_set(res.get(),
+      [](const char* data, std::size_t length, void* context) { static_cast<std::string*>(context)->append(data, length); },
+      &exported, tsvOptions));
+    ASSERT_EQUALS(tsv, exported);
+
+    // Export starts after the current row
+    res.reset(pstmt->executeQuery());
+    ASSERT(res->absolute(3));
+    out.str("");
+    ASSERT_EQUALS(static_cast<int64_t>(1), sql::mariadb::export_result_set(res.get(), out));
+    ASSERT_EQUALS(std::string("4,\"\",\"\",0\r\n"), out.str());
+  }
+}
+
 } /* namespace resultset */
 } /* namespace testsuite */
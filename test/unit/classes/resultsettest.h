@@ -63,6 +63,10 @@ public:
     TEST_CASE(getResultSetType);
     TEST_CASE(getTypesMinorIssues);
     TEST_CASE(JSON_support);
+    TEST_CASE(numericGetters);
+    TEST_CASE(memoryLimit);
+    TEST_CASE(memoryLimitBuffered);
+    TEST_CASE(exportRows);
 
 #ifdef INCLUDE_NOT_IMPLEMENTED_METHODS
     TEST_CASE(notImplemented);
@@ -123,6 +127,32 @@ public:
    */
   void JSON_support();
 
+  /**
+   * Test of integer and floating point getters on numeric columns
+   *
+   * Same values are fetched with text and binary protocol, including range errors
+   */
+  void numericGetters();
+
+  /**
+   * Test of resultSetMemoryLimit
+   *
+   * Scrolling over rows, that did not fit the limit, with text and binary protocol, buffered and streamed
+   */
+  void memoryLimit();
+
+  /**
+   * Test of resultSetMemoryLimit with fully buffered results of statement and prepared statements
+   */
+  void memoryLimitBuffered();
+
+  /**
+   * Test of export_result_set
+   *
+   * CSV with quoting of special characters and header, and TSV with escaping and binary as hex, with both protocols
+   */
+  void exportRows();
+
 
 };
 
@@ -626,6 +626,35 @@ void statement::queryTimeout()
 }
 
 
+void statement::batchQueryTimeout()
+{
+  logMsg("statement::batchQueryTimeout() - timeout of the batch is controlled by the client");
+
+  stmt.reset(con->createStatement());
+  stmt->setQueryTimeout(1);
+  for (int i= 0; i < 4; ++i) {
+    stmt->addBatch("DO SLEEP(2)");
+  }
+  time_t t1= time(nullptr);
+  try
+  {
+    stmt->executeBatch();
+    FAIL("Batch should have timed out");
+  }
+  catch (sql::SQLException &)
+  {
+  }
+  time_t t2= time(nullptr);
+  ASSERT((t2 - t1) < 8);
+
+  // Statement has to be usable after the timeout
+  stmt->setQueryTimeout(0);
+  res.reset(stmt->executeQuery("SELECT 1"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(1, res->getInt(1));
+}
+
+
 void statement::addBatch()
 {
   // Have to test results in separate conenction as connector may turn auto commit off
@@ -730,6 +759,66 @@ void statement::concpp99_batchRewrite()
   ASSERT_EQUALS(1LL, batchLRes[2]);
 }
 
+
+/** Test of batchChunkSize option - batch is rewritten or aggregated into several queries, that do not exceed it
+ */
+void statement::batchChunkSize()
+{
+  sql::ConnectOptionsMap connection_properties{{"userName", user}, {"password", passwd}, {"rewriteBatchedStatements", "true"},
+    {"batchChunkSize", "256"}, {"useTls", useTls ? "true" : "false"}};
+  const int32_t rowCount= 100;
+
+  Connection con2(driver->connect(url, connection_properties));
+  Statement st2(con2->createStatement());
+
+  createSchemaObject("TABLE", "test_batch_chunks", "(id int not NULL PRIMARY KEY, val VARCHAR(31) NOT NULL DEFAULT '')");
+
+  // Aggregated into multi-statement queries, about 5 statements each
+  for (int32_t i= 1; i <= rowCount; ++i) {
+    st2->addBatch("INSERT INTO test_batch_chunks VALUES(" + std::to_string(i) + ",'value " + std::to_string(i) + "')");
+  }
+  const sql::Ints& batchRes= st2->executeBatch();
+
+  ASSERT_EQUALS(static_cast<uint64_t>(rowCount), static_cast<uint64_t>(batchRes.size()));
+  for (auto updateCount : batchRes) {
+    ASSERT_EQUALS(1, updateCount);
+  }
+  res.reset(stmt->executeQuery("SELECT COUNT(*), SUM(id), SUM(val = CONCAT('value ', id)) FROM test_batch_chunks"));
+  ASSERT(res->next());
+  ASSERT_EQUALS(rowCount, res->getInt(1));
+  ASSERT_EQUALS(rowCount*(rowCount + 1)/2, res->getInt(2));
+  ASSERT_EQUALS(rowCount, res->getInt(3));
+  stmt->executeUpdate("DELETE FROM test_batch_chunks");
+
+  // Rewritten into several multi-values INSERTs, and not rewritable query aggregated as above
+  const sql::SQLString insertQuery[]{"INSERT INTO test_batch_chunks VALUES(?,?)",
+                                     "INSERT INTO test_batch_chunks(id) VALUES(?) ON DUPLICATE KEY UPDATE val=?"};
+  // Second query inserts new rows with default val
+  const int32_t batchResult[]{sql::Statement::SUCCESS_NO_INFO, 1}, valuesSet[]{rowCount, 0};
+
+  for (std::size_t q= 0; q < sizeof(insertQuery)/sizeof(insertQuery[0]); ++q) {
+    PreparedStatement ps(con2->prepareStatement(insertQuery[q]));
+
+    for (int32_t i= 1; i <= rowCount; ++i) {
+      ps->setInt(1, i);
+      ps->setString(2, "value " + std::to_string(i));
+      ps->addBatch();
+    }
+    const sql::Ints& psBatchRes= ps->executeBatch();
+
+    ASSERT_EQUALS(static_cast<uint64_t>(rowCount), static_cast<uint64_t>(psBatchRes.size()));
+    for (auto updateCount : psBatchRes) {
+      ASSERT_EQUALS(batchResult[q], updateCount);
+    }
+    res.reset(stmt->executeQuery("SELECT COUNT(*), SUM(id), SUM(val = CONCAT('value ', id)) FROM test_batch_chunks"));
+    ASSERT(res->next());
+    ASSERT_EQUALS(rowCount, res->getInt(1));
+    ASSERT_EQUALS(rowCount*(rowCount + 1)/2, res->getInt(2));
+    ASSERT_EQUALS(valuesSet[q], res->getInt(3));
+    stmt->executeUpdate("DELETE FROM test_batch_chunks");
+  }
+}
+
 /* This is tmporary test for 1.0 version only. Thus putting all statement types in here - easier to remove */
 void statement::concpp107_setFetchSizeExeption()
 {
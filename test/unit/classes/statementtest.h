@@ -65,8 +65,10 @@ public:
     TEST_CASE(unbufferedFetch);
     TEST_CASE(unbufferedOutOfSync);
     TEST_CASE(queryTimeout);
+    TEST_CASE(batchQueryTimeout);
     TEST_CASE(addBatch);
     TEST_CASE(concpp99_batchRewrite);
+    TEST_CASE(batchChunkSize);
     TEST_CASE(concpp107_setFetchSizeExeption);
     TEST_CASE(otherstmts_result);
     TEST_CASE(multirs_caching);
@@ -112,6 +114,11 @@ public:
    */
   void queryTimeout();
 
+  /**
+   * Client-side timeout of the batch execution
+   */
+  void batchQueryTimeout();
+
   /**
    * checks addBatch
    */
@@ -120,6 +127,9 @@ public:
   /* addBatch with rewrite option */
   void concpp99_batchRewrite();
 
+  /* Batch split into several queries by batchChunkSize */
+  void batchChunkSize();
+
   /* Making sure that setFetchSize is doing no bad things while rs streaming is not supported */
   void concpp107_setFetchSizeExeption();
 